@@ -39,6 +39,9 @@ endif()
 set(VKB_SAMPLE_ENTRYPOINT OFF CACHE BOOL "Enable create entrypoint project for every sample.")
 set(VKB_ASSETS_SYMLINK OFF CACHE BOOL "Enable create symlink assets folder for every sample.")
 set(VKB_VALIDATION_LAYERS OFF CACHE BOOL "Enable validation layers for every sample.")
+set(VKB_PRECOMPILED_SHADERS OFF CACHE BOOL "Enable compile shaders at build time instead of at runtime.")
+set(VKB_COUNT_ALLOCATIONS OFF CACHE BOOL "Enable counting the allocations made with operator new, to check that drawing does not allocate.")
+set(VKB_SHADER_PRECOMPILER "" CACHE FILEPATH "Host shader_precompiler executable, used when cross compiling with precompiled shaders.")
 
 set(CMAKE_RUNTIME_OUTPUT_DIRECTORY "bin/${CMAKE_BUILD_TYPE}/${TARGET_ARCH}")
 set(CMAKE_LIBRARY_OUTPUT_DIRECTORY "lib/${CMAKE_BUILD_TYPE}/${TARGET_ARCH}")
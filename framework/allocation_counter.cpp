@@ -0,0 +1,124 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace vkb
+{
+#ifdef VKB_COUNT_ALLOCATIONS
+namespace
+{
+// Counted per thread, so that the workers do not disturb the thread being checked
+thread_local uint64_t allocation_count{0};
+
+void *allocate(std::size_t size)
+{
+	++allocation_count;
+
+	// Allocations of zero bytes must still return a unique pointer
+	if (void *memory = std::malloc(size ? size : 1))
+	{
+		return memory;
+	}
+
+	throw std::bad_alloc{};
+}
+}        // namespace
+
+uint64_t get_allocation_count()
+{
+	return allocation_count;
+}
+#else
+uint64_t get_allocation_count()
+{
+	return 0;
+}
+#endif
+}        // namespace vkb
+
+#ifdef VKB_COUNT_ALLOCATIONS
+void *operator new(std::size_t size)
+{
+	return vkb::allocate(size);
+}
+
+void *operator new[](std::size_t size)
+{
+	return vkb::allocate(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+	try
+	{
+		return vkb::allocate(size);
+	}
+	catch (const std::bad_alloc &)
+	{
+		return nullptr;
+	}
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+	try
+	{
+		return vkb::allocate(size);
+	}
+	catch (const std::bad_alloc &)
+	{
+		return nullptr;
+	}
+}
+
+void operator delete(void *memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void *memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void *memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void *memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void *memory, const std::nothrow_t &) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void *memory, const std::nothrow_t &) noexcept
+{
+	std::free(memory);
+}
+#endif
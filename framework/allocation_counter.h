@@ -0,0 +1,40 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace vkb
+{
+/**
+ * @brief Returns the number of allocations made with operator new by the calling thread.
+ *        Allocations are only counted when the framework is built with VKB_COUNT_ALLOCATIONS,
+ *        which replaces the global operator new, so that code expected not to allocate,
+ *        such as recording the draws of a frame whose resources are cached, can be checked:
+ *
+ *        uint64_t allocation_count = get_allocation_count();
+ *        draw_scene_meshes(command_buffer, pipeline_layout, scene);
+ *        assert(get_allocation_count() == allocation_count);
+ *
+ * @return The number of allocations, or 0 if they are not counted
+ */
+uint64_t get_allocation_count();
+}        // namespace vkb
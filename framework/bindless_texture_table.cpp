@@ -0,0 +1,196 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "bindless_texture_table.h"
+
+#include "core/descriptor_set_layout.h"
+#include "core/device.h"
+#include "core/image_view.h"
+#include "scene_graph/components/image.h"
+#include "scene_graph/components/sampler.h"
+#include "scene_graph/components/texture.h"
+#include "scene_graph/scene.h"
+
+namespace vkb
+{
+BindlessTextureTable::BindlessTextureTable(Device &device, DescriptorSetLayout &descriptor_set_layout) :
+    device{device}
+{
+	if (!descriptor_set_layout.has_variable_descriptor_count())
+	{
+		throw std::runtime_error("Bindless texture table layout has no runtime sized array");
+	}
+
+	auto &bindings = descriptor_set_layout.get_bindings();
+
+	binding         = bindings.back().binding;
+	descriptor_type = bindings.back().descriptorType;
+	capacity        = bindings.back().descriptorCount;
+
+	std::map<VkDescriptorType, uint32_t> descriptor_type_counts;
+
+	for (auto &layout_binding : bindings)
+	{
+		descriptor_type_counts[layout_binding.descriptorType] += layout_binding.descriptorCount;
+	}
+
+	std::vector<VkDescriptorPoolSize> pool_sizes;
+
+	for (auto &it : descriptor_type_counts)
+	{
+		pool_sizes.push_back({it.first, it.second});
+	}
+
+	VkDescriptorPoolCreateInfo pool_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+
+	pool_info.flags         = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+	pool_info.poolSizeCount = to_u32(pool_sizes.size());
+	pool_info.pPoolSizes    = pool_sizes.data();
+	pool_info.maxSets       = 1;
+
+	VkResult result = vkCreateDescriptorPool(device.get_handle(), &pool_info, nullptr, &pool);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot create bindless texture descriptor pool"};
+	}
+
+	// The array is allocated at full capacity, only the elements written being bound
+	VkDescriptorSetVariableDescriptorCountAllocateInfoEXT variable_count_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_VARIABLE_DESCRIPTOR_COUNT_ALLOCATE_INFO_EXT};
+
+	variable_count_info.descriptorSetCount = 1;
+	variable_count_info.pDescriptorCounts  = &capacity;
+
+	VkDescriptorSetLayout set_layout = descriptor_set_layout.get_handle();
+
+	VkDescriptorSetAllocateInfo allocate_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+
+	allocate_info.pNext              = &variable_count_info;
+	allocate_info.descriptorPool     = pool;
+	allocate_info.descriptorSetCount = 1;
+	allocate_info.pSetLayouts        = &set_layout;
+
+	VkDescriptorSet handle = VK_NULL_HANDLE;
+
+	result = vkAllocateDescriptorSets(device.get_handle(), &allocate_info, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		vkDestroyDescriptorPool(device.get_handle(), pool, nullptr);
+
+		throw VulkanException{result, "Cannot allocate bindless texture descriptor set"};
+	}
+
+	descriptor_set = std::make_unique<DescriptorSet>(device, descriptor_set_layout, handle);
+}
+
+BindlessTextureTable::~BindlessTextureTable()
+{
+	descriptor_set.reset();
+
+	// Destroying the pool frees the set
+	if (pool != VK_NULL_HANDLE)
+	{
+		vkDestroyDescriptorPool(device.get_handle(), pool, nullptr);
+	}
+}
+
+uint32_t BindlessTextureTable::add_texture(const ImageView &image_view, VkSampler sampler)
+{
+	auto key = std::make_pair(image_view.get_handle(), sampler);
+
+	auto it = texture_indices.find(key);
+
+	if (it != texture_indices.end())
+	{
+		return it->second;
+	}
+
+	uint32_t index = to_u32(texture_indices.size());
+
+	if (index == capacity)
+	{
+		throw std::runtime_error("Bindless texture table is full");
+	}
+
+	VkDescriptorImageInfo image_info{};
+
+	image_info.sampler     = descriptor_type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ? sampler : VK_NULL_HANDLE;
+	image_info.imageView   = image_view.get_handle();
+	image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	descriptor_set->update({}, {{binding, {{index, image_info}}}});
+
+	texture_indices.emplace(key, index);
+
+	return index;
+}
+
+void BindlessTextureTable::add_scene_textures(const sg::Scene &scene)
+{
+	if (!scene.has_component<sg::Texture>())
+	{
+		return;
+	}
+
+	for (auto &texture : scene.get_components<sg::Texture>())
+	{
+		auto image   = texture->get_image();
+		auto sampler = texture->get_sampler();
+
+		if (!image || !image->image_view || !sampler)
+		{
+			continue;
+		}
+
+		scene_texture_indices[texture.get()] = add_texture(*image->image_view, sampler->vk_sampler);
+	}
+
+	LOGI("Bindless texture table holds %u textures", get_texture_count());
+}
+
+bool BindlessTextureTable::get_texture_index(const sg::Texture &texture, uint32_t &index) const
+{
+	auto it = scene_texture_indices.find(&texture);
+
+	if (it == scene_texture_indices.end())
+	{
+		return false;
+	}
+
+	index = it->second;
+
+	return true;
+}
+
+const DescriptorSet &BindlessTextureTable::get_descriptor_set() const
+{
+	return *descriptor_set;
+}
+
+uint32_t BindlessTextureTable::get_texture_count() const
+{
+	return to_u32(texture_indices.size());
+}
+
+uint32_t BindlessTextureTable::get_capacity() const
+{
+	return capacity;
+}
+}        // namespace vkb
@@ -0,0 +1,100 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "common.h"
+
+#include "core/descriptor_set.h"
+
+namespace vkb
+{
+class DescriptorSetLayout;
+class Device;
+class ImageView;
+
+namespace sg
+{
+class Scene;
+class Texture;
+}        // namespace sg
+
+/**
+ * @brief Texture array written once and bound once per frame, from which shaders select their
+ *        textures with an index, for example given in push constants. Draws then no longer
+ *        bind textures, so that switching materials does not allocate and bind a descriptor set.
+ *        The array is the runtime sized array of a set layout, which needs descriptor indexing.
+ *        Textures can be added while the set is bound, but not while the GPU reads it.
+ */
+class BindlessTextureTable : public NonCopyable
+{
+  public:
+	/**
+	 * @param descriptor_set_layout Layout of the set, whose last binding is a runtime sized texture array
+	 */
+	BindlessTextureTable(Device &device, DescriptorSetLayout &descriptor_set_layout);
+
+	~BindlessTextureTable();
+
+	/**
+	 * @brief Writes a texture in the array, if it is not in it already
+	 * @return The index of the texture in the array
+	 */
+	uint32_t add_texture(const ImageView &image_view, VkSampler sampler);
+
+	/**
+	 * @brief Writes all the textures of a scene in the array
+	 */
+	void add_scene_textures(const sg::Scene &scene);
+
+	/**
+	 * @brief Finds the index of a texture added with the textures of its scene
+	 * @return True if the texture is in the array
+	 */
+	bool get_texture_index(const sg::Texture &texture, uint32_t &index) const;
+
+	/**
+	 * @return The set to bind, which is compatible with the layout the table was created with
+	 */
+	const DescriptorSet &get_descriptor_set() const;
+
+	uint32_t get_texture_count() const;
+
+	uint32_t get_capacity() const;
+
+  private:
+	Device &device;
+
+	VkDescriptorPool pool{VK_NULL_HANDLE};
+
+	std::unique_ptr<DescriptorSet> descriptor_set;
+
+	/// Binding of the texture array in the set
+	uint32_t binding{0};
+
+	VkDescriptorType descriptor_type{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER};
+
+	uint32_t capacity{0};
+
+	/// Index of each image view and sampler pair in the array
+	std::map<std::pair<VkImageView, VkSampler>, uint32_t> texture_indices;
+
+	std::unordered_map<const sg::Texture *, uint32_t> scene_texture_indices;
+};
+}        // namespace vkb
@@ -0,0 +1,176 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "buffer_pool.h"
+
+#include "core/device.h"
+
+namespace vkb
+{
+BufferAllocation::BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDeviceSize offset) :
+    buffer{&buffer},
+    base_offset{offset},
+    size{size}
+{
+}
+
+void BufferAllocation::update(const uint8_t *data, size_t size, size_t offset)
+{
+	assert(buffer && "Buffer allocation is empty");
+
+	if (offset + size > this->size)
+	{
+		LOGE("Buffer allocation update of %zu bytes at offset %zu is out of range", size, offset);
+		return;
+	}
+
+	buffer->update(data, size, static_cast<size_t>(base_offset) + offset);
+}
+
+bool BufferAllocation::empty() const
+{
+	return size == 0 || buffer == nullptr;
+}
+
+const core::Buffer &BufferAllocation::get_buffer() const
+{
+	assert(buffer && "Buffer allocation is empty");
+
+	return *buffer;
+}
+
+VkDeviceSize BufferAllocation::get_offset() const
+{
+	return base_offset;
+}
+
+VkDeviceSize BufferAllocation::get_size() const
+{
+	return size;
+}
+
+BufferBlock::BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
+    buffer{device, size, usage, memory_usage}
+{
+	const VkPhysicalDeviceLimits &limits = device.get_properties().limits;
+
+	// Vertex and index data only needs the alignment of its largest component
+	alignment = 16;
+
+	// Allocations must be bindable as any descriptor type of the usage. The offset
+	// alignments are powers of two, so the largest one satisfies all the others.
+	if (usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+	{
+		alignment = std::max(alignment, limits.minUniformBufferOffsetAlignment);
+	}
+
+	if (usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT)
+	{
+		alignment = std::max(alignment, limits.minStorageBufferOffsetAlignment);
+	}
+
+	if (usage & (VK_BUFFER_USAGE_UNIFORM_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT))
+	{
+		alignment = std::max(alignment, limits.minTexelBufferOffsetAlignment);
+	}
+}
+
+BufferAllocation BufferBlock::allocate(VkDeviceSize allocation_size)
+{
+	assert(allocation_size > 0 && "Allocation size must be greater than zero");
+
+	auto aligned_offset = (offset + alignment - 1) & ~(alignment - 1);
+
+	if (aligned_offset + allocation_size > buffer.get_size())
+	{
+		// No more space available in the block
+		return BufferAllocation{};
+	}
+
+	offset = aligned_offset + allocation_size;
+
+	return BufferAllocation{buffer, allocation_size, aligned_offset};
+}
+
+VkDeviceSize BufferBlock::get_size() const
+{
+	return buffer.get_size();
+}
+
+void BufferBlock::reset()
+{
+	offset = 0;
+}
+
+BufferPool::BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage) :
+    device{device},
+    block_size{block_size},
+    usage{usage},
+    memory_usage{memory_usage}
+{
+}
+
+BufferAllocation BufferPool::allocate(VkDeviceSize allocation_size)
+{
+	if (allocation_size == 0)
+	{
+		throw std::runtime_error("Cannot allocate an empty buffer range");
+	}
+
+	// Allocate from the current block, the previous ones being full
+	if (active_buffer_block_count > 0)
+	{
+		auto allocation = buffer_blocks[active_buffer_block_count - 1]->allocate(allocation_size);
+
+		if (!allocation.empty())
+		{
+			return allocation;
+		}
+	}
+
+	// Move to the next block, skipping the blocks which are too small
+	while (active_buffer_block_count < buffer_blocks.size())
+	{
+		auto allocation = buffer_blocks[active_buffer_block_count++]->allocate(allocation_size);
+
+		if (!allocation.empty())
+		{
+			return allocation;
+		}
+	}
+
+	// Create a new block, large enough for allocations bigger than the block size
+	buffer_blocks.emplace_back(std::make_unique<BufferBlock>(device, std::max(block_size, allocation_size), usage, memory_usage));
+
+	active_buffer_block_count = to_u32(buffer_blocks.size());
+
+	return buffer_blocks.back()->allocate(allocation_size);
+}
+
+void BufferPool::reset()
+{
+	for (auto &buffer_block : buffer_blocks)
+	{
+		buffer_block->reset();
+	}
+
+	active_buffer_block_count = 0;
+}
+}        // namespace vkb
@@ -0,0 +1,140 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include "core/buffer.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief A range of a buffer block, valid until the pool which allocated it is reset
+ */
+class BufferAllocation
+{
+  public:
+	BufferAllocation() = default;
+
+	BufferAllocation(core::Buffer &buffer, VkDeviceSize size, VkDeviceSize offset);
+
+	/**
+	 * @brief Copies data to the allocation, through the persistently mapped memory of its buffer
+	 * @param data Pointer to the data to copy
+	 * @param size Size of the data, in bytes
+	 * @param offset Offset of the data in the allocation, in bytes
+	 */
+	void update(const uint8_t *data, size_t size, size_t offset = 0);
+
+	template <class T>
+	void update(const T &value, size_t offset = 0)
+	{
+		update(reinterpret_cast<const uint8_t *>(&value), sizeof(T), offset);
+	}
+
+	bool empty() const;
+
+	const core::Buffer &get_buffer() const;
+
+	VkDeviceSize get_offset() const;
+
+	VkDeviceSize get_size() const;
+
+  private:
+	core::Buffer *buffer{nullptr};
+
+	VkDeviceSize base_offset{0};
+
+	VkDeviceSize size{0};
+};
+
+/**
+ * @brief A host visible buffer, from which ranges are allocated linearly
+ */
+class BufferBlock : public NonCopyable
+{
+  public:
+	BufferBlock(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage);
+
+	/// @brief Move construct
+	BufferBlock(BufferBlock &&other) = default;
+
+	/**
+	 * @return An allocation of the given size, or an empty allocation if the block is full
+	 */
+	BufferAllocation allocate(VkDeviceSize allocation_size);
+
+	VkDeviceSize get_size() const;
+
+	void reset();
+
+  private:
+	core::Buffer buffer;
+
+	// Memory alignment required by the usage of the buffer
+	VkDeviceSize alignment{0};
+
+	// Current offset, increased on every allocation
+	VkDeviceSize offset{0};
+};
+
+/**
+ * @brief Linear allocator of buffer data, for example uniforms updated for each draw.
+ *        Blocks are created when the previous ones are full, and are all recycled
+ *        at once when the frame owning the pool is reset after its fence signaled.
+ *        A pool which is never reset sub-allocates long lived data, such as scene geometry.
+ */
+class BufferPool : public NonCopyable
+{
+  public:
+	BufferPool(Device &device, VkDeviceSize block_size, VkBufferUsageFlags usage, VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_CPU_TO_GPU);
+
+	/// @brief Move construct
+	BufferPool(BufferPool &&other) = default;
+
+	/**
+	 * @return An allocation of the given size from the current block,
+	 *         or from a new block if the current one is full
+	 * @throws std::runtime_error if the size is zero
+	 */
+	BufferAllocation allocate(VkDeviceSize allocation_size);
+
+	void reset();
+
+  private:
+	Device &device;
+
+	// List of blocks requested
+	std::vector<std::unique_ptr<BufferBlock>> buffer_blocks;
+
+	// Minimum size of the blocks
+	VkDeviceSize block_size{0};
+
+	VkBufferUsageFlags usage{};
+
+	VmaMemoryUsage memory_usage{};
+
+	// Numbers of active blocks from the start of buffer_blocks
+	uint32_t active_buffer_block_count{0};
+};
+}        // namespace vkb
@@ -20,28 +20,258 @@
 
 #pragma once
 
+#include "common.h"
+#include "platform/thread_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 namespace vkb
 {
-/// Mananger of resources based on the given hasher function.
+/**
+ * @brief Limits enforced when a cache is trimmed, a value of zero disables the limit
+ */
+struct CacheBudget
+{
+	/// Number of frames a resource can stay unused before being evicted
+	uint64_t max_age{0};
+
+	/// Maximum number of resources kept in the cache
+	size_t max_count{0};
+
+	/// Maximum number of bytes kept in the cache, as estimated by detail::get_resource_size
+	size_t max_bytes{0};
+};
+
+/**
+ * @brief Bytes of the parameters a resource is requested with.
+ *        Resources are looked up by hash, but only returned if their keys
+ *        are equal, so that a hash collision never returns the wrong resource.
+ */
+class CacheKey
+{
+  public:
+	void clear();
+
+	void write(const void *bytes, size_t size);
+
+	template <typename T>
+	void write(const T &value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Cache key values must be trivially copyable");
+
+		write(&value, sizeof(T));
+	}
+
+	/**
+	 * @return The 64-bit hash of the key bytes
+	 */
+	uint64_t get_hash() const;
+
+	const std::vector<uint8_t> &get_data() const;
+
+  private:
+	std::vector<uint8_t> data;
+};
+
+/**
+ * @brief Mananger of resources based on the given hasher function.
+ *        Resources can be requested from multiple threads: the cache is split
+ *        in shards, each one guarded by a reader-writer lock, so that lookups
+ *        only contend with insertions in the same shard.
+ */
 template <typename T>
 class CacheResource
 {
   public:
-	/// Create a new resource or return the cached resource
+	/**
+	 * @brief Create a new resource or return the cached resource.
+	 *        When several threads request the same missing resource,
+	 *        only one builds it while the others wait for the result.
+	 */
 	template <typename... Args>
 	T &request_resource(Args &&... args);
 
+	/**
+	 * @brief Same as request_resource, using a hash computed by the caller
+	 *        instead of hashing the key. The hash must be a function of the
+	 *        parameters, otherwise the same resource could be built twice.
+	 */
+	template <typename... Args>
+	T &request_resource_with_hash(uint64_t res_hash, Args &&... args);
+
+	/**
+	 * @brief Same as request_resource_with_hash, building a missing resource
+	 *        with the given function instead of constructing it from the parameters
+	 * @param res_hash Hash of the parameters, as for request_resource_with_hash
+	 * @param build Function building the resource, only called on a cache miss
+	 * @param args Parameters identifying the resource
+	 */
+	template <typename... Args>
+	T &request_resource_with_builder(uint64_t res_hash, const std::function<T()> &build, const Args &... args);
+
+	/**
+	 * @brief Returns the resource identified by a key written by the caller, which lets the
+	 *        caller identify a resource without gathering the parameters it is built with
+	 * @param res_hash Hash of the key, as for request_resource_with_hash
+	 * @param key Key identifying the resource, which must not match keys written from other parameters
+	 * @param build Function building the resource, only called on a cache miss
+	 */
+	template <typename Builder>
+	T &request_resource_with_key(uint64_t res_hash, const CacheKey &key, Builder &&build);
+
+	/**
+	 * @brief Returns the cached resource without blocking. If it is missing,
+	 *        it is built by a task dispatched to the thread pool, and nullptr
+	 *        is returned until the resource is ready. A resource which failed
+	 *        to build is not built again, nullptr being returned for it.
+	 * @param res_hash Hash of the parameters, as for request_resource_with_hash
+	 * @param thread_pool Pool running the build
+	 * @param build Function building the resource, which must not reference the caller's stack
+	 * @param pending_build If not null, set to a future ready once the resource being built is cached or has failed
+	 * @param args Parameters identifying the resource
+	 */
+	template <typename... Args>
+	T *request_resource_async(uint64_t res_hash, ThreadPool &thread_pool, const std::function<T()> &build, std::shared_future<void> *pending_build, const Args &... args);
+
+	/**
+	 * @return The number of resources being built by the thread pool
+	 */
+	size_t get_async_build_count() const;
+
 	/*
-	 * @brief Removes cached resources. 
+	 * @brief Removes cached resources.
+	 *        Must not be called while other threads request resources.
 	 */
 	void clear();
 
+	/**
+	 * @brief Evicts all the cached resources, which are destroyed once the frames in flight
+	 *        completed, as the resources evicted by trim. Must be called from the thread calling trim.
+	 */
+	void evict_all();
+
+	/**
+	 * @brief Sets the limits enforced by trim
+	 */
+	void set_budget(const CacheBudget &budget);
+
+	/**
+	 * @brief Evicts the resources exceeding the budget, least recently used first.
+	 *        Resources used by a frame which may still be in flight are never evicted.
+	 *        Evicted resources are only destroyed once the frames in flight completed,
+	 *        as replayed commands may use them without requesting them.
+	 *        Resources requested afterwards are marked as used by this frame.
+	 * @param frame_index Monotonically increasing index of the frame being started
+	 * @param completed_frame Index of the latest frame which completed on the GPU along with all the frames before it
+	 * @return The number of resources evicted
+	 */
+	size_t trim(uint64_t frame_index, uint64_t completed_frame);
+
   private:
-	/// Map of resource's hash and the resource object
-	std::unordered_map<size_t, T> cache_resources;
+	/// Number of independently locked partitions of the cache
+	static const size_t SHARD_COUNT = 16;
+
+	/// Cached resource with its key and the index of the last frame which requested it
+	struct Entry
+	{
+		Entry(std::vector<uint8_t> &&key, T &&resource, uint64_t frame_index) :
+		    key{std::move(key)},
+		    resource{std::move(resource)},
+		    last_used{frame_index}
+		{}
+
+		std::vector<uint8_t> key;
+
+		T resource;
+
+		std::atomic<uint64_t> last_used;
+	};
+
+	/// Partition of the cache guarded by its own lock
+	struct Shard
+	{
+		std::shared_timed_mutex mutex;
+
+		/// Map of resource's hash and the resource entries, which differ by key on collisions
+		std::unordered_multimap<uint64_t, Entry> resources;
+
+		/// Resources currently being built by a thread, keyed by their hash
+		std::unordered_map<uint64_t, std::shared_future<void>> pending;
+
+		/// Keys of the resources which failed to build asynchronously, by hash
+		std::unordered_multimap<uint64_t, std::vector<uint8_t>> failed;
+	};
+
+	/**
+	 * @brief Build dispatched to a thread pool. If the pool drops the task without running it,
+	 *        the build is still resolved, so that the requests waiting for it do not wait forever.
+	 */
+	class AsyncBuild
+	{
+	  public:
+		AsyncBuild(CacheResource &cache, Shard &shard, uint64_t res_hash, std::vector<uint8_t> &&res_key, std::promise<void> &&build_promise);
+
+		~AsyncBuild();
+
+		void run(const std::function<T()> &build);
+
+	  private:
+		CacheResource &cache;
+
+		Shard &shard;
+
+		uint64_t res_hash;
+
+		std::vector<uint8_t> res_key;
+
+		std::promise<void> build_promise;
+
+		bool resolved{false};
+	};
+
+	std::array<Shard, SHARD_COUNT> shards;
+
+	/// Number of resources built, used to identify them in the log
+	std::atomic<size_t> resource_count{0};
+
+	/// Number of builds dispatched to a thread pool which have not completed
+	std::atomic<size_t> async_build_count{0};
+
+	/// Index of the frame being recorded, used to mark requested resources
+	std::atomic<uint64_t> current_frame{0};
+
+	CacheBudget budget;
+
+	/// Evicted resources waiting for the frames which may use them, with the frame they were evicted in
+	std::deque<std::pair<uint64_t, T>> retired;
+
+	Shard &get_shard(uint64_t res_hash);
+
+	/// Returns the entry matching the key, or nullptr if there is none
+	Entry *find_entry(Shard &shard, uint64_t res_hash, const std::vector<uint8_t> &key);
+
+	/// Returns whether the resource of the key failed to build asynchronously
+	bool has_failed(Shard &shard, uint64_t res_hash, const std::vector<uint8_t> &key);
+
+	/**
+	 * @brief Builds the resource, inserts it and resolves the pending build
+	 * @param keep_failure Whether a failure is recorded, so that the resource is not built again
+	 */
+	template <typename Builder>
+	T &build_resource(Shard &shard, uint64_t res_hash, std::vector<uint8_t> &&res_key, std::promise<void> &build_promise, Builder &&build, bool keep_failure = false);
+
+	/// Marks the entry as used by the current frame
+	T &touch_entry(Entry &entry);
 };
 }        // namespace vkb
 
@@ -26,155 +26,779 @@ namespace vkb
 {
 namespace detail
 {
+/**
+ * @brief Writes a request parameter to the key.
+ *        Framework objects are identified by their Vulkan handle.
+ */
 template <typename T>
-inline void hash_param(size_t &seed, const T &value)
+inline void write_param(CacheKey &key, const T &value)
 {
-	hash_combine(seed, value);
+	key.write(value.get_handle());
 }
 
 template <>
-inline void hash_param<std::vector<Attachment>>(
-    size_t &                       seed,
+inline void write_param<std::vector<Attachment>>(
+    CacheKey &                     key,
     const std::vector<Attachment> &value)
 {
+	key.write(value.size());
+
 	for (auto &attachment : value)
 	{
-		hash_combine(seed, attachment);
+		key.write(attachment.format);
+		key.write(attachment.samples);
 	}
 }
 
 template <>
-inline void hash_param<std::vector<LoadStoreInfo>>(
-    size_t &                          seed,
+inline void write_param<std::vector<LoadStoreInfo>>(
+    CacheKey &                        key,
     const std::vector<LoadStoreInfo> &value)
 {
+	key.write(value.size());
+
 	for (auto &load_store_info : value)
 	{
-		hash_combine(seed, load_store_info);
+		key.write(load_store_info.load_op);
+		key.write(load_store_info.store_op);
 	}
 }
 
 template <>
-inline void hash_param<std::vector<SubpassInfo>>(
-    size_t &                        seed,
+inline void write_param<std::vector<SubpassInfo>>(
+    CacheKey &                      key,
     const std::vector<SubpassInfo> &value)
 {
+	key.write(value.size());
+
 	for (auto &subpass_info : value)
 	{
-		hash_combine(seed, subpass_info);
+		key.write(subpass_info.output_attachments.size());
+
+		for (uint32_t output_attachment : subpass_info.output_attachments)
+		{
+			key.write(output_attachment);
+		}
+
+		key.write(subpass_info.input_attachments.size());
+
+		for (uint32_t input_attachment : subpass_info.input_attachments)
+		{
+			key.write(input_attachment);
+		}
 	}
 }
 
+/**
+ * @brief Shader modules are identified by their content rather than their handle,
+ *        so that modules compiled again from the same shader share a pipeline layout.
+ *        The id is written as well, as it accounts for the buffers bound with dynamic
+ *        offsets, which change the descriptor set layouts owned by the pipeline layout.
+ */
 template <>
-inline void hash_param<std::vector<ShaderModule>>(
-    size_t &                         seed,
+inline void write_param<std::vector<ShaderModule>>(
+    CacheKey &                       key,
     const std::vector<ShaderModule> &value)
 {
+	key.write(value.size());
+
 	for (auto &shader_module : value)
 	{
-		hash_combine(seed, shader_module);
+		auto &entry_point = shader_module.get_entry_point();
+		auto &spirv       = shader_module.get_binary();
+
+		key.write(shader_module.get_id());
+		key.write(shader_module.get_stage());
+		key.write(entry_point.size());
+		key.write(entry_point.data(), entry_point.size());
+		key.write(spirv.size());
+		key.write(spirv.data(), spirv.size() * sizeof(uint32_t));
 	}
 }
 
 template <>
-inline void hash_param<std::unordered_map<uint32_t, std::map<uint32_t, VkDescriptorBufferInfo>>>(
-    size_t &                                                                        seed,
-    const std::unordered_map<uint32_t, std::map<uint32_t, VkDescriptorBufferInfo>> &value)
+inline void write_param<RenderTarget>(
+    CacheKey &          key,
+    const RenderTarget &value)
+{
+	key.write(value.get_views().size());
+
+	for (auto &view : value.get_views())
+	{
+		key.write(view.get_handle());
+	}
+}
+
+/**
+ * @brief Calls the function for each set of a binding map in ascending set index order,
+ *        as the iteration order of equal unordered maps may differ. Pipelines only have
+ *        a few sets, so each one is found by a linear search rather than sorting a copy.
+ */
+template <typename T, typename Func>
+inline void for_each_sorted_set(const BindingMap<T> &binding_map, Func &&func)
 {
-	for (auto &binding_set : value)
+	const std::pair<const uint32_t, std::map<uint32_t, T>> *previous_set{nullptr};
+
+	for (size_t i = 0; i < binding_map.size(); ++i)
 	{
-		hash_combine(seed, binding_set.first);
+		const std::pair<const uint32_t, std::map<uint32_t, T>> *next_set{nullptr};
 
-		for (auto &binding_element : binding_set.second)
+		for (auto &binding_set : binding_map)
 		{
-			hash_combine(seed, binding_element.first);
-			hash_combine(seed, binding_element.second);
+			if ((!previous_set || binding_set.first > previous_set->first) &&
+			    (!next_set || binding_set.first < next_set->first))
+			{
+				next_set = &binding_set;
+			}
 		}
+
+		func(next_set->first, next_set->second);
+
+		previous_set = next_set;
 	}
 }
 
 template <>
-inline void hash_param<std::unordered_map<uint32_t, std::map<uint32_t, VkDescriptorImageInfo>>>(
-    size_t &                                                                       seed,
-    const std::unordered_map<uint32_t, std::map<uint32_t, VkDescriptorImageInfo>> &value)
+inline void write_param<BindingMap<VkDescriptorBufferInfo>>(
+    CacheKey &                                key,
+    const BindingMap<VkDescriptorBufferInfo> &value)
 {
-	for (auto &binding_set : value)
-	{
-		hash_combine(seed, binding_set.first);
+	key.write(value.size());
+
+	for_each_sorted_set(value, [&key](uint32_t set, const std::map<uint32_t, VkDescriptorBufferInfo> &binding_set) {
+		key.write(set);
+		key.write(binding_set.size());
 
-		for (auto &binding_element : binding_set.second)
+		for (auto &binding_element : binding_set)
 		{
-			hash_combine(seed, binding_element.first);
-			hash_combine(seed, binding_element.second);
+			key.write(binding_element.first);
+			key.write(binding_element.second.buffer);
+			key.write(binding_element.second.offset);
+			key.write(binding_element.second.range);
 		}
+	});
+}
+
+template <>
+inline void write_param<BindingMap<VkDescriptorImageInfo>>(
+    CacheKey &                               key,
+    const BindingMap<VkDescriptorImageInfo> &value)
+{
+	key.write(value.size());
+
+	for_each_sorted_set(value, [&key](uint32_t set, const std::map<uint32_t, VkDescriptorImageInfo> &binding_set) {
+		key.write(set);
+		key.write(binding_set.size());
+
+		for (auto &binding_element : binding_set)
+		{
+			key.write(binding_element.first);
+			key.write(binding_element.second.sampler);
+			key.write(binding_element.second.imageView);
+			key.write(binding_element.second.imageLayout);
+		}
+	});
+}
+
+template <>
+inline void write_param<SpecializationInfo>(
+    CacheKey &                key,
+    const SpecializationInfo &value)
+{
+	key.write(value.get_map_entries().size());
+
+	for (auto &map_entry : value.get_map_entries())
+	{
+		key.write(map_entry.constantID);
+		key.write(map_entry.offset);
+		key.write(map_entry.size);
 	}
+
+	key.write(value.get_data().size());
+	key.write(value.get_data().data(), value.get_data().size());
 }
 
 template <>
-inline void hash_param<std::map<VkShaderStageFlagBits, SpecializationInfo>>(
-    size_t &                                                   seed,
+inline void write_param<std::map<VkShaderStageFlagBits, SpecializationInfo>>(
+    CacheKey &                                                 key,
     const std::map<VkShaderStageFlagBits, SpecializationInfo> &value)
 {
+	key.write(value.size());
+
 	for (auto &stage_specialization : value)
 	{
-		hash_combine(seed, static_cast<std::underlying_type<VkShaderStageFlagBits>::type>(stage_specialization.first));
-		hash_combine(seed, stage_specialization.second);
+		key.write(stage_specialization.first);
+		write_param(key, stage_specialization.second);
 	}
 }
 
+/**
+ * @brief Graphics pipeline states keep the bytes of their key, which are only written again after they changed
+ */
+template <>
+inline void write_param<GraphicsPipelineState>(
+    CacheKey &                   key,
+    const GraphicsPipelineState &value)
+{
+	auto &state_key = value.get_key();
+
+	key.write(state_key.data(), state_key.size());
+}
+
 template <typename T, typename... Args>
-inline void hash_param(size_t &seed, const T &first_arg, const Args &... args)
+inline void write_param(CacheKey &key, const T &first_arg, const Args &... args)
+{
+	write_param(key, first_arg);
+
+	write_param(key, args...);
+}
+
+/**
+ * @brief Writes the parameters of a request to a key reused by the calling thread,
+ *        to avoid allocating a new key on every request
+ */
+template <typename... Args>
+inline const CacheKey &write_request_key(const Args &... args)
+{
+	thread_local CacheKey key;
+
+	key.clear();
+
+	write_param(key, args...);
+
+	return key;
+}
+
+/**
+ * @brief Estimates the memory used by a cached resource, checked against CacheBudget::max_bytes.
+ *        Resources using more memory than their object, such as the descriptors of a set or the
+ *        shaders of a pipeline, estimate it themselves.
+ */
+template <typename T>
+inline size_t get_resource_size(const T &)
 {
-	hash_param(seed, first_arg);
+	return sizeof(T);
+}
+
+template <>
+inline size_t get_resource_size<DescriptorSet>(const DescriptorSet &resource)
+{
+	return resource.get_size();
+}
 
-	hash_param(seed, args...);
+template <>
+inline size_t get_resource_size<Framebuffer>(const Framebuffer &resource)
+{
+	return resource.get_size();
+}
+
+template <>
+inline size_t get_resource_size<GraphicsPipeline>(const GraphicsPipeline &resource)
+{
+	return resource.get_size();
+}
+
+template <>
+inline size_t get_resource_size<PipelineLayout>(const PipelineLayout &resource)
+{
+	return resource.get_size();
 }
 }        // namespace detail
 
+inline void CacheKey::clear()
+{
+	data.clear();
+}
+
+inline void CacheKey::write(const void *bytes, size_t size)
+{
+	auto begin = static_cast<const uint8_t *>(bytes);
+
+	data.insert(data.end(), begin, begin + size);
+}
+
+inline uint64_t CacheKey::get_hash() const
+{
+	return hash_bytes(data.data(), data.size());
+}
+
+inline const std::vector<uint8_t> &CacheKey::get_data() const
+{
+	return data;
+}
+
+template <typename T>
+inline typename CacheResource<T>::Shard &CacheResource<T>::get_shard(uint64_t res_hash)
+{
+	// Fold the upper bits in, as the lower bits alone may be poorly distributed
+	return shards[(res_hash ^ (res_hash >> 32)) % SHARD_COUNT];
+}
+
+template <typename T>
+inline typename CacheResource<T>::Entry *CacheResource<T>::find_entry(Shard &shard, uint64_t res_hash, const std::vector<uint8_t> &key)
+{
+	auto res_range = shard.resources.equal_range(res_hash);
+
+	for (auto res_it = res_range.first; res_it != res_range.second; ++res_it)
+	{
+		if (res_it->second.key == key)
+		{
+			return &res_it->second;
+		}
+	}
+
+	return nullptr;
+}
+
+template <typename T>
+inline bool CacheResource<T>::has_failed(Shard &shard, uint64_t res_hash, const std::vector<uint8_t> &key)
+{
+	auto failed_range = shard.failed.equal_range(res_hash);
+
+	return std::any_of(failed_range.first, failed_range.second, [&key](const std::pair<const uint64_t, std::vector<uint8_t>> &failed) {
+		return failed.second == key;
+	});
+}
+
 template <typename T>
 template <typename... Args>
 inline T &CacheResource<T>::request_resource(Args &&... args)
 {
-	size_t res_hash = 0;
+	const CacheKey &key = detail::write_request_key(args...);
+
+	return request_resource_with_key(key.get_hash(), key, [&]() {
+		return T(std::forward<Args>(args)...);
+	});
+}
+
+template <typename T>
+template <typename... Args>
+inline T &CacheResource<T>::request_resource_with_hash(uint64_t res_hash, Args &&... args)
+{
+	const CacheKey &key = detail::write_request_key(args...);
+
+	return request_resource_with_key(res_hash, key, [&]() {
+		return T(std::forward<Args>(args)...);
+	});
+}
+
+template <typename T>
+template <typename... Args>
+inline T &CacheResource<T>::request_resource_with_builder(uint64_t res_hash, const std::function<T()> &build, const Args &... args)
+{
+	const CacheKey &key = detail::write_request_key(args...);
 
-	detail::hash_param(res_hash, args...);
+	return request_resource_with_key(res_hash, key, build);
+}
 
-	auto res_it = cache_resources.find(res_hash);
+template <typename T>
+template <typename Builder>
+inline T &CacheResource<T>::request_resource_with_key(uint64_t res_hash, const CacheKey &key, Builder &&build)
+{
+	Shard &shard = get_shard(res_hash);
 
-	if (res_it != cache_resources.end())
+	while (true)
 	{
-		return res_it->second;
+		// Most requests hit an existing resource and only need a shared lock
+		{
+			std::shared_lock<std::shared_timed_mutex> lock{shard.mutex};
+
+			if (Entry *entry = find_entry(shard, res_hash, key.get_data()))
+			{
+				return touch_entry(*entry);
+			}
+		}
+
+		std::promise<void> build_promise;
+
+		{
+			std::unique_lock<std::shared_timed_mutex> lock{shard.mutex};
+
+			// Another thread may have inserted it before the exclusive lock was acquired
+			if (Entry *entry = find_entry(shard, res_hash, key.get_data()))
+			{
+				return touch_entry(*entry);
+			}
+
+			// Builds are tracked by hash only, a collision just delays the other request
+			auto pending_it = shard.pending.find(res_hash);
+
+			if (pending_it != shard.pending.end())
+			{
+				// Another thread is building it, wait for it and look it up again
+				std::shared_future<void> pending_build = pending_it->second;
+
+				lock.unlock();
+
+				pending_build.wait();
+
+				continue;
+			}
+
+			shard.pending.emplace(res_hash, build_promise.get_future().share());
+		}
+
+		// If we do not have it already, create and cache it
+		// The resource is built outside of the lock, so that other requests are not blocked
+		// Copy the key, as building the resource may request other resources from this thread
+		return build_resource(shard, res_hash, std::vector<uint8_t>(key.get_data()), build_promise, build);
 	}
+}
 
-	// If we do not have it already, create and cache it
+template <typename T>
+template <typename... Args>
+inline T *CacheResource<T>::request_resource_async(uint64_t res_hash, ThreadPool &thread_pool, const std::function<T()> &build, std::shared_future<void> *pending_build, const Args &... args)
+{
+	const CacheKey &key = detail::write_request_key(args...);
+
+	Shard &shard = get_shard(res_hash);
+
+	{
+		std::shared_lock<std::shared_timed_mutex> lock{shard.mutex};
+
+		if (Entry *entry = find_entry(shard, res_hash, key.get_data()))
+		{
+			return &touch_entry(*entry);
+		}
+
+		if (has_failed(shard, res_hash, key.get_data()))
+		{
+			return nullptr;
+		}
+	}
+
+	std::promise<void> build_promise;
+
+	{
+		std::unique_lock<std::shared_timed_mutex> lock{shard.mutex};
+
+		if (Entry *entry = find_entry(shard, res_hash, key.get_data()))
+		{
+			return &touch_entry(*entry);
+		}
+
+		// Already being built, either by a worker or by another thread
+		auto pending_it = shard.pending.find(res_hash);
+
+		if (pending_it != shard.pending.end())
+		{
+			if (pending_build)
+			{
+				*pending_build = pending_it->second;
+			}
+
+			return nullptr;
+		}
+
+		// Building it again would fail again
+		if (has_failed(shard, res_hash, key.get_data()))
+		{
+			return nullptr;
+		}
+
+		auto build_future = build_promise.get_future().share();
+
+		if (pending_build)
+		{
+			*pending_build = build_future;
+		}
+
+		shard.pending.emplace(res_hash, std::move(build_future));
+	}
+
+	auto async_build = std::make_shared<AsyncBuild>(*this, shard, res_hash, std::vector<uint8_t>(key.get_data()), std::move(build_promise));
+
+	thread_pool.dispatch([async_build, build]() {
+		async_build->run(build);
+	});
+
+	return nullptr;
+}
+
+template <typename T>
+inline CacheResource<T>::AsyncBuild::AsyncBuild(CacheResource &cache, Shard &shard, uint64_t res_hash, std::vector<uint8_t> &&res_key, std::promise<void> &&build_promise) :
+    cache{cache},
+    shard{shard},
+    res_hash{res_hash},
+    res_key{std::move(res_key)},
+    build_promise{std::move(build_promise)}
+{
+	++cache.async_build_count;
+}
+
+template <typename T>
+inline CacheResource<T>::AsyncBuild::~AsyncBuild()
+{
+	// The task was dropped before running, release the pending entry so that the resource can be requested again
+	if (!resolved)
+	{
+		{
+			std::lock_guard<std::shared_timed_mutex> lock{shard.mutex};
+
+			shard.pending.erase(res_hash);
+		}
+
+		build_promise.set_value();
+	}
+
+	--cache.async_build_count;
+}
+
+template <typename T>
+inline void CacheResource<T>::AsyncBuild::run(const std::function<T()> &build)
+{
+	// The build is resolved by build_resource, whether it succeeds or throws
+	resolved = true;
+
+	try
+	{
+		cache.build_resource(shard, res_hash, std::move(res_key), build_promise, build, true);
+	}
+	catch (const std::exception &)
+	{
+		// The error is logged and kept by build_resource
+	}
+}
+
+template <typename T>
+inline size_t CacheResource<T>::get_async_build_count() const
+{
+	return async_build_count.load();
+}
+
+template <typename T>
+template <typename Builder>
+inline T &CacheResource<T>::build_resource(Shard &shard, uint64_t res_hash, std::vector<uint8_t> &&res_key, std::promise<void> &build_promise, Builder &&build, bool keep_failure)
+{
 	const char *res_type = typeid(T).name();
-	size_t      res_id   = cache_resources.size();
+	size_t      res_id   = resource_count++;
 
 	LOGI("Building #%zu cache object (%s)", res_id, res_type);
 
 	try
 	{
-		T resource(std::forward<Args>(args)...);
+		T resource(build());
 
-		auto res_ins_it = cache_resources.emplace(res_hash, std::move(resource));
+		std::unique_lock<std::shared_timed_mutex> lock{shard.mutex};
+
+		// The pending entry guarantees that no other thread inserted the same key
+		auto res_it = shard.resources.emplace(std::piecewise_construct,
+		                                      std::forward_as_tuple(res_hash),
+		                                      std::forward_as_tuple(std::move(res_key), std::move(resource), current_frame.load(std::memory_order_relaxed)));
+
+		shard.pending.erase(res_hash);
+
+		lock.unlock();
+
+		build_promise.set_value();
+
+		return res_it->second.resource;
+	}
+	catch (const std::exception &)
+	{
+		LOGE("Creation error for #%zu cache object ( %s )", res_id, res_type);
 
-		if (!res_ins_it.second)
 		{
-			throw std::runtime_error{std::string{"Insertion error for #"} + std::to_string(res_id) + "cache object (" + res_type + ")"};
+			std::lock_guard<std::shared_timed_mutex> lock{shard.mutex};
+
+			if (keep_failure)
+			{
+				shard.failed.emplace(res_hash, std::move(res_key));
+			}
+
+			shard.pending.erase(res_hash);
 		}
 
-		return res_ins_it.first->second;
+		// Waiting threads will try to build the resource themselves
+		build_promise.set_value();
+
+		throw;
 	}
-	catch (const std::exception &e)
+}
+
+template <typename T>
+inline T &CacheResource<T>::touch_entry(Entry &entry)
+{
+	uint64_t frame_index = current_frame.load(std::memory_order_relaxed);
+
+	// Avoid writing to the shared entry when it was already used this frame
+	if (entry.last_used.load(std::memory_order_relaxed) != frame_index)
 	{
-		LOGE("Creation error for #%zu cache object ( %s )", res_id, res_type);
-		throw e;
+		entry.last_used.store(frame_index, std::memory_order_relaxed);
 	}
+
+	return entry.resource;
 }
 
 template <typename T>
 inline void vkb::CacheResource<T>::clear()
 {
-	cache_resources.clear();
+	for (auto &shard : shards)
+	{
+		std::lock_guard<std::shared_timed_mutex> lock{shard.mutex};
+
+		shard.resources.clear();
+
+		shard.failed.clear();
+	}
+
+	retired.clear();
+
+	resource_count = 0;
+}
+
+template <typename T>
+inline void CacheResource<T>::evict_all()
+{
+	for (auto &shard : shards)
+	{
+		std::lock_guard<std::shared_timed_mutex> lock{shard.mutex};
+
+		for (auto &res_it : shard.resources)
+		{
+			retired.emplace_back(current_frame.load(), std::move(res_it.second.resource));
+		}
+
+		shard.resources.clear();
+
+		shard.failed.clear();
+	}
+
+	resource_count = 0;
+}
+
+template <typename T>
+inline void CacheResource<T>::set_budget(const CacheBudget &new_budget)
+{
+	budget = new_budget;
+}
+
+template <typename T>
+inline size_t CacheResource<T>::trim(uint64_t frame_index, uint64_t completed_frame)
+{
+	current_frame = frame_index;
+
+	// Destroy the evicted resources once every frame which may have used them has completed
+	while (!retired.empty() && retired.front().first <= completed_frame)
+	{
+		retired.pop_front();
+	}
+
+	if (budget.max_age == 0 && budget.max_count == 0 && budget.max_bytes == 0)
+	{
+		return 0;
+	}
+
+	size_t evicted_count{0};
+
+	auto evict = [&](Shard &shard, typename std::unordered_multimap<uint64_t, Entry>::iterator res_it) {
+		retired.emplace_back(frame_index, std::move(res_it->second.resource));
+
+		++evicted_count;
+
+		return shard.resources.erase(res_it);
+	};
+
+	// A resource can only be destroyed once every frame that used it has completed
+	auto is_evictable = [&](uint64_t last_used) {
+		return last_used <= completed_frame;
+	};
+
+	struct Candidate
+	{
+		Shard *shard;
+
+		uint64_t res_hash;
+
+		const Entry *entry;
+
+		uint64_t last_used;
+
+		size_t size;
+	};
+
+	std::vector<Candidate> candidates;
+
+	size_t total_count{0};
+	size_t total_bytes{0};
+
+	// Evict resources unused for too long, and collect the others that could be evicted
+	for (auto &shard : shards)
+	{
+		std::lock_guard<std::shared_timed_mutex> lock{shard.mutex};
+
+		for (auto res_it = shard.resources.begin(); res_it != shard.resources.end();)
+		{
+			uint64_t last_used = res_it->second.last_used.load(std::memory_order_relaxed);
+
+			if (!is_evictable(last_used))
+			{
+				total_count += 1;
+				total_bytes += detail::get_resource_size(res_it->second.resource);
+
+				++res_it;
+				continue;
+			}
+
+			if (budget.max_age != 0 && frame_index - last_used > budget.max_age)
+			{
+				res_it = evict(shard, res_it);
+				continue;
+			}
+
+			size_t size = detail::get_resource_size(res_it->second.resource);
+
+			total_count += 1;
+			total_bytes += size;
+
+			candidates.push_back({&shard, res_it->first, &res_it->second, last_used, size});
+
+			++res_it;
+		}
+	}
+
+	auto is_over_budget = [&]() {
+		return (budget.max_count != 0 && total_count > budget.max_count) ||
+		       (budget.max_bytes != 0 && total_bytes > budget.max_bytes);
+	};
+
+	if (!is_over_budget())
+	{
+		return evicted_count;
+	}
+
+	// Evict the least recently used resources until the cache fits in its budget
+	std::sort(candidates.begin(), candidates.end(), [](const Candidate &lhs, const Candidate &rhs) {
+		return lhs.last_used < rhs.last_used;
+	});
+
+	for (auto &candidate : candidates)
+	{
+		if (!is_over_budget())
+		{
+			break;
+		}
+
+		std::lock_guard<std::shared_timed_mutex> lock{candidate.shard->mutex};
+
+		// Only trim erases resources, so the entry is still in the shard
+		auto res_range = candidate.shard->resources.equal_range(candidate.res_hash);
+
+		auto res_it = std::find_if(res_range.first, res_range.second, [&](const std::pair<const uint64_t, Entry> &res) {
+			return &res.second == candidate.entry;
+		});
+
+		// Skip resources requested again since they were collected
+		if (res_it != res_range.second &&
+		    res_it->second.last_used.load(std::memory_order_relaxed) == candidate.last_used)
+		{
+			evict(*candidate.shard, res_it);
+
+			total_count -= 1;
+			total_bytes -= candidate.size;
+		}
+	}
+
+	return evicted_count;
 }
 }        // namespace vkb
@@ -0,0 +1,87 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "command_arena.h"
+
+namespace vkb
+{
+void CommandArena::reset()
+{
+	size = 0;
+}
+
+size_t CommandArena::get_size() const
+{
+	return size;
+}
+
+void CommandArena::write(CommandType type)
+{
+	allocate(type, align(sizeof(CommandHeader)));
+}
+
+void CommandArena::append(const CommandArena &other)
+{
+	reserve(size + other.size);
+
+	// Packets do not point into the arena, so they are copied as they are
+	std::copy(other.storage.begin(), other.storage.begin() + other.size / sizeof(uint64_t), storage.begin() + size / sizeof(uint64_t));
+
+	size += other.size;
+}
+
+const CommandHeader &CommandArena::get_header(size_t offset) const
+{
+	return *reinterpret_cast<const CommandHeader *>(reinterpret_cast<const uint8_t *>(storage.data()) + offset);
+}
+
+CommandHeader &CommandArena::get_header(size_t offset)
+{
+	return *reinterpret_cast<CommandHeader *>(reinterpret_cast<uint8_t *>(storage.data()) + offset);
+}
+
+void CommandArena::reserve(size_t required_size)
+{
+	size_t required_words = required_size / sizeof(uint64_t);
+
+	if (required_words > storage.size())
+	{
+		// Grow geometrically, the memory is reused by the next frames
+		storage.resize(std::max(required_words, storage.size() * 2));
+	}
+}
+
+uint8_t *CommandArena::allocate(CommandType type, size_t packet_size)
+{
+	packet_size = align(packet_size);
+
+	reserve(size + packet_size);
+
+	uint8_t *packet = reinterpret_cast<uint8_t *>(storage.data()) + size;
+
+	auto &header = *reinterpret_cast<CommandHeader *>(packet);
+	header.type  = type;
+	header.size  = to_u32(packet_size);
+
+	size += packet_size;
+
+	return packet;
+}
+}        // namespace vkb
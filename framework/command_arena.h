@@ -0,0 +1,391 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "common.h"
+
+namespace vkb
+{
+enum class CommandType : uint32_t
+{
+	Begin,
+	End,
+	BeginRenderPass,
+	NextSubpass,
+	EndRenderPass,
+	BindPipelineLayout,
+	PushConstants,
+	BindBuffer,
+	BindImage,
+	BindVertexBuffers,
+	BindIndexBuffer,
+	SetVertexInputFormat,
+	SetViewportState,
+	SetInputAssemblyState,
+	SetRasterizationState,
+	SetMultisampleState,
+	SetDepthStencilState,
+	SetColorBlendState,
+	SetViewport,
+	SetScissor,
+	SetLineWidth,
+	SetDepthBias,
+	SetBlendConstants,
+	SetDepthBounds,
+	Draw,
+	DrawIndexed,
+	UpdateBuffer,
+	CopyImage,
+	CopyBufferToImage,
+	ImageMemoryBarrier,
+	ExecuteCommands,
+	DrawIndirect,
+	DrawIndexedIndirect,
+	Dispatch,
+	DispatchIndirect,
+	BufferMemoryBarrier,
+	CopyBuffer
+};
+
+/*
+ * @brief Header in front of every command packet
+ */
+struct CommandHeader
+{
+	CommandType type;
+
+	/// Size in bytes of the packet, including the header and the trailing data
+	uint32_t size;
+};
+
+/*
+ * @brief Parameters of the recorded commands. Arrays are stored after the
+ *        packet, and accessed with CommandArena::get_data.
+ */
+struct BeginCommand
+{
+	VkCommandBufferUsageFlags flags;
+};
+
+struct PushConstantsCommand
+{
+	VkPipelineLayout pipeline_layout;
+
+	VkShaderStageFlags shader_stage;
+
+	uint32_t offset;
+
+	/// Size of the trailing values, in bytes
+	uint32_t size;
+};
+
+struct BindVertexBuffersCommand
+{
+	uint32_t first_binding;
+
+	/// Number of trailing buffers, followed by as many offsets
+	uint32_t binding_count;
+};
+
+struct BindIndexBufferCommand
+{
+	VkBuffer buffer;
+
+	VkDeviceSize offset;
+
+	VkIndexType index_type;
+};
+
+struct SetViewportCommand
+{
+	uint32_t first_viewport;
+
+	uint32_t viewport_count;
+};
+
+struct SetScissorCommand
+{
+	uint32_t first_scissor;
+
+	uint32_t scissor_count;
+};
+
+struct SetLineWidthCommand
+{
+	float line_width;
+};
+
+struct SetDepthBiasCommand
+{
+	float depth_bias_constant_factor;
+
+	float depth_bias_clamp;
+
+	float depth_bias_slope_factor;
+};
+
+struct SetBlendConstantsCommand
+{
+	float blend_constants[4];
+};
+
+struct SetDepthBoundsCommand
+{
+	float min_depth_bounds;
+
+	float max_depth_bounds;
+};
+
+struct DrawCommand
+{
+	uint32_t vertex_count;
+
+	uint32_t instance_count;
+
+	uint32_t first_vertex;
+
+	uint32_t first_instance;
+};
+
+struct DrawIndexedCommand
+{
+	uint32_t index_count;
+
+	uint32_t instance_count;
+
+	uint32_t first_index;
+
+	int32_t vertex_offset;
+
+	uint32_t first_instance;
+};
+
+/*
+ * @brief Parameters of draw_indirect and draw_indexed_indirect
+ */
+struct DrawIndirectCommand
+{
+	VkBuffer buffer;
+
+	VkDeviceSize offset;
+
+	uint32_t draw_count;
+
+	uint32_t stride;
+};
+
+struct UpdateBufferCommand
+{
+	VkBuffer buffer;
+
+	VkDeviceSize offset;
+
+	/// Size of the trailing data, in bytes
+	uint32_t size;
+};
+
+struct CopyImageCommand
+{
+	VkImage src_image;
+
+	VkImage dst_image;
+
+	uint32_t region_count;
+};
+
+struct CopyBufferCommand
+{
+	VkBuffer src_buffer;
+
+	VkBuffer dst_buffer;
+
+	uint32_t region_count;
+};
+
+struct CopyBufferToImageCommand
+{
+	VkBuffer buffer;
+
+	VkImage image;
+
+	uint32_t region_count;
+};
+
+struct ImageMemoryBarrierCommand
+{
+	VkImage image;
+
+	VkImageSubresourceRange subresource_range;
+
+	ImageMemoryBarrier memory_barrier;
+};
+
+struct ExecuteCommandsCommand
+{
+	/// Number of trailing secondary command buffers
+	uint32_t command_buffer_count;
+};
+
+struct DispatchCommand
+{
+	uint32_t group_count_x;
+
+	uint32_t group_count_y;
+
+	uint32_t group_count_z;
+};
+
+struct DispatchIndirectCommand
+{
+	VkBuffer buffer;
+
+	VkDeviceSize offset;
+};
+
+struct BufferMemoryBarrierCommand
+{
+	VkBuffer buffer;
+
+	VkDeviceSize offset;
+
+	VkDeviceSize size;
+
+	BufferMemoryBarrier memory_barrier;
+};
+
+/*
+ * @brief Contiguous memory storing command packets one after the other.
+ *        Packets are aligned so that they can be read in place, and the
+ *        memory is kept when the arena is reset, so that recording a frame
+ *        does not allocate once the arena has grown to the size of a frame.
+ */
+class CommandArena
+{
+  public:
+	/// Alignment of the packets and of their trailing data
+	static const size_t PACKET_ALIGNMENT = alignof(uint64_t);
+
+	/*
+	 * @brief Removes all packets, keeping the memory
+	 */
+	void reset();
+
+	/*
+	 * @return The size in bytes of the packets, which is also the offset of the next packet
+	 */
+	size_t get_size() const;
+
+	/*
+	 * @brief Appends a packet without parameters
+	 */
+	void write(CommandType type);
+
+	/*
+	 * @brief Appends a packet, followed by data_size bytes to be filled with get_data
+	 * @return The packet stored in the arena, valid until the next write
+	 */
+	template <typename T>
+	T &write(CommandType type, const T &command, size_t data_size = 0);
+
+	/*
+	 * @brief Appends copies of all the packets of another arena
+	 */
+	void append(const CommandArena &other);
+
+	/*
+	 * @return The header of the packet starting at the given offset
+	 */
+	const CommandHeader &get_header(size_t offset) const;
+
+	CommandHeader &get_header(size_t offset);
+
+	/*
+	 * @return The parameters of a packet
+	 */
+	template <typename T>
+	static const T &get_command(const CommandHeader &header);
+
+	template <typename T>
+	static T &get_command(CommandHeader &header);
+
+	/*
+	 * @return The data following the parameters of a packet
+	 */
+	template <typename D, typename T>
+	static D *get_data(T &command);
+
+	template <typename D, typename T>
+	static const D *get_data(const T &command);
+
+  private:
+	/// Storage of the packets, in words so that it is suitably aligned
+	std::vector<uint64_t> storage;
+
+	size_t size{0};
+
+	/// Returns size rounded up to the packet alignment
+	static constexpr size_t align(size_t value)
+	{
+		return (value + PACKET_ALIGNMENT - 1) & ~(PACKET_ALIGNMENT - 1);
+	}
+
+	/// Grows the storage to hold at least the given number of bytes
+	void reserve(size_t required_size);
+
+	/// Reserves an aligned block at the end of the arena
+	uint8_t *allocate(CommandType type, size_t packet_size);
+};
+
+template <typename T>
+inline T &CommandArena::write(CommandType type, const T &command, size_t data_size)
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Command packets must be trivially copyable");
+	static_assert(alignof(T) <= PACKET_ALIGNMENT, "Command packets must not be over-aligned");
+
+	uint8_t *packet = allocate(type, align(sizeof(CommandHeader)) + align(sizeof(T)) + data_size);
+
+	return *new (packet + align(sizeof(CommandHeader))) T(command);
+}
+
+template <typename T>
+inline const T &CommandArena::get_command(const CommandHeader &header)
+{
+	return *reinterpret_cast<const T *>(reinterpret_cast<const uint8_t *>(&header) + align(sizeof(CommandHeader)));
+}
+
+template <typename T>
+inline T &CommandArena::get_command(CommandHeader &header)
+{
+	return *reinterpret_cast<T *>(reinterpret_cast<uint8_t *>(&header) + align(sizeof(CommandHeader)));
+}
+
+template <typename D, typename T>
+inline D *CommandArena::get_data(T &command)
+{
+	return reinterpret_cast<D *>(reinterpret_cast<uint8_t *>(&command) + align(sizeof(T)));
+}
+
+template <typename D, typename T>
+inline const D *CommandArena::get_data(const T &command)
+{
+	return reinterpret_cast<const D *>(reinterpret_cast<const uint8_t *>(&command) + align(sizeof(T)));
+}
+}        // namespace vkb
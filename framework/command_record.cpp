@@ -20,6 +20,7 @@
 
 #include "command_record.h"
 
+#include "core/command_buffer.h"
 #include "core/descriptor_set_layout.h"
 #include "core/device.h"
 #include "core/shader_module.h"
@@ -30,50 +31,205 @@ namespace vkb
 {
 namespace
 {
-template <typename T>
-inline void write(std::ostringstream &os, const T &value)
+bool is_dynamic_buffer(const VkDescriptorSetLayoutBinding &binding_info)
 {
-	os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	return binding_info.descriptorType == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC ||
+	       binding_info.descriptorType == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
 }
 
-template <class T>
-inline void write(std::ostringstream &os, const std::vector<T> &value)
+/**
+ * @brief Writes the key of a descriptor set from the resources bound to it, without gathering their
+ *        descriptor infos. It starts with a null handle, where the keys written from descriptor infos
+ *        start with the handle of the device, so that the two kinds of keys never match.
+ */
+void write_descriptor_set_key(CacheKey &key, const DescriptorSetLayout &descriptor_set_layout, const SetBindings &set_bindings)
 {
-	write(os, value.size());
-	os.write(reinterpret_cast<const char *>(value.data()), value.size() * sizeof(T));
+	key.clear();
+
+	key.write(VkDevice{VK_NULL_HANDLE});
+	key.write(descriptor_set_layout.get_handle());
+
+	auto &resource_bindings = set_bindings.get_resource_bindings();
+
+	key.write(resource_bindings.size());
+
+	detail::for_each_sorted_set(resource_bindings, [&](uint32_t binding_index, const std::map<uint32_t, ResourceInfo> &binding_resources) {
+		VkDescriptorSetLayoutBinding binding_info{};
+
+		bool dynamic = descriptor_set_layout.get_layout_binding(binding_index, binding_info) && is_dynamic_buffer(binding_info);
+
+		key.write(binding_index);
+		key.write(binding_resources.size());
+
+		for (auto &element_it : binding_resources)
+		{
+			auto &resource_info = element_it.second;
+
+			key.write(element_it.first);
+			key.write(resource_info.is_buffer());
+
+			if (resource_info.is_buffer())
+			{
+				VkDescriptorBufferInfo buffer_info = resource_info.get_buffer_info();
+
+				// The offset of dynamic buffers is given when binding the set, so that the set is shared
+				if (dynamic && element_it.first < binding_info.descriptorCount)
+				{
+					buffer_info.offset = 0;
+				}
+
+				key.write(buffer_info.buffer);
+				key.write(buffer_info.offset);
+				key.write(buffer_info.range);
+			}
+			else
+			{
+				VkDescriptorImageInfo image_info = resource_info.get_image_info();
+
+				key.write(image_info.imageView);
+				key.write(image_info.sampler);
+			}
+		}
+	});
 }
 
-template <class T, uint32_t N>
-inline void write(std::ostringstream &os, const std::array<T, N> &value)
+/**
+ * @brief Gathers the descriptor infos a set is written with, from the resources bound to it
+ *        which have a binding in its layout
+ */
+void get_descriptor_infos(const DescriptorSetLayout &         descriptor_set_layout,
+                          const SetBindings &                 set_bindings,
+                          BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                          BindingMap<VkDescriptorImageInfo> & image_infos)
 {
-	os.write(reinterpret_cast<const char *>(value.data()), N * sizeof(T));
+	// Iterate over all resource bindings
+	for (auto &binding_it : set_bindings.get_resource_bindings())
+	{
+		auto  binding_index     = binding_it.first;
+		auto &binding_resources = binding_it.second;
+
+		VkDescriptorSetLayoutBinding binding_info;
+
+		// Check if binding exists in the pipeline layout
+		if (!descriptor_set_layout.get_layout_binding(binding_index, binding_info))
+		{
+			continue;
+		}
+
+		bool dynamic = is_dynamic_buffer(binding_info);
+
+		// Iterate over all binding resources
+		for (auto &element_it : binding_resources)
+		{
+			auto  arrayElement  = element_it.first;
+			auto &resource_info = element_it.second;
+
+			// Get buffer info
+			if (resource_info.is_buffer())
+			{
+				VkDescriptorBufferInfo buffer_info = resource_info.get_buffer_info();
+
+				// The offset of dynamic buffers is given when binding the set, so that the set is shared
+				if (dynamic && arrayElement < binding_info.descriptorCount)
+				{
+					buffer_info.offset = 0;
+				}
+
+				buffer_infos[binding_index][arrayElement] = buffer_info;
+			}
+			// Get image info
+			else if (resource_info.is_image_only() || resource_info.is_sampler_only() || resource_info.is_image_sampler())
+			{
+				VkDescriptorImageInfo image_info = resource_info.get_image_info();
+
+				if (resource_info.is_image_only() || resource_info.is_image_sampler())
+				{
+					const vkb::ImageView &image_view = resource_info.get_image_view();
+
+					// Add iamge layout info based on descriptor type
+					switch (binding_info.descriptorType)
+					{
+						case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+						case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+							if (is_depth_stencil_format(image_view.get_format()))
+							{
+								image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+							}
+							else
+							{
+								image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+							}
+							break;
+
+						case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+							image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+							break;
+
+						default:
+							continue;
+					}
+				}
+
+				image_infos[binding_index][arrayElement] = std::move(image_info);
+			}
+		}
+	}
 }
 
-template <typename T, typename... Args>
-inline void write(std::ostringstream &os, const T &first_arg, const Args &... args)
-{
-	write(os, first_arg);
+const VkAccessFlags write_access_mask = VK_ACCESS_SHADER_WRITE_BIT |
+                                        VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                                        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                        VK_ACCESS_TRANSFER_WRITE_BIT |
+                                        VK_ACCESS_HOST_WRITE_BIT |
+                                        VK_ACCESS_MEMORY_WRITE_BIT;
 
-	write(os, args...);
+bool is_same_access(const ImageAccess &lhs, const ImageAccess &rhs)
+{
+	return lhs.layout == rhs.layout && lhs.stage_mask == rhs.stage_mask && lhs.access_mask == rhs.access_mask;
 }
 }        // namespace
 
-CommandRecord::CommandRecord(Device &device) :
-    device{device}
+CommandRecord::CommandRecord(Device &device, RenderFrame *render_frame, size_t thread_index) :
+    device{device},
+    render_frame{render_frame},
+    thread_index{thread_index},
+    resource_epoch{device.get_resource_epoch()}
 {}
 
 void CommandRecord::reset()
 {
-	// Clear stream content
-	stream.str("");
+	// Clear the commands, keeping the memory for the next frame
+	commands.reset();
 
 	graphics_pipeline_state.reset();
 	resource_binding_state.reset();
 
 	render_pass_bindings.clear();
 	descriptor_set_bindings.clear();
+	dynamic_offsets.clear();
+	transient_descriptor_sets.clear();
 	descriptor_set_layout_state.clear();
+	bound_descriptor_sets.clear();
 	pipeline_bindings.clear();
+	image_accesses.clear();
+
+	descriptor_set_bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	pipeline_bind_point       = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	compute_pipeline_layout   = nullptr;
+	compute_pipeline          = nullptr;
+	compute_pipeline_dirty    = false;
+
+	secondary             = false;
+	inheritance           = {};
+	secondary_thread_pool = nullptr;
+
+	pipeline_desc_count = 0;
+
+	last_draw_indirect_end = std::numeric_limits<size_t>::max();
+
+	pipelines_pending = false;
+
+	resource_epoch = device.get_resource_epoch();
 }
 
 Device &CommandRecord::get_device()
@@ -81,9 +237,9 @@ Device &CommandRecord::get_device()
 	return device;
 }
 
-const std::ostringstream &CommandRecord::get_stream() const
+const CommandArena &CommandRecord::get_commands() const
 {
-	return stream;
+	return commands;
 }
 
 const std::vector<RenderPassBinding> &CommandRecord::get_render_pass_bindings() const
@@ -101,16 +257,59 @@ const std::vector<DescriptorSetBinding> &CommandRecord::get_descriptor_set_bindi
 	return descriptor_set_bindings;
 }
 
+const std::vector<uint32_t> &CommandRecord::get_dynamic_offsets() const
+{
+	return dynamic_offsets;
+}
+
+bool CommandRecord::is_valid() const
+{
+	return resource_epoch == device.get_resource_epoch() && !pipelines_pending && transient_descriptor_sets.empty();
+}
+
+void CommandRecord::set_async_pipeline_compilation(bool enable, const FallbackPipelineFunc &fallback_pipeline_func)
+{
+	async_pipeline_compilation = enable;
+
+	this->fallback_pipeline_func = fallback_pipeline_func;
+}
+
 void CommandRecord::begin(VkCommandBufferUsageFlags flags)
 {
 	// Write command parameters
-	write(stream, CommandType::Begin, flags);
+	commands.write(CommandType::Begin, BeginCommand{flags});
+}
+
+void CommandRecord::begin_secondary(VkCommandBufferUsageFlags flags, const CommandRecord &primary_recorder)
+{
+	secondary = true;
+
+	inheritance.subpass_index = primary_recorder.graphics_pipeline_state.get_subpass_index();
+
+	graphics_pipeline_state.set_subpass_index(inheritance.subpass_index);
+
+	// Pipelines are compiled the same way as the primary's
+	async_pipeline_compilation = primary_recorder.async_pipeline_compilation;
+	fallback_pipeline_func     = primary_recorder.fallback_pipeline_func;
+
+	// Write command parameters
+	commands.write(CommandType::Begin, BeginCommand{flags | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT});
+}
+
+bool CommandRecord::is_secondary() const
+{
+	return secondary;
+}
+
+const InheritanceDesc &CommandRecord::get_inheritance() const
+{
+	return inheritance;
 }
 
 void CommandRecord::end()
 {
 	// Write command parameters
-	write(stream, CommandType::End);
+	commands.write(CommandType::End);
 }
 
 void vkb::CommandRecord::begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values)
@@ -118,12 +317,12 @@ void vkb::CommandRecord::begin_render_pass(const RenderTarget &render_target, co
 	// Reset graphics pipeline state
 	graphics_pipeline_state.reset();
 
-	RenderPassBinding render_pass_binding{stream.tellp(), render_target};
+	RenderPassBinding render_pass_binding{commands.get_size(), render_target};
 	render_pass_binding.load_store_infos = load_store_infos;
 	render_pass_binding.clear_values     = clear_values;
 
 	// Add first subpass to render pass
-	render_pass_binding.subpasses.push_back(SubpassDesc{stream.tellp()});
+	render_pass_binding.subpasses.push_back(SubpassDesc{commands.get_size()});
 
 	// Add render pass
 	render_pass_bindings.push_back(render_pass_binding);
@@ -134,8 +333,11 @@ void CommandRecord::next_subpass()
 	// Increment subpass index
 	graphics_pipeline_state.set_subpass_index(graphics_pipeline_state.get_subpass_index() + 1);
 
+	// Add next subpass to render pass
+	render_pass_bindings.back().subpasses.push_back(SubpassDesc{commands.get_size()});
+
 	// Write command parameters
-	write(stream, CommandType::NextSubpass);
+	commands.write(CommandType::NextSubpass);
 }
 
 void CommandRecord::end_render_pass()
@@ -151,48 +353,134 @@ void CommandRecord::end_render_pass()
 		subpass.input_attachments  = subpass_it->input_attachments;
 		subpass.output_attachments = subpass_it->output_attachments;
 
+		// Add the attachments used by the secondary command buffers
+		for (CommandBuffer *secondary_command_buffer : subpass_it->secondary_command_buffers)
+		{
+			auto &secondary_subpass = secondary_command_buffer->get_recorder().get_inheritance().subpass;
+
+			subpass.input_attachments.insert(secondary_subpass.input_attachments.begin(), secondary_subpass.input_attachments.end());
+			subpass.output_attachments.insert(secondary_subpass.output_attachments.begin(), secondary_subpass.output_attachments.end());
+		}
+
 		++subpass_it;
 	}
 
+	// Attachments are left in the layout of the last subpass using them
+	const auto &views = render_pass_desc.render_target.get_views();
+
+	for (uint32_t i = 0U; i < views.size(); ++i)
+	{
+		const core::Image &image = views[i].get_image();
+
+		if (is_depth_stencil_format(image.get_format()))
+		{
+			set_image_access(image, views[i].get_subresource_range(), get_image_access(ImageUsage::DepthStencilAttachment, image.get_format()));
+			continue;
+		}
+
+		auto last_subpass_it = std::find_if(subpasses.rbegin(), subpasses.rend(), [i](const SubpassInfo &subpass) {
+			return subpass.input_attachments.count(i) > 0 || subpass.output_attachments.count(i) > 0;
+		});
+
+		if (last_subpass_it == subpasses.rend())
+		{
+			// The contents of attachments unused by all subpasses are not preserved
+			set_image_access(image, views[i].get_subresource_range(), {VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT});
+		}
+		else if (last_subpass_it->input_attachments.count(i) > 0)
+		{
+			set_image_access(image, views[i].get_subresource_range(), get_image_access(ImageUsage::FragmentShaderRead, image.get_format()));
+		}
+		else
+		{
+			set_image_access(image, views[i].get_subresource_range(), get_image_access(ImageUsage::ColorAttachment, image.get_format()));
+		}
+	}
+
 	render_pass_desc.render_pass = &device.request_render_pass(render_pass_desc.render_target.get_attachments(), render_pass_desc.load_store_infos, subpasses);
 	render_pass_desc.framebuffer = &device.request_framebuffer(render_pass_desc.render_target, *render_pass_desc.render_pass);
 
 	// Iterate over each graphics state that was bound within the subpass
 	for (SubpassDesc &subpassDesc : render_pass_desc.subpasses)
 	{
-		for (auto &pipeline_state : subpassDesc.pipeline_states)
-		{
-			pipeline_state.graphics_pipeline_state.set_render_pass(*render_pass_desc.render_pass);
+		request_pipelines(subpassDesc.pipeline_states, *render_pass_desc.render_pass);
+	}
 
-			auto &pipeline = device.request_graphics_pipeline(pipeline_state.graphics_pipeline_state, {});
+	std::vector<std::shared_future<void>> secondary_replays;
 
-			pipeline_bindings.push_back({pipeline_state.event_id, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline});
+	for (SubpassDesc &subpassDesc : render_pass_desc.subpasses)
+	{
+		// Replay the secondary command buffers, now that the render pass they continue is known
+		for (CommandBuffer *secondary_command_buffer : subpassDesc.secondary_command_buffers)
+		{
+			auto replay = [secondary_command_buffer, &render_pass_desc]() {
+				secondary_command_buffer->get_recorder().resolve_inheritance(*render_pass_desc.render_pass, *render_pass_desc.framebuffer);
+				secondary_command_buffer->replay();
+			};
+
+			if (secondary_thread_pool)
+			{
+				secondary_replays.push_back(secondary_thread_pool->dispatch(replay));
+			}
+			else
+			{
+				replay();
+			}
 		}
 	}
 
+	// Rethrows the errors of the replay, once no worker uses the render pass anymore
+	ThreadPool::wait_all(secondary_replays);
+
+	secondary_thread_pool = nullptr;
+
 	// Write command parameters
-	write(stream, CommandType::EndRenderPass);
+	commands.write(CommandType::EndRenderPass);
 }
 
 void CommandRecord::bind_pipeline_layout(PipelineLayout &pipeline_layout)
 {
+	pipeline_bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
 	graphics_pipeline_state.set_pipeline_layout(pipeline_layout);
 }
 
+void CommandRecord::bind_compute_pipeline(PipelineLayout &pipeline_layout, const SpecializationInfo &specialization_info)
+{
+	pipeline_bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;
+
+	// Compute pipelines do not depend on a render pass, so they are requested right away
+	const ComputePipeline &pipeline = device.request_compute_pipeline(pipeline_layout, specialization_info);
+
+	if (&pipeline != compute_pipeline)
+	{
+		compute_pipeline        = &pipeline;
+		compute_pipeline_layout = &pipeline_layout;
+		compute_pipeline_dirty  = true;
+	}
+}
+
 void CommandRecord::push_constants(uint32_t offset, const std::vector<uint8_t> &values)
 {
-	const PipelineLayout &pipeline_layout = graphics_pipeline_state.get_pipeline_layout();
+	push_constants(offset, values.data(), to_u32(values.size()));
+}
+
+void CommandRecord::push_constants(uint32_t offset, const uint8_t *values, uint32_t size)
+{
+	const PipelineLayout &pipeline_layout = get_pipeline_layout();
 
-	VkShaderStageFlags shader_stage = pipeline_layout.get_push_constant_range_stage(offset, values.size());
+	VkShaderStageFlags shader_stage = pipeline_layout.get_push_constant_range_stage(offset, size);
 
 	if (shader_stage)
 	{
 		// Write command parameters
-		write(stream, CommandType::PushConstants, pipeline_layout.get_handle(), shader_stage, offset, values);
+		auto &command = commands.write(CommandType::PushConstants, PushConstantsCommand{pipeline_layout.get_handle(), shader_stage, offset, size}, size);
+
+		std::copy(values, values + size, CommandArena::get_data<uint8_t>(command));
 	}
 	else
 	{
-		LOGW("Push constant range [%d, %lu] not found", offset, values.size());
+		LOGW("Push constant range [%d, %d] not found", offset, size);
 	}
 }
 
@@ -206,20 +494,48 @@ void CommandRecord::bind_image(const ImageView &image_view, VkSampler sampler, u
 	resource_binding_state.bind_image(image_view, sampler, set, binding, array_element);
 }
 
+void CommandRecord::bind_descriptor_set(uint32_t set, const DescriptorSet &descriptor_set)
+{
+	bound_descriptor_sets[set] = &descriptor_set;
+
+	// Forget the layout bound for the set, so that the next draw binds it
+	descriptor_set_layout_state.erase(set);
+}
+
 void CommandRecord::bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::Buffer>> &buffers, const std::vector<VkDeviceSize> &offsets)
 {
-	std::vector<VkBuffer> native_buffers(buffers.size(), VK_NULL_HANDLE);
-	std::transform(buffers.begin(), buffers.end(), native_buffers.begin(),
+	// Write command parameters, followed by the buffer handles and offsets
+	auto &command = commands.write(CommandType::BindVertexBuffers,
+	                               BindVertexBuffersCommand{first_binding, to_u32(buffers.size())},
+	                               buffers.size() * (sizeof(VkBuffer) + sizeof(VkDeviceSize)));
+
+	VkBuffer *native_buffers = CommandArena::get_data<VkBuffer>(command);
+
+	std::transform(buffers.begin(), buffers.end(), native_buffers,
 	               [](const core::Buffer &buffer) { return buffer.get_handle(); });
 
-	// Write command parameters
-	write(stream, CommandType::BindVertexBuffers, first_binding, native_buffers, offsets);
+	std::copy(offsets.begin(), offsets.end(), reinterpret_cast<VkDeviceSize *>(native_buffers + buffers.size()));
+}
+
+void CommandRecord::bind_vertex_buffers(uint32_t first_binding, uint32_t binding_count, const core::Buffer *const *buffers, const VkDeviceSize *offsets)
+{
+	// Write command parameters, followed by the buffer handles and offsets
+	auto &command = commands.write(CommandType::BindVertexBuffers,
+	                               BindVertexBuffersCommand{first_binding, binding_count},
+	                               binding_count * (sizeof(VkBuffer) + sizeof(VkDeviceSize)));
+
+	VkBuffer *native_buffers = CommandArena::get_data<VkBuffer>(command);
+
+	std::transform(buffers, buffers + binding_count, native_buffers,
+	               [](const core::Buffer *buffer) { return buffer->get_handle(); });
+
+	std::copy(offsets, offsets + binding_count, reinterpret_cast<VkDeviceSize *>(native_buffers + binding_count));
 }
 
 void CommandRecord::bind_index_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkIndexType index_type)
 {
 	// Write command parameters
-	write(stream, CommandType::BindIndexBuffer, buffer.get_handle(), offset, index_type);
+	commands.write(CommandType::BindIndexBuffer, BindIndexBufferCommand{buffer.get_handle(), offset, index_type});
 }
 
 void CommandRecord::set_viewport_state(const ViewportState &state_info)
@@ -258,39 +574,53 @@ void CommandRecord::set_color_blend_state(const ColorBlendState &state_info)
 }
 
 void CommandRecord::set_viewport(uint32_t first_viewport, const std::vector<VkViewport> &viewports)
+{
+	set_viewport(first_viewport, to_u32(viewports.size()), viewports.data());
+}
+
+void CommandRecord::set_viewport(uint32_t first_viewport, uint32_t viewport_count, const VkViewport *viewports)
 {
 	// Write command parameters
-	write(stream, CommandType::SetViewport, first_viewport, viewports);
+	auto &command = commands.write(CommandType::SetViewport, SetViewportCommand{first_viewport, viewport_count}, viewport_count * sizeof(VkViewport));
+
+	std::copy(viewports, viewports + viewport_count, CommandArena::get_data<VkViewport>(command));
 }
 
 void CommandRecord::set_scissor(uint32_t first_scissor, const std::vector<VkRect2D> &scissors)
+{
+	set_scissor(first_scissor, to_u32(scissors.size()), scissors.data());
+}
+
+void CommandRecord::set_scissor(uint32_t first_scissor, uint32_t scissor_count, const VkRect2D *scissors)
 {
 	// Write command parameters
-	write(stream, CommandType::SetScissor, first_scissor, scissors);
+	auto &command = commands.write(CommandType::SetScissor, SetScissorCommand{first_scissor, scissor_count}, scissor_count * sizeof(VkRect2D));
+
+	std::copy(scissors, scissors + scissor_count, CommandArena::get_data<VkRect2D>(command));
 }
 
 void CommandRecord::set_line_width(float line_width)
 {
 	// Write command parameters
-	write(stream, CommandType::SetLineWidth, line_width);
+	commands.write(CommandType::SetLineWidth, SetLineWidthCommand{line_width});
 }
 
 void CommandRecord::set_depth_bias(float depth_bias_constant_factor, float depth_bias_clamp, float depth_bias_slope_factor)
 {
 	// Write command parameters
-	write(stream, CommandType::SetDepthBias, depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor);
+	commands.write(CommandType::SetDepthBias, SetDepthBiasCommand{depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor});
 }
 
 void CommandRecord::set_blend_constants(const std::array<float, 4> &blend_constants)
 {
 	// Write command parameters
-	write(stream, CommandType::SetBlendConstants, blend_constants);
+	commands.write(CommandType::SetBlendConstants, SetBlendConstantsCommand{{blend_constants[0], blend_constants[1], blend_constants[2], blend_constants[3]}});
 }
 
 void CommandRecord::set_depth_bounds(float min_depth_bounds, float max_depth_bounds)
 {
 	// Write command parameters
-	write(stream, CommandType::SetDepthBounds, min_depth_bounds, max_depth_bounds);
+	commands.write(CommandType::SetDepthBounds, SetDepthBoundsCommand{min_depth_bounds, max_depth_bounds});
 }
 
 void CommandRecord::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t first_vertex, uint32_t first_instance)
@@ -300,7 +630,7 @@ void CommandRecord::draw(uint32_t vertex_count, uint32_t instance_count, uint32_
 	FlushDescriptorState();
 
 	// Write command parameters
-	write(stream, CommandType::Draw, vertex_count, instance_count, first_vertex, first_instance);
+	commands.write(CommandType::Draw, DrawCommand{vertex_count, instance_count, first_vertex, first_instance});
 }
 
 void CommandRecord::draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance)
@@ -310,35 +640,382 @@ void CommandRecord::draw_indexed(uint32_t index_count, uint32_t instance_count,
 	FlushDescriptorState();
 
 	// Write command parameters
-	write(stream, CommandType::DrawIndexed, index_count, instance_count, first_index, vertex_offset, first_instance);
+	commands.write(CommandType::DrawIndexed, DrawIndexedCommand{index_count, instance_count, first_index, vertex_offset, first_instance});
+}
+
+void CommandRecord::draw_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
+{
+	FlushPipelineState();
+
+	FlushDescriptorState();
+
+	write_draw_indirect(CommandType::DrawIndirect, DrawIndirectCommand{buffer.get_handle(), offset, draw_count, stride}, sizeof(VkDrawIndirectCommand));
+}
+
+void CommandRecord::draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
+{
+	FlushPipelineState();
+
+	FlushDescriptorState();
+
+	write_draw_indirect(CommandType::DrawIndexedIndirect, DrawIndirectCommand{buffer.get_handle(), offset, draw_count, stride}, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+void CommandRecord::write_draw_indirect(CommandType type, const DrawIndirectCommand &command, uint32_t min_stride)
+{
+	size_t event_id = commands.get_size();
+
+	// Bindings are replayed at the offset of the next command, so a binding added since the
+	// last indirect draw would apply after it once merged
+	bool binding_added = (!render_pass_bindings.empty() && (render_pass_bindings.back().event_id == event_id ||
+	                                                        render_pass_bindings.back().subpasses.back().event_id == event_id)) ||
+	                     (pipeline_desc_count > 0 && pipeline_descs[pipeline_desc_count - 1].event_id == event_id) ||
+	                     (!pipeline_bindings.empty() && pipeline_bindings.back().event_id == event_id) ||
+	                     (!descriptor_set_bindings.empty() && descriptor_set_bindings.back().event_id == event_id);
+
+	if (last_draw_indirect_end == event_id && !binding_added &&
+	    command.stride >= min_stride && command.stride % 4 == 0)
+	{
+		CommandHeader &header = commands.get_header(last_draw_indirect);
+
+		auto &last_command = CommandArena::get_command<DrawIndirectCommand>(header);
+
+		if (header.type == type &&
+		    last_command.buffer == command.buffer &&
+		    last_command.stride == command.stride &&
+		    last_command.offset + VkDeviceSize{last_command.draw_count} * last_command.stride == command.offset)
+		{
+			last_command.draw_count += command.draw_count;
+			return;
+		}
+	}
+
+	last_draw_indirect = event_id;
+
+	// Write command parameters
+	commands.write(type, command);
+
+	last_draw_indirect_end = commands.get_size();
+}
+
+void CommandRecord::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
+{
+	FlushComputePipelineState();
+
+	FlushDescriptorState();
+
+	// Write command parameters
+	commands.write(CommandType::Dispatch, DispatchCommand{group_count_x, group_count_y, group_count_z});
+}
+
+void CommandRecord::dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset)
+{
+	FlushComputePipelineState();
+
+	FlushDescriptorState();
+
+	// Write command parameters
+	commands.write(CommandType::DispatchIndirect, DispatchIndirectCommand{buffer.get_handle(), offset});
 }
 
 void CommandRecord::update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data)
+{
+	update_buffer(buffer, offset, data.data(), to_u32(data.size()));
+}
+
+void CommandRecord::update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, uint32_t size)
 {
 	// Write command parameters
-	write(stream, CommandType::UpdateBuffer, buffer.get_handle(), offset, data);
+	auto &command = commands.write(CommandType::UpdateBuffer, UpdateBufferCommand{buffer.get_handle(), offset, size}, size);
+
+	std::copy(data, data + size, CommandArena::get_data<uint8_t>(command));
 }
 
 void CommandRecord::copy_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageCopy> &regions)
 {
 	// Write command parameters
-	write(stream, CommandType::CopyImage, src_img.get_handle(), dst_img.get_handle(), regions);
+	auto &command = commands.write(CommandType::CopyImage, CopyImageCommand{src_img.get_handle(), dst_img.get_handle(), to_u32(regions.size())}, regions.size() * sizeof(VkImageCopy));
+
+	std::copy(regions.begin(), regions.end(), CommandArena::get_data<VkImageCopy>(command));
+}
+
+void CommandRecord::copy_buffer(const core::Buffer &src_buffer, const core::Buffer &dst_buffer, const std::vector<VkBufferCopy> &regions)
+{
+	// Write command parameters
+	auto &command = commands.write(CommandType::CopyBuffer, CopyBufferCommand{src_buffer.get_handle(), dst_buffer.get_handle(), to_u32(regions.size())}, regions.size() * sizeof(VkBufferCopy));
+
+	std::copy(regions.begin(), regions.end(), CommandArena::get_data<VkBufferCopy>(command));
 }
 
 void CommandRecord::copy_buffer_to_image(const core::Buffer &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions)
 {
 	// Write command parameters
-	write(stream, CommandType::CopyBufferToImage, buffer.get_handle(), image.get_handle(), regions);
+	auto &command = commands.write(CommandType::CopyBufferToImage, CopyBufferToImageCommand{buffer.get_handle(), image.get_handle(), to_u32(regions.size())}, regions.size() * sizeof(VkBufferImageCopy));
+
+	std::copy(regions.begin(), regions.end(), CommandArena::get_data<VkBufferImageCopy>(command));
 }
 
 void CommandRecord::image_memory_barrier(const ImageView &image_view, const ImageMemoryBarrier &memory_barrier)
 {
+	const core::Image &image = image_view.get_image();
+
+	// Keep track of the image access for the barriers derived later
+	set_image_access(image, image_view.get_subresource_range(), {memory_barrier.new_layout, memory_barrier.dst_stage_mask, memory_barrier.dst_access_mask});
+
 	// Write command parameters
-	write(stream, CommandType::ImageMemoryBarrier, image_view.get_image().get_handle(), image_view.get_subresource_range(), memory_barrier);
+	commands.write(CommandType::ImageMemoryBarrier, ImageMemoryBarrierCommand{image.get_handle(), image_view.get_subresource_range(), memory_barrier});
+}
+
+void CommandRecord::transition_image(const ImageView &image_view, ImageUsage usage, bool discard_contents)
+{
+	const core::Image &image = image_view.get_image();
+
+	const ImageAccess &src_access = image.get_access();
+
+	ImageAccess dst_access = get_image_access(usage, image.get_format());
+
+	// Reads in the same layout do not depend on each other, but later writes must wait for all of them
+	if (src_access.layout == dst_access.layout &&
+	    !(src_access.access_mask & write_access_mask) &&
+	    !(dst_access.access_mask & write_access_mask))
+	{
+		set_image_access(image, image_view.get_subresource_range(), {dst_access.layout, src_access.stage_mask | dst_access.stage_mask, src_access.access_mask | dst_access.access_mask});
+		return;
+	}
+
+	ImageMemoryBarrier memory_barrier{};
+	memory_barrier.old_layout      = discard_contents ? VK_IMAGE_LAYOUT_UNDEFINED : src_access.layout;
+	memory_barrier.new_layout      = dst_access.layout;
+	memory_barrier.src_stage_mask  = src_access.stage_mask;
+	memory_barrier.dst_stage_mask  = dst_access.stage_mask;
+	memory_barrier.src_access_mask = src_access.access_mask & write_access_mask;
+	memory_barrier.dst_access_mask = dst_access.access_mask;
+
+	image_memory_barrier(image_view, memory_barrier);
+}
+
+void CommandRecord::append(const CommandRecord &stream)
+{
+	if (!stream.transient_descriptor_sets.empty())
+	{
+		throw std::runtime_error("Cannot append commands using descriptor sets released with their frame");
+	}
+
+	if (stream.pipelines_pending)
+	{
+		throw std::runtime_error("Cannot append commands using pipelines still being compiled");
+	}
+
+	if (!stream.is_valid())
+	{
+		throw std::runtime_error("Cannot append commands referencing destroyed resources");
+	}
+
+	for (auto &render_pass_binding : stream.render_pass_bindings)
+	{
+		for (auto &subpass : render_pass_binding.subpasses)
+		{
+			if (!subpass.secondary_command_buffers.empty())
+			{
+				throw std::runtime_error("Cannot append commands executing secondary command buffers");
+			}
+		}
+	}
+
+	// The barriers of the stream were derived from the accesses of its images when it was recorded,
+	// so the images are first brought from their current access to the one the stream started from.
+	// Streams starting from an undefined layout discard the contents with their own first barrier.
+	for (auto &image_access : stream.image_accesses)
+	{
+		const ImageAccess &src_access = image_access.image->get_access();
+		const ImageAccess &dst_access = image_access.first_access;
+
+		if (dst_access.layout == VK_IMAGE_LAYOUT_UNDEFINED || is_same_access(src_access, dst_access))
+		{
+			continue;
+		}
+
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout      = src_access.layout;
+		memory_barrier.new_layout      = dst_access.layout;
+		memory_barrier.src_stage_mask  = src_access.stage_mask;
+		memory_barrier.dst_stage_mask  = dst_access.stage_mask;
+		memory_barrier.src_access_mask = src_access.access_mask & write_access_mask;
+		memory_barrier.dst_access_mask = dst_access.access_mask;
+
+		commands.write(CommandType::ImageMemoryBarrier, ImageMemoryBarrierCommand{image_access.image->get_handle(), image_access.subresource_range, memory_barrier});
+	}
+
+	// Event ids of the stream are offsets in its own arena
+	size_t base_event_id = commands.get_size();
+
+	commands.append(stream.commands);
+
+	// The images are left as the stream leaves them
+	for (auto &image_access : stream.image_accesses)
+	{
+		set_image_access(*image_access.image, image_access.subresource_range, image_access.last_access);
+	}
+
+	for (auto &render_pass_binding : stream.render_pass_bindings)
+	{
+		render_pass_bindings.push_back(render_pass_binding);
+
+		auto &appended_binding = render_pass_bindings.back();
+		appended_binding.event_id += base_event_id;
+
+		for (auto &subpass : appended_binding.subpasses)
+		{
+			subpass.event_id += base_event_id;
+
+			// The graphics states of the stream are copied to this recorder
+			for (auto &pipeline_state : subpass.pipeline_states)
+			{
+				auto &pipeline_desc = stream.pipeline_descs[pipeline_state];
+
+				pipeline_state = add_pipeline_desc(pipeline_desc.event_id + base_event_id, pipeline_desc.graphics_pipeline_state);
+			}
+		}
+	}
+
+	for (auto &pipeline_binding : stream.pipeline_bindings)
+	{
+		pipeline_bindings.push_back({pipeline_binding.event_id + base_event_id, pipeline_binding.pipeline_bind_point, pipeline_binding.pipeline});
+	}
+
+	uint32_t base_dynamic_offset_index = to_u32(dynamic_offsets.size());
+
+	dynamic_offsets.insert(dynamic_offsets.end(), stream.dynamic_offsets.begin(), stream.dynamic_offsets.end());
+
+	for (auto &descriptor_set_binding : stream.descriptor_set_bindings)
+	{
+		descriptor_set_bindings.push_back({descriptor_set_binding.event_id + base_event_id,
+		                                   descriptor_set_binding.pipeline_bind_point,
+		                                   descriptor_set_binding.pipeline_layout,
+		                                   descriptor_set_binding.set_index,
+		                                   descriptor_set_binding.descriptor_set,
+		                                   descriptor_set_binding.dynamic_offset_index + base_dynamic_offset_index,
+		                                   descriptor_set_binding.dynamic_offset_count});
+	}
+
+	// The descriptor sets bound by the stream replace those tracked by this recorder
+	resource_binding_state.reset();
+	descriptor_set_layout_state.clear();
+	bound_descriptor_sets.clear();
+
+	// The stream may have bound another compute pipeline
+	compute_pipeline_dirty = compute_pipeline != nullptr;
+}
+
+void CommandRecord::set_image_access(const core::Image &image, const VkImageSubresourceRange &subresource_range, const ImageAccess &access)
+{
+	auto it = std::find_if(image_accesses.begin(), image_accesses.end(), [&image](const ImageAccessDesc &image_access) {
+		return image_access.image == &image;
+	});
+
+	if (it == image_accesses.end())
+	{
+		image_accesses.push_back({&image, subresource_range, image.get_access(), access});
+	}
+	else
+	{
+		it->last_access = access;
+	}
+
+	image.set_access(access);
+}
+
+void CommandRecord::buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
+{
+	// Write command parameters
+	commands.write(CommandType::BufferMemoryBarrier, BufferMemoryBarrierCommand{buffer.get_handle(), offset, size, memory_barrier});
+}
+
+void CommandRecord::execute_commands(const std::vector<CommandBuffer *> &secondary_command_buffers, ThreadPool *thread_pool)
+{
+	SubpassDesc &subpass = get_current_subpass();
+
+	subpass.contents = VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS;
+
+	subpass.secondary_command_buffers.insert(subpass.secondary_command_buffers.end(), secondary_command_buffers.begin(), secondary_command_buffers.end());
+
+	secondary_thread_pool = thread_pool;
+
+	// Write command parameters, followed by the command buffer handles
+	auto &command = commands.write(CommandType::ExecuteCommands,
+	                               ExecuteCommandsCommand{to_u32(secondary_command_buffers.size())},
+	                               secondary_command_buffers.size() * sizeof(VkCommandBuffer));
+
+	std::transform(secondary_command_buffers.begin(), secondary_command_buffers.end(), CommandArena::get_data<VkCommandBuffer>(command),
+	               [](const CommandBuffer *command_buffer) { return command_buffer->get_handle(); });
+}
+
+SubpassDesc &CommandRecord::get_current_subpass()
+{
+	if (secondary)
+	{
+		return inheritance.subpass;
+	}
+
+	return render_pass_bindings.back().subpasses.back();
+}
+
+void CommandRecord::request_pipelines(const std::vector<size_t> &pipeline_states, const RenderPass &render_pass)
+{
+	for (size_t pipeline_state_index : pipeline_states)
+	{
+		auto &pipeline_state = pipeline_descs[pipeline_state_index];
+
+		pipeline_state.graphics_pipeline_state.set_render_pass(render_pass);
+
+		const Pipeline *pipeline = nullptr;
+
+		if (async_pipeline_compilation)
+		{
+			pipeline = device.request_graphics_pipeline_async(pipeline_state.graphics_pipeline_state, {});
+
+			// Draw with the fallback until the pipeline is compiled
+			if (!pipeline)
+			{
+				pipelines_pending = true;
+
+				if (fallback_pipeline_func)
+				{
+					pipeline = fallback_pipeline_func(pipeline_state.graphics_pipeline_state);
+				}
+			}
+		}
+		else
+		{
+			pipeline = &device.request_graphics_pipeline(pipeline_state.graphics_pipeline_state, {});
+		}
+
+		pipeline_bindings.push_back({pipeline_state.event_id, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline});
+	}
+}
+
+void CommandRecord::resolve_inheritance(const RenderPass &render_pass, const Framebuffer &framebuffer)
+{
+	inheritance.render_pass = &render_pass;
+	inheritance.framebuffer = &framebuffer;
+
+	request_pipelines(inheritance.subpass.pipeline_states, render_pass);
+}
+
+PipelineLayout &CommandRecord::get_pipeline_layout()
+{
+	if (pipeline_bind_point == VK_PIPELINE_BIND_POINT_COMPUTE)
+	{
+		return *compute_pipeline_layout;
+	}
+
+	return const_cast<PipelineLayout &>(graphics_pipeline_state.get_pipeline_layout());
 }
 
 void CommandRecord::FlushPipelineState()
 {
+	pipeline_bind_point = VK_PIPELINE_BIND_POINT_GRAPHICS;
+
 	// Create a new pipeline in the command stream only if the graphics state changed
 	if (!graphics_pipeline_state.is_dirty())
 	{
@@ -350,10 +1027,10 @@ void CommandRecord::FlushPipelineState()
 
 	const PipelineLayout &pipeline_layout = graphics_pipeline_state.get_pipeline_layout();
 
-	SubpassDesc &subpass = render_pass_bindings.back().subpasses.back();
+	SubpassDesc &subpass = get_current_subpass();
 
 	// Add graphics state to the current subpass
-	subpass.pipeline_states.push_back({stream.tellp(), graphics_pipeline_state});
+	subpass.pipeline_states.push_back(add_pipeline_desc(commands.get_size(), graphics_pipeline_state));
 
 	const auto &resources = pipeline_layout.get_fragment_output_attachments();
 
@@ -372,13 +1049,61 @@ void CommandRecord::FlushPipelineState()
 	}
 }
 
+size_t CommandRecord::add_pipeline_desc(size_t event_id, const GraphicsPipelineState &state)
+{
+	if (pipeline_desc_count == pipeline_descs.size())
+	{
+		pipeline_descs.emplace_back();
+	}
+
+	// Assigning the state reuses the memory of the one recorded at this index before
+	PipelineDesc &pipeline_desc = pipeline_descs[pipeline_desc_count];
+
+	pipeline_desc.event_id                = event_id;
+	pipeline_desc.graphics_pipeline_state = state;
+
+	return pipeline_desc_count++;
+}
+
+void CommandRecord::FlushComputePipelineState()
+{
+	pipeline_bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;
+
+	// Bind the compute pipeline only if it changed
+	if (!compute_pipeline_dirty)
+	{
+		return;
+	}
+
+	compute_pipeline_dirty = false;
+
+	pipeline_bindings.push_back({commands.get_size(), VK_PIPELINE_BIND_POINT_COMPUTE, compute_pipeline});
+}
+
 void CommandRecord::FlushDescriptorState()
 {
-	PipelineLayout &pipeline_layout = const_cast<PipelineLayout &>(graphics_pipeline_state.get_pipeline_layout());
+	PipelineLayout &pipeline_layout = get_pipeline_layout();
 
 	const auto &set_bindings = pipeline_layout.get_bindings();
 
-	std::unordered_set<uint32_t> update_sets;
+	update_sets.clear();
+
+	auto is_update_set = [this](uint32_t set) {
+		return std::find(update_sets.begin(), update_sets.end(), set) != update_sets.end();
+	};
+
+	// Descriptor sets are bound separately for each bind point, so switching binds all of them again
+	if (pipeline_bind_point != descriptor_set_bind_point)
+	{
+		descriptor_set_bind_point = pipeline_bind_point;
+
+		descriptor_set_layout_state.clear();
+
+		for (auto &set_it : set_bindings)
+		{
+			update_sets.push_back(set_it.first);
+		}
+	}
 
 	// Iterate over pipeline layout sets
 	for (auto &set_it : set_bindings)
@@ -389,9 +1114,10 @@ void CommandRecord::FlushDescriptorState()
 		if (descriptor_set_layout_it != descriptor_set_layout_state.end())
 		{
 			// Add set to later update it if is different from the current pipeline layout's set
-			if (descriptor_set_layout_it->second->get_handle() != pipeline_layout.get_set_layout(set_it.first).get_handle())
+			if (descriptor_set_layout_it->second->get_handle() != pipeline_layout.get_set_layout(set_it.first).get_handle() &&
+			    !is_update_set(set_it.first))
 			{
-				update_sets.emplace(set_it.first);
+				update_sets.push_back(set_it.first);
 			}
 		}
 	}
@@ -410,6 +1136,27 @@ void CommandRecord::FlushDescriptorState()
 		}
 	}
 
+	// Bind the sets given by the caller which are not bound yet, or were bound with another pipeline layout
+	for (auto &set_it : bound_descriptor_sets)
+	{
+		if (!pipeline_layout.has_set_layout(set_it.first))
+		{
+			continue;
+		}
+
+		if (descriptor_set_layout_state.find(set_it.first) != descriptor_set_layout_state.end() &&
+		    !is_update_set(set_it.first))
+		{
+			continue;
+		}
+
+		update_sets.erase(std::remove(update_sets.begin(), update_sets.end(), set_it.first), update_sets.end());
+
+		descriptor_set_layout_state[set_it.first] = &pipeline_layout.get_set_layout(set_it.first);
+
+		descriptor_set_bindings.push_back({commands.get_size(), pipeline_bind_point, pipeline_layout, set_it.first, *set_it.second, to_u32(dynamic_offsets.size()), 0});
+	}
+
 	// Check if descriptor set needs to be created
 	if (resource_binding_state.is_dirty() || !update_sets.empty())
 	{
@@ -417,10 +1164,10 @@ void CommandRecord::FlushDescriptorState()
 		resource_binding_state.clear_dirty();
 
 		// Iterate over all set bindings
-		for (auto set_it : resource_binding_state.get_set_bindings())
+		for (auto &set_it : resource_binding_state.get_set_bindings())
 		{
 			// Skip if set bindings don't have changes
-			if (!set_it.second.is_dirty() && (update_sets.find(set_it.first) == update_sets.end()))
+			if (!set_it.second.is_dirty() && !is_update_set(set_it.first))
 			{
 				continue;
 			}
@@ -428,8 +1175,9 @@ void CommandRecord::FlushDescriptorState()
 			// Clear dirty flag for binding set
 			resource_binding_state.clear_dirty(set_it.first);
 
-			// Skip set layout if it doesn't exists
-			if (!pipeline_layout.has_set_layout(set_it.first))
+			// Skip set layout if it doesn't exists, or if the set was given by the caller
+			if (!pipeline_layout.has_set_layout(set_it.first) ||
+			    bound_descriptor_sets.find(set_it.first) != bound_descriptor_sets.end())
 			{
 				continue;
 			}
@@ -439,75 +1187,76 @@ void CommandRecord::FlushDescriptorState()
 			// Make descriptor set layout bound for current set
 			descriptor_set_layout_state[set_it.first] = &descriptor_set_layout;
 
-			BindingMap<VkDescriptorBufferInfo> buffer_infos;
-			BindingMap<VkDescriptorImageInfo>  image_infos;
+			const SetBindings &bindings = set_it.second;
 
-			// Iterate over all resource bindings
-			for (auto &binding_it : set_it.second.get_resource_bindings())
-			{
-				auto  binding_index     = binding_it.first;
-				auto &binding_resources = binding_it.second;
+			// Hash of the descriptors written to the set, maintained as resources are bound
+			uint64_t bindings_hash = bindings.get_hash() ^ bindings.get_offset_hash();
 
-				VkDescriptorSetLayoutBinding binding_info;
+			uint32_t dynamic_offset_index = to_u32(dynamic_offsets.size());
 
-				// Check if binding exists in the pipeline layout
-				if (!descriptor_set_layout.get_layout_binding(binding_index, binding_info))
+			// Dynamic offsets are given in binding order, then in array element order
+			for (auto &binding_info : descriptor_set_layout.get_bindings())
+			{
+				if (!is_dynamic_buffer(binding_info))
 				{
 					continue;
 				}
 
-				// Iterate over all binding resources
-				for (auto &element_it : binding_resources)
+				auto binding_it = bindings.get_resource_bindings().find(binding_info.binding);
+
+				for (uint32_t array_element = 0; array_element < binding_info.descriptorCount; ++array_element)
 				{
-					auto  arrayElement  = element_it.first;
-					auto &resource_info = element_it.second;
+					uint32_t dynamic_offset = 0;
 
-					// Get buffer info
-					if (resource_info.is_buffer())
+					if (binding_it != bindings.get_resource_bindings().end())
 					{
-						buffer_infos[binding_index][arrayElement] = resource_info.get_buffer_info();
-					}
-					// Get image info
-					else if (resource_info.is_image_only() || resource_info.is_sampler_only() || resource_info.is_image_sampler())
-					{
-						VkDescriptorImageInfo image_info = resource_info.get_image_info();
+						auto element_it = binding_it->second.find(array_element);
 
-						if (resource_info.is_image_only() || resource_info.is_image_sampler())
+						if (element_it != binding_it->second.end() && element_it->second.is_buffer())
 						{
-							const vkb::ImageView &image_view = resource_info.get_image_view();
+							dynamic_offset = to_u32(element_it->second.get_buffer_info().offset);
 
-							// Add iamge layout info based on descriptor type
-							switch (binding_info.descriptorType)
-							{
-								case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
-								case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
-									if (is_depth_stencil_format(image_view.get_format()))
-									{
-										image_info.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
-									}
-									else
-									{
-										image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-									}
-									break;
-
-								case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
-									image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-									break;
-
-								default:
-									continue;
-							}
+							// The offset is not written to the set, so it does not identify it
+							bindings_hash ^= element_it->second.get_offset_hash(binding_info.binding, array_element);
 						}
-
-						image_infos[binding_index][arrayElement] = std::move(image_info);
 					}
+
+					dynamic_offsets.push_back(dynamic_offset);
 				}
 			}
 
-			auto &descriptor_set = device.request_descriptor_set(descriptor_set_layout, buffer_infos, image_infos);
+			uint32_t dynamic_offset_count = to_u32(dynamic_offsets.size()) - dynamic_offset_index;
+
+			const DescriptorSet *descriptor_set{nullptr};
+
+			if (render_frame && render_frame->get_descriptor_management() == DescriptorManagement::Transient)
+			{
+				BindingMap<VkDescriptorBufferInfo> buffer_infos;
+				BindingMap<VkDescriptorImageInfo>  image_infos;
+
+				get_descriptor_infos(descriptor_set_layout, bindings, buffer_infos, image_infos);
+
+				// Written once for this frame, and released with the other sets of the frame when it is reset
+				transient_descriptor_sets.emplace_back(device, descriptor_set_layout, render_frame->get_descriptor_pool(thread_index), buffer_infos, image_infos);
+
+				descriptor_set = &transient_descriptor_sets.back();
+			}
+			else
+			{
+				write_descriptor_set_key(descriptor_set_key, descriptor_set_layout, bindings);
+
+				// The descriptor infos are only gathered if the set is not cached yet
+				descriptor_set = &device.request_descriptor_set(descriptor_set_layout, bindings_hash, descriptor_set_key, [&]() {
+					BindingMap<VkDescriptorBufferInfo> buffer_infos;
+					BindingMap<VkDescriptorImageInfo>  image_infos;
+
+					get_descriptor_infos(descriptor_set_layout, bindings, buffer_infos, image_infos);
+
+					return DescriptorSet{device, descriptor_set_layout, buffer_infos, image_infos};
+				});
+			}
 
-			descriptor_set_bindings.push_back({stream.tellp(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, set_it.first, descriptor_set});
+			descriptor_set_bindings.push_back({commands.get_size(), pipeline_bind_point, pipeline_layout, set_it.first, *descriptor_set, dynamic_offset_index, dynamic_offset_count});
 		}
 	}
 }
@@ -20,10 +20,12 @@
 
 #pragma once
 
-#include <list>
+#include <deque>
+#include <limits>
 
 #include "common.h"
 
+#include "command_arena.h"
 #include "core/descriptor_set.h"
 #include "core/framebuffer.h"
 #include "core/image_view.h"
@@ -31,12 +33,17 @@
 #include "core/pipeline_layout.h"
 #include "core/render_pass.h"
 #include "graphics_pipeline_state.h"
+#include "platform/thread_pool.h"
 #include "render_target.h"
 #include "resource_binding_state.h"
 
+#include "cache_resource.h"
+
 namespace vkb
 {
+class CommandBuffer;
 class RenderContext;
+class RenderFrame;
 
 /*
  * @brief Temporary pipeline descriptor structure for a drawcall 
@@ -44,7 +51,7 @@ class RenderContext;
  */
 struct PipelineDesc
 {
-	std::streampos event_id{};
+	size_t event_id{0};
 
 	GraphicsPipelineState graphics_pipeline_state;
 };
@@ -55,13 +62,53 @@ struct PipelineDesc
  */
 struct SubpassDesc
 {
-	std::streampos event_id{};
+	size_t event_id{0};
 
 	std::set<uint32_t> input_attachments;
 
 	std::set<uint32_t> output_attachments;
 
-	std::list<PipelineDesc> pipeline_states;
+	/// Indices of the graphics states bound in the subpass, in the pipeline states of the recorder
+	std::vector<size_t> pipeline_states;
+
+	/// Whether the commands of the subpass are recorded inline or in secondary command buffers
+	VkSubpassContents contents{VK_SUBPASS_CONTENTS_INLINE};
+
+	std::vector<CommandBuffer *> secondary_command_buffers;
+};
+
+/*
+ * @brief Render pass state inherited by a secondary command buffer from the
+ *        primary command buffer executing it. The render pass and framebuffer
+ *        are only known once the primary command buffer ends the render pass.
+ */
+struct InheritanceDesc
+{
+	uint32_t subpass_index{0};
+
+	SubpassDesc subpass;
+
+	const RenderPass *render_pass{nullptr};
+
+	const Framebuffer *framebuffer{nullptr};
+};
+
+/*
+ * @brief Accesses of an image by the commands of a recorder, from which
+ *        the barrier needed to append them to another recorder is derived.
+ */
+struct ImageAccessDesc
+{
+	const core::Image *image;
+
+	/// Subresources of the view first used by the commands
+	VkImageSubresourceRange subresource_range;
+
+	/// Access the commands expect the image to be in, tracked before they first used it
+	ImageAccess first_access;
+
+	/// Access the commands leave the image in
+	ImageAccess last_access;
 };
 
 /*
@@ -69,7 +116,7 @@ struct SubpassDesc
  */
 struct RenderPassBinding
 {
-	std::streampos event_id;
+	size_t event_id;
 
 	const RenderTarget &render_target;
 
@@ -86,22 +133,31 @@ struct RenderPassBinding
 
 /*
  * @brief Pipeline binding structure to be used during command replay.
+ *        The pipeline is null if it is still being compiled, in which
+ *        case the draws using it are skipped.
  */
 struct PipelineBinding
 {
-	std::streampos event_id;
+	size_t event_id;
 
 	VkPipelineBindPoint pipeline_bind_point;
 
-	const Pipeline &pipeline;
+	const Pipeline *pipeline;
 };
 
+/*
+ * @brief Returns a pipeline to draw with while the pipeline of the given state is
+ *        being compiled, or nullptr to skip the draws. The returned pipeline must be
+ *        compatible with the render pass, subpass and pipeline layout of the state.
+ */
+using FallbackPipelineFunc = std::function<const Pipeline *(const GraphicsPipelineState &)>;
+
 /*
  * @brief Descriptor set binding structure to be used during command replay.
  */
 struct DescriptorSetBinding
 {
-	std::streampos event_id;
+	size_t event_id;
 
 	VkPipelineBindPoint pipeline_bind_point;
 
@@ -110,56 +166,32 @@ struct DescriptorSetBinding
 	uint32_t set_index;
 
 	const DescriptorSet &descriptor_set;
-};
 
-enum class CommandType
-{
-	Begin,
-	End,
-	BeginRenderPass,
-	NextSubpass,
-	EndRenderPass,
-	BindPipelineLayout,
-	PushConstants,
-	BindBuffer,
-	BindImage,
-	BindVertexBuffers,
-	BindIndexBuffer,
-	SetVertexInputFormat,
-	SetViewportState,
-	SetInputAssemblyState,
-	SetRasterizationState,
-	SetMultisampleState,
-	SetDepthStencilState,
-	SetColorBlendState,
-	SetViewport,
-	SetScissor,
-	SetLineWidth,
-	SetDepthBias,
-	SetBlendConstants,
-	SetDepthBounds,
-	Draw,
-	DrawIndexed,
-	UpdateBuffer,
-	CopyImage,
-	CopyBufferToImage,
-	ImageMemoryBarrier
+	/// Index of the first dynamic offset of the set in the dynamic offsets of the recorder
+	uint32_t dynamic_offset_index;
+
+	uint32_t dynamic_offset_count;
 };
 
 /*
- * @brief Writes Vulkan commands in a memory stream while building 
+ * @brief Writes Vulkan commands in a command arena while building 
  *        Vulkan pipelines and descriptor sets for each draw only if state changes.
  */
 class CommandRecord
 {
   public:
-	CommandRecord(Device &device);
+	/**
+	 * @param device A valid Vulkan device
+	 * @param render_frame Frame the commands are recorded for, if any, which provides the transient descriptor sets
+	 * @param thread_index Index of the recording thread, selecting the resources of the frame it uses
+	 */
+	CommandRecord(Device &device, RenderFrame *render_frame = nullptr, size_t thread_index = 0);
 
 	void reset();
 
 	Device &get_device();
 
-	const std::ostringstream &get_stream() const;
+	const CommandArena &get_commands() const;
 
 	const std::vector<RenderPassBinding> &get_render_pass_bindings() const;
 
@@ -167,8 +199,40 @@ class CommandRecord
 
 	const std::vector<DescriptorSetBinding> &get_descriptor_set_bindings() const;
 
+	/*
+	 * @return The dynamic offsets of all descriptor set bindings, stored contiguously
+	 *         so that binding a set with dynamic offsets does not allocate
+	 */
+	const std::vector<uint32_t> &get_dynamic_offsets() const;
+
+	/*
+	 * @return False if a resource the commands may reference was destroyed since the recording
+	 *         started, if a pipeline was still being compiled when the render pass ended, or if
+	 *         the descriptor sets are released with the frame. The commands must then be
+	 *         recorded again before being appended.
+	 */
+	bool is_valid() const;
+
+	/*
+	 * @brief Enables the asynchronous compilation of graphics pipelines.
+	 *        Pipelines missing from the cache are compiled in the background instead of
+	 *        blocking end_render_pass, and meanwhile their draws use the fallback pipeline.
+	 * @param fallback_pipeline_func Provides the pipeline used in the meantime, if empty the draws are skipped
+	 */
+	void set_async_pipeline_compilation(bool enable, const FallbackPipelineFunc &fallback_pipeline_func = {});
+
 	void begin(VkCommandBufferUsageFlags flags);
 
+	/*
+	 * @brief Begins recording secondary commands, which continue
+	 *        the current subpass of the primary recorder
+	 */
+	void begin_secondary(VkCommandBufferUsageFlags flags, const CommandRecord &primary_recorder);
+
+	bool is_secondary() const;
+
+	const InheritanceDesc &get_inheritance() const;
+
 	void end();
 
 	void begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values);
@@ -179,14 +243,38 @@ class CommandRecord
 
 	void bind_pipeline_layout(PipelineLayout &pipeline_layout);
 
+	/*
+	 * @brief Binds a compute pipeline for the next dispatches, which are recorded outside of
+	 *        render passes. Push constants and resources then use the compute pipeline layout,
+	 *        until a graphics pipeline layout is bound.
+	 */
+	void bind_compute_pipeline(PipelineLayout &pipeline_layout, const SpecializationInfo &specialization_info);
+
 	void push_constants(uint32_t offset, const std::vector<uint8_t> &values);
 
+	/*
+	 * @brief Pointer and count overload, which copies the values straight into the command stream
+	 */
+	void push_constants(uint32_t offset, const uint8_t *values, uint32_t size);
+
 	void bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element);
 
 	void bind_image(const ImageView &image_view, VkSampler sampler, uint32_t set, uint32_t binding, uint32_t array_element);
 
+	/*
+	 * @brief Binds a descriptor set written by the caller, such as a bindless texture table,
+	 *        in place of the resources bound to the set index. It stays bound until the recorder
+	 *        is reset, and must be compatible with the set layout of the pipeline layouts used.
+	 */
+	void bind_descriptor_set(uint32_t set, const DescriptorSet &descriptor_set);
+
 	void bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::Buffer>> &buffers, const std::vector<VkDeviceSize> &offsets);
 
+	/*
+	 * @brief Pointer and count overload, which copies the buffers and offsets straight into the command stream
+	 */
+	void bind_vertex_buffers(uint32_t first_binding, uint32_t binding_count, const core::Buffer *const *buffers, const VkDeviceSize *offsets);
+
 	void bind_index_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkIndexType index_type);
 
 	void set_viewport_state(const ViewportState &state_info);
@@ -205,8 +293,12 @@ class CommandRecord
 
 	void set_viewport(uint32_t first_viewport, const std::vector<VkViewport> &viewports);
 
+	void set_viewport(uint32_t first_viewport, uint32_t viewport_count, const VkViewport *viewports);
+
 	void set_scissor(uint32_t first_scissor, const std::vector<VkRect2D> &scissors);
 
+	void set_scissor(uint32_t first_scissor, uint32_t scissor_count, const VkRect2D *scissors);
+
 	void set_line_width(float line_width);
 
 	void set_depth_bias(float depth_bias_constant_factor, float depth_bias_clamp, float depth_bias_slope_factor);
@@ -219,33 +311,178 @@ class CommandRecord
 
 	void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance);
 
+	/*
+	 * @brief Draws with parameters read from a buffer of VkDrawIndirectCommand. It is merged with
+	 *        the previous indirect draw if that one read the parameters right before these, from
+	 *        the same buffer and with the same stride, and no state changed in between.
+	 * @param draw_count Number of draws, replayed as a single call when multiDrawIndirect is enabled
+	 * @param stride Bytes between the parameters of consecutive draws
+	 */
+	void draw_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride);
+
+	/*
+	 * @brief Draws with parameters read from a buffer of VkDrawIndexedIndirectCommand,
+	 *        merged with the previous indirect draw in the same way as draw_indirect
+	 * @param draw_count Number of draws, replayed as a single call when multiDrawIndirect is enabled
+	 * @param stride Bytes between the parameters of consecutive draws
+	 */
+	void draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride);
+
+	void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
+
+	void dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset);
+
 	void update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data);
 
+	void update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, uint32_t size);
+
 	void copy_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageCopy> &regions);
 
+	void copy_buffer(const core::Buffer &src_buffer, const core::Buffer &dst_buffer, const std::vector<VkBufferCopy> &regions);
+
 	void copy_buffer_to_image(const core::Buffer &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions);
 
 	void image_memory_barrier(const ImageView &image_view, const ImageMemoryBarrier &memory_barrier);
 
+	/*
+	 * @brief Declares how an image is about to be used, recording the barrier from its tracked
+	 *        access if one is needed. Render passes leave their attachments in the layout of
+	 *        their last subpass, so images are transitioned before a render pass uses them.
+	 * @param discard_contents Whether the previous contents can be discarded, such as for
+	 *        attachments which are cleared
+	 */
+	void transition_image(const ImageView &image_view, ImageUsage usage, bool discard_contents);
+
+	void buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier);
+
+	/*
+	 * @brief Appends the commands of another recorder, with their resolved render passes, pipelines
+	 *        and descriptor sets, so that content which does not change between frames is recorded
+	 *        once and replayed by the command buffers of later frames.
+	 *        The commands must be made of whole render passes, without begin, end or secondary
+	 *        command buffers, and are appended outside of a render pass. As they reference the
+	 *        render target they were recorded with, a stream is recorded for each render frame.
+	 *        The bound resources are reset afterwards, as the commands may have bound others.
+	 *        A barrier brings each image used by the stream from its tracked access to the
+	 *        one it had when the stream was recorded, and the image is then tracked with
+	 *        the access the stream leaves it in.
+	 * @param stream A valid recorder, which is only read
+	 */
+	void append(const CommandRecord &stream);
+
+	/*
+	 * @brief Executes secondary command buffers in the current subpass, which must not contain
+	 *        inline commands. They are replayed when the render pass ends, as the render pass
+	 *        they continue is only created then.
+	 * @param thread_pool If not null, the secondary command buffers are replayed in parallel on it
+	 */
+	void execute_commands(const std::vector<CommandBuffer *> &secondary_command_buffers, ThreadPool *thread_pool = nullptr);
+
   private:
 	Device &device;
 
-	std::ostringstream stream;
+	RenderFrame *render_frame{nullptr};
+
+	size_t thread_index{0};
+
+	CommandArena commands;
 
 	std::vector<RenderPassBinding> render_pass_bindings;
 
 	std::vector<DescriptorSetBinding> descriptor_set_bindings;
 
+	std::vector<uint32_t> dynamic_offsets;
+
+	/// Descriptor sets written for the frame, when it does not use the sets cached by the device
+	std::deque<DescriptorSet> transient_descriptor_sets;
+
+	/// Key of the descriptor set being requested, reused so that requests do not allocate
+	CacheKey descriptor_set_key;
+
 	std::vector<PipelineBinding> pipeline_bindings;
 
+	/// Images used by the commands, with the access they were first and last tracked with
+	std::vector<ImageAccessDesc> image_accesses;
+
 	GraphicsPipelineState graphics_pipeline_state;
 
 	ResourceBindingState resource_binding_state;
 
 	std::unordered_map<uint32_t, DescriptorSetLayout *> descriptor_set_layout_state;
 
+	/// Descriptor sets bound by the caller, which take precedence over the resources bound to their set index
+	std::unordered_map<uint32_t, const DescriptorSet *> bound_descriptor_sets;
+
+	/// Bind point of the descriptor sets last bound, which are not bound for the other one
+	VkPipelineBindPoint descriptor_set_bind_point{VK_PIPELINE_BIND_POINT_GRAPHICS};
+
+	/// Bind point of the pipeline layout used by push constants and resources
+	VkPipelineBindPoint pipeline_bind_point{VK_PIPELINE_BIND_POINT_GRAPHICS};
+
+	PipelineLayout *compute_pipeline_layout{nullptr};
+
+	const ComputePipeline *compute_pipeline{nullptr};
+
+	/// Whether the compute pipeline changed since the last dispatch
+	bool compute_pipeline_dirty{false};
+
+	bool async_pipeline_compilation{false};
+
+	FallbackPipelineFunc fallback_pipeline_func;
+
+	/// Graphics states bound by the draws, kept across resets so that their storage is reused
+	std::vector<PipelineDesc> pipeline_descs;
+
+	/// Number of graphics states of the current recording in pipeline_descs
+	size_t pipeline_desc_count{0};
+
+	/// Sets to bind again when flushing the descriptor state, kept to reuse its storage
+	std::vector<uint32_t> update_sets;
+
+	/// Offset of the last indirect draw packet, which following draws may be merged into
+	size_t last_draw_indirect{0};
+
+	/// Size of the commands after the last indirect draw, which only matches while nothing was recorded since
+	size_t last_draw_indirect_end{std::numeric_limits<size_t>::max()};
+
+	/// Whether draws use the fallback pipeline, or are skipped, until their pipeline is compiled
+	bool pipelines_pending{false};
+
+	/// Resource epoch of the device when the recording started
+	uint64_t resource_epoch{0};
+
+	bool secondary{false};
+
+	InheritanceDesc inheritance;
+
+	/// Pool replaying the secondary command buffers executed in the current render pass
+	ThreadPool *secondary_thread_pool{nullptr};
+
+	/// Returns the subpass being recorded, which is inherited by secondary recorders
+	SubpassDesc &get_current_subpass();
+
+	/// Requests the pipelines of the states bound in a subpass, and adds their bindings
+	void request_pipelines(const std::vector<size_t> &pipeline_states, const RenderPass &render_pass);
+
+	/// Adds a graphics state bound by a draw, reusing the storage of the previous recordings
+	size_t add_pipeline_desc(size_t event_id, const GraphicsPipelineState &state);
+
+	/// Requests the pipelines of a secondary recorder, once the primary created the render pass
+	void resolve_inheritance(const RenderPass &render_pass, const Framebuffer &framebuffer);
+
+	/// Updates the tracked access of an image, remembering the access it had before the commands used it
+	void set_image_access(const core::Image &image, const VkImageSubresourceRange &subresource_range, const ImageAccess &access);
+
+	/// Writes an indirect draw, or adds its draws to the previous one when they can be replayed together
+	void write_draw_indirect(CommandType type, const DrawIndirectCommand &command, uint32_t min_stride);
+
+	/// Returns the pipeline layout of the current bind point
+	PipelineLayout &get_pipeline_layout();
+
 	void FlushPipelineState();
 
+	void FlushComputePipelineState();
+
 	void FlushDescriptorState();
 };
 }        // namespace vkb
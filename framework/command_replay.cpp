@@ -20,69 +20,118 @@
 
 #include "command_replay.h"
 
+#include <limits>
+
 #include "core/command_buffer.h"
 #include "core/descriptor_set.h"
+#include "core/device.h"
 
 namespace vkb
 {
 namespace
 {
-template <typename T>
-inline void read(std::istringstream &is, T &value)
+/**
+ * @brief Calls an indirect draw function for all the draws of a command, in as few
+ *        calls as the multiDrawIndirect feature and the maxDrawIndirectCount limit allow
+ */
+template <typename DrawFunc>
+void draw_indirect_batches(CommandBuffer &command_buffer, const DrawIndirectCommand &command, DrawFunc draw_func)
 {
-	is.read(reinterpret_cast<char *>(&value), sizeof(T));
+	Device &device = command_buffer.get_device();
+
+	uint32_t max_draw_count = 1;
+
+	if (device.get_features().multiDrawIndirect)
+	{
+		max_draw_count = std::max(1U, device.get_properties().limits.maxDrawIndirectCount);
+	}
+
+	VkDeviceSize offset = command.offset;
+
+	for (uint32_t first_draw = 0; first_draw < command.draw_count; first_draw += max_draw_count)
+	{
+		uint32_t draw_count = std::min(max_draw_count, command.draw_count - first_draw);
+
+		// Call Vulkan function
+		draw_func(command_buffer.get_handle(), command.buffer, offset, draw_count, command.stride);
+
+		offset += static_cast<VkDeviceSize>(draw_count) * command.stride;
+	}
 }
 
-template <class T>
-inline void read(std::istringstream &is, std::vector<T> &value)
+/**
+ * @brief Checks whether two ranges overlap, a range whose size is remaining_size extending to the end
+ */
+bool ranges_overlap(uint64_t offset_a, uint64_t size_a, uint64_t offset_b, uint64_t size_b, uint64_t remaining_size)
 {
-	std::size_t size;
-	read(is, size);
-	value.resize(size);
-	is.read(reinterpret_cast<char *>(value.data()), value.size() * sizeof(T));
+	uint64_t end_a = size_a == remaining_size ? std::numeric_limits<uint64_t>::max() : offset_a + size_a;
+	uint64_t end_b = size_b == remaining_size ? std::numeric_limits<uint64_t>::max() : offset_b + size_b;
+
+	return offset_a < end_b && offset_b < end_a;
 }
 
-template <class T, uint32_t N>
-inline void read(std::istringstream &is, std::array<T, N> &value)
+bool barriers_overlap(const VkImageMemoryBarrier &barrier_a, const VkImageMemoryBarrier &barrier_b)
 {
-	is.read(reinterpret_cast<char *>(value.data()), N * sizeof(T));
+	const VkImageSubresourceRange &range_a = barrier_a.subresourceRange;
+	const VkImageSubresourceRange &range_b = barrier_b.subresourceRange;
+
+	return barrier_a.image == barrier_b.image &&
+	       (range_a.aspectMask & range_b.aspectMask) != 0 &&
+	       ranges_overlap(range_a.baseMipLevel, range_a.levelCount, range_b.baseMipLevel, range_b.levelCount, VK_REMAINING_MIP_LEVELS) &&
+	       ranges_overlap(range_a.baseArrayLayer, range_a.layerCount, range_b.baseArrayLayer, range_b.layerCount, VK_REMAINING_ARRAY_LAYERS);
 }
 
-template <typename T, typename... Args>
-inline void read(std::istringstream &is, T &first_arg, Args &... args)
+bool barriers_overlap(const VkBufferMemoryBarrier &barrier_a, const VkBufferMemoryBarrier &barrier_b)
 {
-	read(is, first_arg);
+	return barrier_a.buffer == barrier_b.buffer &&
+	       ranges_overlap(barrier_a.offset, barrier_a.size, barrier_b.offset, barrier_b.size, VK_WHOLE_SIZE);
+}
 
-	read(is, args...);
+/**
+ * @brief Checks whether a barrier applies to a range already used by one of the merged barriers.
+ *        The barriers of a pipeline barrier are not ordered, so it must wait for the previous one.
+ */
+template <typename T>
+bool overlaps_any(const std::vector<T> &barriers, const T &barrier)
+{
+	return std::any_of(barriers.begin(), barriers.end(), [&barrier](const T &merged_barrier) { return barriers_overlap(merged_barrier, barrier); });
 }
 }        // namespace
 
-CommandReplay::CommandReplay()
-{
-	stream_commands[CommandType::Begin]              = std::bind(&CommandReplay::begin, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::End]                = std::bind(&CommandReplay::end, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::NextSubpass]        = std::bind(&CommandReplay::next_subpass, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::EndRenderPass]      = std::bind(&CommandReplay::end_render_pass, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::PushConstants]      = std::bind(&CommandReplay::push_constants, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::BindVertexBuffers]  = std::bind(&CommandReplay::bind_vertex_buffers, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::BindIndexBuffer]    = std::bind(&CommandReplay::bind_index_buffer, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::SetViewport]        = std::bind(&CommandReplay::set_viewport, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::SetScissor]         = std::bind(&CommandReplay::set_scissor, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::SetLineWidth]       = std::bind(&CommandReplay::set_line_width, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::SetDepthBias]       = std::bind(&CommandReplay::set_depth_bias, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::SetBlendConstants]  = std::bind(&CommandReplay::set_blend_constants, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::SetDepthBounds]     = std::bind(&CommandReplay::set_depth_bounds, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::Draw]               = std::bind(&CommandReplay::draw, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::DrawIndexed]        = std::bind(&CommandReplay::draw_indexed, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::UpdateBuffer]       = std::bind(&CommandReplay::update_buffer, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::CopyImage]          = std::bind(&CommandReplay::copy_image, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::CopyBufferToImage]  = std::bind(&CommandReplay::copy_buffer_to_image, *this, std::placeholders::_1, std::placeholders::_2);
-	stream_commands[CommandType::ImageMemoryBarrier] = std::bind(&CommandReplay::image_memory_barrier, *this, std::placeholders::_1, std::placeholders::_2);
+void CommandReplay::BoundState::reset()
+{
+	pipeline = VK_NULL_HANDLE;
+
+	vertex_buffers.fill(VK_NULL_HANDLE);
+	vertex_buffer_offsets.fill(0);
+
+	index_buffer        = VK_NULL_HANDLE;
+	index_buffer_offset = 0;
+	index_type          = VK_INDEX_TYPE_MAX_ENUM;
+
+	viewports.clear();
+	scissors.clear();
+
+	push_constant_layout = VK_NULL_HANDLE;
+	push_constants.clear();
+	push_constant_stages.clear();
+
+	descriptor_set_layout     = VK_NULL_HANDLE;
+	descriptor_set_bind_point = VK_PIPELINE_BIND_POINT_MAX_ENUM;
+	descriptor_sets.clear();
 }
 
 void CommandReplay::play(CommandBuffer &command_buffer, CommandRecord &recorder)
 {
-	std::istringstream stream{recorder.get_stream().str()};
+	const CommandArena &commands = recorder.get_commands();
+
+	// A command buffer starts without any state bound
+	bound_state.reset();
+
+	stats = {};
+
+	image_memory_barriers.clear();
+	buffer_memory_barriers.clear();
 
 	// Get the first render pass to bind
 	auto render_pass_binding_it = recorder.get_render_pass_bindings().cbegin();
@@ -93,10 +142,29 @@ void CommandReplay::play(CommandBuffer &command_buffer, CommandRecord &recorder)
 	// Get the first descriptor set to bind
 	auto descriptor_set_binding_it = recorder.get_descriptor_set_bindings().cbegin();
 
+	// Draws are skipped while the bound graphics pipeline is being compiled
+	bool pipeline_bound = false;
+
+	// Offset of the current command, used as event id
+	size_t event_id = 0;
+
+	// Render pass being replayed, to know the contents of its subpasses
+	const RenderPassBinding *render_pass_binding = nullptr;
+
+	uint32_t subpass_index = 0;
+
 	while (true)
 	{
-		// Get current event id
-		std::streampos event_id = stream.tellg();
+		// Merge barriers until the next command is not a barrier
+		if (!image_memory_barriers.empty() || !buffer_memory_barriers.empty())
+		{
+			CommandType next_type = event_id < commands.get_size() ? commands.get_header(event_id).type : CommandType::End;
+
+			if (next_type != CommandType::ImageMemoryBarrier && next_type != CommandType::BufferMemoryBarrier)
+			{
+				flush_barriers(command_buffer);
+			}
+		}
 
 		// Check to see if there are any render passes left
 		if (render_pass_binding_it != recorder.get_render_pass_bindings().cend())
@@ -112,8 +180,11 @@ void CommandReplay::play(CommandBuffer &command_buffer, CommandRecord &recorder)
 				begin_info.clearValueCount   = to_u32(render_pass_binding_it->clear_values.size());
 				begin_info.pClearValues      = render_pass_binding_it->clear_values.data();
 
+				render_pass_binding = &*render_pass_binding_it;
+				subpass_index       = 0;
+
 				// Begin render pass
-				vkCmdBeginRenderPass(command_buffer.get_handle(), &begin_info, VK_SUBPASS_CONTENTS_INLINE);
+				vkCmdBeginRenderPass(command_buffer.get_handle(), &begin_info, render_pass_binding->subpasses[subpass_index].contents);
 
 				// Move to the next render pass
 				++render_pass_binding_it;
@@ -126,10 +197,17 @@ void CommandReplay::play(CommandBuffer &command_buffer, CommandRecord &recorder)
 			// The next pipeline binding's event id must be equal to the current read position.
 			if (pipeline_binding_it->event_id == event_id)
 			{
+				// Compute pipelines are never compiled asynchronously
+				if (pipeline_binding_it->pipeline_bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+				{
+					pipeline_bound = pipeline_binding_it->pipeline != nullptr;
+				}
+
 				// Bind pipeline.
-				vkCmdBindPipeline(command_buffer.get_handle(),
-				                  pipeline_binding_it->pipeline_bind_point,
-				                  pipeline_binding_it->pipeline.get_handle());
+				if (pipeline_binding_it->pipeline != nullptr)
+				{
+					bind_pipeline(command_buffer, *pipeline_binding_it);
+				}
 
 				// Move to the next pipeline binding
 				++pipeline_binding_it;
@@ -142,15 +220,7 @@ void CommandReplay::play(CommandBuffer &command_buffer, CommandRecord &recorder)
 			// The next descriptor set binding's event id must be equal to the current read position.
 			while (descriptor_set_binding_it->event_id == event_id)
 			{
-				VkDescriptorSet descriptor_set = descriptor_set_binding_it->descriptor_set.get_handle();
-
-				// Bind descriptor set
-				vkCmdBindDescriptorSets(command_buffer.get_handle(),
-				                        descriptor_set_binding_it->pipeline_bind_point,
-				                        descriptor_set_binding_it->pipeline_layout.get_handle(),
-				                        descriptor_set_binding_it->set_index,
-				                        1, &descriptor_set,
-				                        0, nullptr);
+				bind_descriptor_set(command_buffer, recorder, *descriptor_set_binding_it);
 
 				// Move to the next descriptor set binding
 				if (++descriptor_set_binding_it == recorder.get_descriptor_set_bindings().cend())
@@ -160,266 +230,519 @@ void CommandReplay::play(CommandBuffer &command_buffer, CommandRecord &recorder)
 			}
 		}
 
-		// Read command id
-		CommandType cmd;
-		read(stream, cmd);
-
-		if (stream.eof())
+		if (event_id >= commands.get_size())
 		{
 			break;
 		}
 
-		// Find command function for the given command id
-		auto cmd_it = stream_commands.find(cmd);
+		const CommandHeader &header = commands.get_header(event_id);
 
-		// Check if command replayer supports the given command
-		if (cmd_it != stream_commands.end())
-		{
-			// Run command function
-			stream_commands.at(cmd)(command_buffer, stream);
-		}
-		else
+		// Move to the next command
+		event_id += header.size;
+
+		++stats.command_count;
+
+		switch (header.type)
 		{
-			LOGE("Replay command not supported.");
+			case CommandType::Begin:
+				begin(command_buffer, recorder, CommandArena::get_command<BeginCommand>(header));
+				break;
+			case CommandType::End:
+				end(command_buffer);
+				break;
+			case CommandType::NextSubpass:
+				next_subpass(command_buffer, render_pass_binding->subpasses[++subpass_index].contents);
+				break;
+			case CommandType::EndRenderPass:
+				end_render_pass(command_buffer);
+				break;
+			case CommandType::PushConstants:
+				push_constants(command_buffer, CommandArena::get_command<PushConstantsCommand>(header));
+				break;
+			case CommandType::BindVertexBuffers:
+				bind_vertex_buffers(command_buffer, CommandArena::get_command<BindVertexBuffersCommand>(header));
+				break;
+			case CommandType::BindIndexBuffer:
+				bind_index_buffer(command_buffer, CommandArena::get_command<BindIndexBufferCommand>(header));
+				break;
+			case CommandType::SetViewport:
+				set_viewport(command_buffer, CommandArena::get_command<SetViewportCommand>(header));
+				break;
+			case CommandType::SetScissor:
+				set_scissor(command_buffer, CommandArena::get_command<SetScissorCommand>(header));
+				break;
+			case CommandType::SetLineWidth:
+				set_line_width(command_buffer, CommandArena::get_command<SetLineWidthCommand>(header));
+				break;
+			case CommandType::SetDepthBias:
+				set_depth_bias(command_buffer, CommandArena::get_command<SetDepthBiasCommand>(header));
+				break;
+			case CommandType::SetBlendConstants:
+				set_blend_constants(command_buffer, CommandArena::get_command<SetBlendConstantsCommand>(header));
+				break;
+			case CommandType::SetDepthBounds:
+				set_depth_bounds(command_buffer, CommandArena::get_command<SetDepthBoundsCommand>(header));
+				break;
+			case CommandType::Draw:
+				if (pipeline_bound)
+				{
+					draw(command_buffer, CommandArena::get_command<DrawCommand>(header));
+				}
+				break;
+			case CommandType::DrawIndexed:
+				if (pipeline_bound)
+				{
+					draw_indexed(command_buffer, CommandArena::get_command<DrawIndexedCommand>(header));
+				}
+				break;
+			case CommandType::UpdateBuffer:
+				update_buffer(command_buffer, CommandArena::get_command<UpdateBufferCommand>(header));
+				break;
+			case CommandType::CopyImage:
+				copy_image(command_buffer, CommandArena::get_command<CopyImageCommand>(header));
+				break;
+			case CommandType::CopyBufferToImage:
+				copy_buffer_to_image(command_buffer, CommandArena::get_command<CopyBufferToImageCommand>(header));
+				break;
+			case CommandType::ImageMemoryBarrier:
+				image_memory_barrier(command_buffer, CommandArena::get_command<ImageMemoryBarrierCommand>(header));
+				break;
+			case CommandType::ExecuteCommands:
+				execute_commands(command_buffer, CommandArena::get_command<ExecuteCommandsCommand>(header));
+				break;
+			case CommandType::DrawIndirect:
+				if (pipeline_bound)
+				{
+					draw_indirect(command_buffer, CommandArena::get_command<DrawIndirectCommand>(header));
+				}
+				break;
+			case CommandType::DrawIndexedIndirect:
+				if (pipeline_bound)
+				{
+					draw_indexed_indirect(command_buffer, CommandArena::get_command<DrawIndirectCommand>(header));
+				}
+				break;
+			case CommandType::Dispatch:
+				dispatch(command_buffer, CommandArena::get_command<DispatchCommand>(header));
+				break;
+			case CommandType::DispatchIndirect:
+				dispatch_indirect(command_buffer, CommandArena::get_command<DispatchIndirectCommand>(header));
+				break;
+			case CommandType::BufferMemoryBarrier:
+				buffer_memory_barrier(command_buffer, CommandArena::get_command<BufferMemoryBarrierCommand>(header));
+				break;
+			case CommandType::CopyBuffer:
+				copy_buffer(command_buffer, CommandArena::get_command<CopyBufferCommand>(header));
+				break;
+			default:
+				LOGE("Replay command not supported.");
+				break;
 		}
 	}
 }
 
-void CommandReplay::begin(CommandBuffer &command_buffer, std::istringstream &stream)
+const ReplayStats &CommandReplay::get_stats() const
+{
+	return stats;
+}
+
+void CommandReplay::bind_pipeline(CommandBuffer &command_buffer, const PipelineBinding &pipeline_binding)
+{
+	++stats.command_count;
+
+	VkPipeline pipeline = pipeline_binding.pipeline->get_handle();
+
+	if (pipeline == bound_state.pipeline)
+	{
+		++stats.eliminated_command_count;
+		return;
+	}
+
+	bound_state.pipeline = pipeline;
+
+	// Call Vulkan function
+	vkCmdBindPipeline(command_buffer.get_handle(), pipeline_binding.pipeline_bind_point, pipeline);
+}
+
+void CommandReplay::bind_descriptor_set(CommandBuffer &command_buffer, const CommandRecord &recorder, const DescriptorSetBinding &descriptor_set_binding)
+{
+	++stats.command_count;
+
+	VkPipelineLayout pipeline_layout = descriptor_set_binding.pipeline_layout.get_handle();
+	VkDescriptorSet  descriptor_set  = descriptor_set_binding.descriptor_set.get_handle();
+	uint32_t         set_index       = descriptor_set_binding.set_index;
+
+	auto &descriptor_sets = bound_state.descriptor_sets;
+
+	// Binding sets with another layout may disturb the sets bound with the previous one
+	if (pipeline_layout != bound_state.descriptor_set_layout ||
+	    descriptor_set_binding.pipeline_bind_point != bound_state.descriptor_set_bind_point)
+	{
+		bound_state.descriptor_set_layout     = pipeline_layout;
+		bound_state.descriptor_set_bind_point = descriptor_set_binding.pipeline_bind_point;
+		descriptor_sets.clear();
+	}
+	else if (set_index < descriptor_sets.size() && descriptor_sets[set_index] == descriptor_set &&
+	         descriptor_set_binding.dynamic_offset_count == 0)
+	{
+		// Sets with dynamic buffers are never skipped, as their offsets may have changed
+		++stats.eliminated_command_count;
+		return;
+	}
+
+	if (set_index >= descriptor_sets.size())
+	{
+		descriptor_sets.resize(set_index + 1, VK_NULL_HANDLE);
+	}
+
+	descriptor_sets[set_index] = descriptor_set;
+
+	// Call Vulkan function
+	vkCmdBindDescriptorSets(command_buffer.get_handle(),
+	                        descriptor_set_binding.pipeline_bind_point,
+	                        pipeline_layout,
+	                        set_index,
+	                        1, &descriptor_set,
+	                        descriptor_set_binding.dynamic_offset_count,
+	                        recorder.get_dynamic_offsets().data() + descriptor_set_binding.dynamic_offset_index);
+}
+
+void CommandReplay::begin(CommandBuffer &command_buffer, const CommandRecord &recorder, const BeginCommand &command)
 {
 	VkCommandBufferBeginInfo begin_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
 
-	// Read command parameters
-	read(stream, begin_info.flags);
+	begin_info.flags = command.flags;
+
+	VkCommandBufferInheritanceInfo inheritance_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+
+	// Secondary command buffers continue the render pass of the primary command buffer
+	if (recorder.is_secondary())
+	{
+		auto &inheritance = recorder.get_inheritance();
+
+		inheritance_info.renderPass  = inheritance.render_pass->get_handle();
+		inheritance_info.subpass     = inheritance.subpass_index;
+		inheritance_info.framebuffer = inheritance.framebuffer->get_handle();
+
+		begin_info.pInheritanceInfo = &inheritance_info;
+	}
 
 	// Call Vulkan function
 	vkBeginCommandBuffer(command_buffer.get_handle(), &begin_info);
 }
 
-void CommandReplay::end(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::end(CommandBuffer &command_buffer)
 {
 	// Call Vulkan function
 	vkEndCommandBuffer(command_buffer.get_handle());
 }
 
-void CommandReplay::next_subpass(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::next_subpass(CommandBuffer &command_buffer, VkSubpassContents contents)
 {
 	// Call Vulkan function
-	vkCmdNextSubpass(command_buffer.get_handle(), VK_SUBPASS_CONTENTS_INLINE);
+	vkCmdNextSubpass(command_buffer.get_handle(), contents);
 }
 
-void CommandReplay::end_render_pass(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::end_render_pass(CommandBuffer &command_buffer)
 {
 	// Call Vulkan function
 	vkCmdEndRenderPass(command_buffer.get_handle());
 }
 
-void CommandReplay::push_constants(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::push_constants(CommandBuffer &command_buffer, const PushConstantsCommand &command)
 {
-	VkPipelineLayout     pipeline_layout;
-	VkShaderStageFlags   shader_stage;
-	uint32_t             offset;
-	std::vector<uint8_t> values;
+	const uint8_t *values = CommandArena::get_data<uint8_t>(command);
 
-	// Read command parameters
-	read(stream, pipeline_layout, shader_stage, offset, values);
+	auto &push_constants       = bound_state.push_constants;
+	auto &push_constant_stages = bound_state.push_constant_stages;
 
-	// Call Vulkan function
-	vkCmdPushConstants(command_buffer.get_handle(), pipeline_layout, shader_stage, offset, values.size(), values.data());
-}
+	// Values pushed with another layout are not kept
+	if (command.pipeline_layout != bound_state.push_constant_layout)
+	{
+		bound_state.push_constant_layout = command.pipeline_layout;
+		push_constants.clear();
+		push_constant_stages.clear();
+	}
 
-void CommandReplay::bind_vertex_buffers(CommandBuffer &command_buffer, std::istringstream &stream)
-{
-	uint32_t                  first_binding;
-	std::vector<VkBuffer>     buffers;
-	std::vector<VkDeviceSize> offsets;
+	uint32_t end = command.offset + command.size;
 
-	// Read command parameters
-	read(stream, first_binding, buffers, offsets);
+	if (end <= push_constants.size() &&
+	    std::all_of(push_constant_stages.begin() + command.offset, push_constant_stages.begin() + end,
+	                [&command](VkShaderStageFlags stage) { return stage == command.shader_stage; }) &&
+	    std::equal(values, values + command.size, push_constants.begin() + command.offset))
+	{
+		++stats.eliminated_command_count;
+		return;
+	}
+
+	if (end > push_constants.size())
+	{
+		push_constants.resize(end);
+		push_constant_stages.resize(end, 0);
+	}
+
+	std::copy(values, values + command.size, push_constants.begin() + command.offset);
+	std::fill(push_constant_stages.begin() + command.offset, push_constant_stages.begin() + end, command.shader_stage);
 
 	// Call Vulkan function
-	vkCmdBindVertexBuffers(command_buffer.get_handle(), first_binding, buffers.size(), buffers.data(), offsets.data());
+	vkCmdPushConstants(command_buffer.get_handle(), command.pipeline_layout, command.shader_stage, command.offset, command.size, values);
 }
 
-void CommandReplay::bind_index_buffer(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::bind_vertex_buffers(CommandBuffer &command_buffer, const BindVertexBuffersCommand &command)
 {
-	VkBuffer     buffer;
-	VkDeviceSize offset;
-	VkIndexType  index_type;
+	const VkBuffer *    buffers = CommandArena::get_data<VkBuffer>(command);
+	const VkDeviceSize *offsets = reinterpret_cast<const VkDeviceSize *>(buffers + command.binding_count);
 
-	// Read command parameters
-	read(stream, buffer, offset, index_type);
+	uint32_t end = command.first_binding + command.binding_count;
+
+	// Bindings which are not tracked are always bound
+	if (end <= MAX_VERTEX_BINDINGS)
+	{
+		if (std::equal(buffers, buffers + command.binding_count, bound_state.vertex_buffers.begin() + command.first_binding) &&
+		    std::equal(offsets, offsets + command.binding_count, bound_state.vertex_buffer_offsets.begin() + command.first_binding))
+		{
+			++stats.eliminated_command_count;
+			return;
+		}
+
+		std::copy(buffers, buffers + command.binding_count, bound_state.vertex_buffers.begin() + command.first_binding);
+		std::copy(offsets, offsets + command.binding_count, bound_state.vertex_buffer_offsets.begin() + command.first_binding);
+	}
 
 	// Call Vulkan function
-	vkCmdBindIndexBuffer(command_buffer.get_handle(), buffer, offset, index_type);
+	vkCmdBindVertexBuffers(command_buffer.get_handle(), command.first_binding, command.binding_count, buffers, offsets);
 }
 
-void CommandReplay::set_viewport(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::bind_index_buffer(CommandBuffer &command_buffer, const BindIndexBufferCommand &command)
 {
-	uint32_t                first_viewport;
-	std::vector<VkViewport> viewports;
+	if (command.buffer == bound_state.index_buffer &&
+	    command.offset == bound_state.index_buffer_offset &&
+	    command.index_type == bound_state.index_type)
+	{
+		++stats.eliminated_command_count;
+		return;
+	}
 
-	// Read command parameters
-	read(stream, first_viewport, viewports);
+	bound_state.index_buffer        = command.buffer;
+	bound_state.index_buffer_offset = command.offset;
+	bound_state.index_type          = command.index_type;
 
 	// Call Vulkan function
-	vkCmdSetViewport(command_buffer.get_handle(), first_viewport, viewports.size(), viewports.data());
+	vkCmdBindIndexBuffer(command_buffer.get_handle(), command.buffer, command.offset, command.index_type);
 }
 
-void CommandReplay::set_scissor(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::set_viewport(CommandBuffer &command_buffer, const SetViewportCommand &command)
 {
-	uint32_t              first_scissor;
-	std::vector<VkRect2D> scissors;
+	const VkViewport *viewports = CommandArena::get_data<VkViewport>(command);
 
-	// Read command parameters
-	read(stream, first_scissor, scissors);
+	auto &bound_viewports = bound_state.viewports;
 
-	// Call Vulkan function
-	vkCmdSetScissor(command_buffer.get_handle(), first_scissor, scissors.size(), scissors.data());
-}
+	uint32_t end = command.first_viewport + command.viewport_count;
 
-void CommandReplay::set_line_width(CommandBuffer &command_buffer, std::istringstream &stream)
-{
-	float line_width;
+	if (end <= bound_viewports.size() &&
+	    std::memcmp(viewports, &bound_viewports[command.first_viewport], command.viewport_count * sizeof(VkViewport)) == 0)
+	{
+		++stats.eliminated_command_count;
+		return;
+	}
+
+	if (end > bound_viewports.size())
+	{
+		bound_viewports.resize(end);
+	}
 
-	// Read command parameters
-	read(stream, line_width);
+	std::copy(viewports, viewports + command.viewport_count, bound_viewports.begin() + command.first_viewport);
 
 	// Call Vulkan function
-	vkCmdSetLineWidth(command_buffer.get_handle(), line_width);
+	vkCmdSetViewport(command_buffer.get_handle(), command.first_viewport, command.viewport_count, viewports);
 }
 
-void CommandReplay::set_depth_bias(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::set_scissor(CommandBuffer &command_buffer, const SetScissorCommand &command)
 {
-	float depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor;
+	const VkRect2D *scissors = CommandArena::get_data<VkRect2D>(command);
 
-	// Read command parameters
-	read(stream, depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor);
+	auto &bound_scissors = bound_state.scissors;
+
+	uint32_t end = command.first_scissor + command.scissor_count;
+
+	if (end <= bound_scissors.size() &&
+	    std::memcmp(scissors, &bound_scissors[command.first_scissor], command.scissor_count * sizeof(VkRect2D)) == 0)
+	{
+		++stats.eliminated_command_count;
+		return;
+	}
+
+	if (end > bound_scissors.size())
+	{
+		bound_scissors.resize(end);
+	}
+
+	std::copy(scissors, scissors + command.scissor_count, bound_scissors.begin() + command.first_scissor);
 
 	// Call Vulkan function
-	vkCmdSetDepthBias(command_buffer.get_handle(), depth_bias_constant_factor, depth_bias_clamp, depth_bias_slope_factor);
+	vkCmdSetScissor(command_buffer.get_handle(), command.first_scissor, command.scissor_count, scissors);
 }
 
-void CommandReplay::set_blend_constants(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::set_line_width(CommandBuffer &command_buffer, const SetLineWidthCommand &command)
 {
-	std::array<float, 4> blend_constants;
-
-	// Read command parameters
-	read(stream, blend_constants);
-
 	// Call Vulkan function
-	vkCmdSetBlendConstants(command_buffer.get_handle(), blend_constants.data());
+	vkCmdSetLineWidth(command_buffer.get_handle(), command.line_width);
 }
 
-void CommandReplay::set_depth_bounds(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::set_depth_bias(CommandBuffer &command_buffer, const SetDepthBiasCommand &command)
 {
-	float min_depth_bounds, max_depth_bounds;
+	// Call Vulkan function
+	vkCmdSetDepthBias(command_buffer.get_handle(), command.depth_bias_constant_factor, command.depth_bias_clamp, command.depth_bias_slope_factor);
+}
 
-	// Read command parameters
-	read(stream, min_depth_bounds, max_depth_bounds);
+void CommandReplay::set_blend_constants(CommandBuffer &command_buffer, const SetBlendConstantsCommand &command)
+{
+	// Call Vulkan function
+	vkCmdSetBlendConstants(command_buffer.get_handle(), command.blend_constants);
+}
 
+void CommandReplay::set_depth_bounds(CommandBuffer &command_buffer, const SetDepthBoundsCommand &command)
+{
 	// Call Vulkan function
-	vkCmdSetDepthBounds(command_buffer.get_handle(), min_depth_bounds, max_depth_bounds);
+	vkCmdSetDepthBounds(command_buffer.get_handle(), command.min_depth_bounds, command.max_depth_bounds);
 }
 
-void CommandReplay::draw(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::draw(CommandBuffer &command_buffer, const DrawCommand &command)
 {
-	uint32_t vertex_count;
-	uint32_t instance_count;
-	uint32_t first_vertex;
-	uint32_t first_instance;
+	// Call Vulkan function
+	vkCmdDraw(command_buffer.get_handle(), command.vertex_count, command.instance_count, command.first_vertex, command.first_instance);
+}
 
-	// Read command parameters
-	read(stream, vertex_count, instance_count, first_vertex, first_instance);
+void CommandReplay::draw_indexed(CommandBuffer &command_buffer, const DrawIndexedCommand &command)
+{
+	// Call Vulkan function
+	vkCmdDrawIndexed(command_buffer.get_handle(), command.index_count, command.instance_count, command.first_index, command.vertex_offset, command.first_instance);
+}
 
+void CommandReplay::update_buffer(CommandBuffer &command_buffer, const UpdateBufferCommand &command)
+{
 	// Call Vulkan function
-	vkCmdDraw(command_buffer.get_handle(), vertex_count, instance_count, first_vertex, first_instance);
+	vkCmdUpdateBuffer(command_buffer.get_handle(), command.buffer, command.offset, command.size, CommandArena::get_data<uint8_t>(command));
 }
 
-void CommandReplay::draw_indexed(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::copy_image(CommandBuffer &command_buffer, const CopyImageCommand &command)
 {
-	uint32_t index_count;
-	uint32_t instance_count;
-	uint32_t first_index;
-	uint32_t vertex_offset;
-	uint32_t first_instance;
+	// Call Vulkan function
+	vkCmdCopyImage(command_buffer.get_handle(), command.src_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, command.dst_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, command.region_count, CommandArena::get_data<VkImageCopy>(command));
+}
 
-	// Read command parameters
-	read(stream, index_count, instance_count, first_index, vertex_offset, first_instance);
+void CommandReplay::copy_buffer(CommandBuffer &command_buffer, const CopyBufferCommand &command)
+{
+	// Call Vulkan function
+	vkCmdCopyBuffer(command_buffer.get_handle(), command.src_buffer, command.dst_buffer, command.region_count, CommandArena::get_data<VkBufferCopy>(command));
+}
 
+void CommandReplay::copy_buffer_to_image(CommandBuffer &command_buffer, const CopyBufferToImageCommand &command)
+{
 	// Call Vulkan function
-	vkCmdDrawIndexed(command_buffer.get_handle(), index_count, instance_count, first_index, vertex_offset, first_instance);
+	vkCmdCopyBufferToImage(command_buffer.get_handle(), command.buffer, command.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, command.region_count, CommandArena::get_data<VkBufferImageCopy>(command));
 }
 
-void CommandReplay::update_buffer(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::image_memory_barrier(CommandBuffer &command_buffer, const ImageMemoryBarrierCommand &command)
 {
-	VkBuffer             buffer;
-	VkDeviceSize         offset;
-	std::vector<uint8_t> data;
+	const ImageMemoryBarrier &memory_barrier = command.memory_barrier;
 
-	// Read command parameters
-	read(stream, buffer, offset, data);
+	VkImageMemoryBarrier image_memory_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
 
-	// Call Vulkan function
-	vkCmdUpdateBuffer(command_buffer.get_handle(), buffer, offset, data.size(), data.data());
+	image_memory_barrier.oldLayout           = memory_barrier.old_layout;
+	image_memory_barrier.newLayout           = memory_barrier.new_layout;
+	image_memory_barrier.image               = command.image;
+	image_memory_barrier.subresourceRange    = command.subresource_range;
+	image_memory_barrier.srcAccessMask       = memory_barrier.src_access_mask;
+	image_memory_barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+	image_memory_barrier.srcQueueFamilyIndex = memory_barrier.old_queue_family;
+	image_memory_barrier.dstQueueFamilyIndex = memory_barrier.new_queue_family;
+
+	if (overlaps_any(image_memory_barriers, image_memory_barrier))
+	{
+		flush_barriers(command_buffer);
+	}
+
+	// Recorded with the next barriers
+	image_memory_barriers.push_back(image_memory_barrier);
+
+	barrier_src_stage_mask |= memory_barrier.src_stage_mask;
+	barrier_dst_stage_mask |= memory_barrier.dst_stage_mask;
 }
 
-void CommandReplay::copy_image(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::execute_commands(CommandBuffer &command_buffer, const ExecuteCommandsCommand &command)
 {
-	VkImage                  src_image;
-	VkImage                  dst_image;
-	std::vector<VkImageCopy> regions;
+	// Call Vulkan function
+	vkCmdExecuteCommands(command_buffer.get_handle(), command.command_buffer_count, CommandArena::get_data<VkCommandBuffer>(command));
 
-	// Read command parameters
-	read(stream, src_image, dst_image, regions);
+	// The state bound by the secondary command buffers is undefined afterwards
+	bound_state.reset();
+}
 
-	// Call Vulkan function
-	vkCmdCopyImage(command_buffer.get_handle(), src_image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, dst_image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
+void CommandReplay::draw_indirect(CommandBuffer &command_buffer, const DrawIndirectCommand &command)
+{
+	draw_indirect_batches(command_buffer, command, vkCmdDrawIndirect);
 }
 
-void CommandReplay::copy_buffer_to_image(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::draw_indexed_indirect(CommandBuffer &command_buffer, const DrawIndirectCommand &command)
 {
-	VkBuffer                       buffer;
-	VkImage                        image;
-	std::vector<VkBufferImageCopy> regions;
+	draw_indirect_batches(command_buffer, command, vkCmdDrawIndexedIndirect);
+}
 
-	// Read command parameters
-	read(stream, buffer, image, regions);
+void CommandReplay::dispatch(CommandBuffer &command_buffer, const DispatchCommand &command)
+{
+	// Call Vulkan function
+	vkCmdDispatch(command_buffer.get_handle(), command.group_count_x, command.group_count_y, command.group_count_z);
+}
 
+void CommandReplay::dispatch_indirect(CommandBuffer &command_buffer, const DispatchIndirectCommand &command)
+{
 	// Call Vulkan function
-	vkCmdCopyBufferToImage(command_buffer.get_handle(), buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
+	vkCmdDispatchIndirect(command_buffer.get_handle(), command.buffer, command.offset);
 }
 
-void CommandReplay::image_memory_barrier(CommandBuffer &command_buffer, std::istringstream &stream)
+void CommandReplay::buffer_memory_barrier(CommandBuffer &command_buffer, const BufferMemoryBarrierCommand &command)
 {
-	VkImage                 image;
-	VkImageSubresourceRange subresource_range;
-	ImageMemoryBarrier      memory_barrier;
+	const BufferMemoryBarrier &memory_barrier = command.memory_barrier;
 
-	// Read command parameters
-	read(stream, image, subresource_range, memory_barrier);
+	VkBufferMemoryBarrier buffer_memory_barrier{VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER};
 
-	VkImageMemoryBarrier image_memory_barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+	buffer_memory_barrier.buffer              = command.buffer;
+	buffer_memory_barrier.offset              = command.offset;
+	buffer_memory_barrier.size                = command.size;
+	buffer_memory_barrier.srcAccessMask       = memory_barrier.src_access_mask;
+	buffer_memory_barrier.dstAccessMask       = memory_barrier.dst_access_mask;
+	buffer_memory_barrier.srcQueueFamilyIndex = memory_barrier.old_queue_family;
+	buffer_memory_barrier.dstQueueFamilyIndex = memory_barrier.new_queue_family;
+
+	if (overlaps_any(buffer_memory_barriers, buffer_memory_barrier))
+	{
+		flush_barriers(command_buffer);
+	}
 
-	image_memory_barrier.oldLayout        = memory_barrier.old_layout;
-	image_memory_barrier.newLayout        = memory_barrier.new_layout;
-	image_memory_barrier.image            = image;
-	image_memory_barrier.subresourceRange = subresource_range;
-	image_memory_barrier.srcAccessMask    = memory_barrier.src_access_mask;
-	image_memory_barrier.dstAccessMask    = memory_barrier.dst_access_mask;
+	// Recorded with the next barriers
+	buffer_memory_barriers.push_back(buffer_memory_barrier);
 
-	VkPipelineStageFlags src_stage_mask = memory_barrier.src_stage_mask;
-	VkPipelineStageFlags dst_stage_mask = memory_barrier.dst_stage_mask;
+	barrier_src_stage_mask |= memory_barrier.src_stage_mask;
+	barrier_dst_stage_mask |= memory_barrier.dst_stage_mask;
+}
 
+void CommandReplay::flush_barriers(CommandBuffer &command_buffer)
+{
 	// Call Vulkan function
 	vkCmdPipelineBarrier(
 	    command_buffer.get_handle(),
-	    src_stage_mask,
-	    dst_stage_mask,
+	    barrier_src_stage_mask,
+	    barrier_dst_stage_mask,
 	    0,
 	    0, nullptr,
-	    0, nullptr,
-	    1,
-	    &image_memory_barrier);
+	    to_u32(buffer_memory_barriers.size()), buffer_memory_barriers.data(),
+	    to_u32(image_memory_barriers.size()), image_memory_barriers.data());
+
+	image_memory_barriers.clear();
+	buffer_memory_barriers.clear();
+
+	barrier_src_stage_mask = 0;
+	barrier_dst_stage_mask = 0;
 }
 }        // namespace vkb
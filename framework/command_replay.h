@@ -29,61 +29,148 @@ namespace vkb
 class CommandBuffer;
 
 /*
- * @brief Reads Vulkan commands from a memory stream and runs them in a Vulkan command buffer.
+ * @brief Counters of the last replay of a command buffer
+ */
+struct ReplayStats
+{
+	/// Number of commands and bindings replayed
+	uint32_t command_count{0};
+
+	/// Number of commands and bindings dropped as they would not change the bound state
+	uint32_t eliminated_command_count{0};
+};
+
+/*
+ * @brief Reads Vulkan commands from a command arena and runs them in a Vulkan command buffer.
  */
 class CommandReplay
 {
   public:
-	CommandReplay();
-
 	/*
 	 * @brief Reads Vulkan commands from a CommandRecord object and calls the 
 	 *        corresponding Vulkan function to record the command in a Vulkan command buffer object.
+	 *        The commands are read in place from the recorder's arena.
 	 */
 	void play(CommandBuffer &command_buffer, CommandRecord &recorder);
 
-  protected:
-	using CommandFunc = std::function<void(CommandBuffer &, std::istringstream &)>;
-
-	std::unordered_map<CommandType, CommandFunc> stream_commands;
+	const ReplayStats &get_stats() const;
 
   private:
-	void begin(CommandBuffer &command_buffer, std::istringstream &stream);
+	/// Number of vertex buffer bindings tracked, higher bindings are always bound
+	static const uint32_t MAX_VERTEX_BINDINGS = 16;
+
+	/*
+	 * @brief State bound in the Vulkan command buffer during the replay, used to
+	 *        drop the commands and bindings which would bind the same state again.
+	 *        Dynamic states are tracked across pipelines, as all pipelines use them.
+	 */
+	struct BoundState
+	{
+		VkPipeline pipeline{VK_NULL_HANDLE};
+
+		std::array<VkBuffer, MAX_VERTEX_BINDINGS> vertex_buffers{};
+
+		std::array<VkDeviceSize, MAX_VERTEX_BINDINGS> vertex_buffer_offsets{};
+
+		VkBuffer index_buffer{VK_NULL_HANDLE};
+
+		VkDeviceSize index_buffer_offset{0};
+
+		VkIndexType index_type{VK_INDEX_TYPE_MAX_ENUM};
+
+		std::vector<VkViewport> viewports;
+
+		std::vector<VkRect2D> scissors;
+
+		/// Layout of the push constants values, which are lost when it changes
+		VkPipelineLayout push_constant_layout{VK_NULL_HANDLE};
+
+		std::vector<uint8_t> push_constants;
+
+		/// Stages each push constant byte was pushed for, zero if it was not pushed
+		std::vector<VkShaderStageFlags> push_constant_stages;
+
+		/// Layout and bind point of the descriptor sets, which may be disturbed when they change
+		VkPipelineLayout descriptor_set_layout{VK_NULL_HANDLE};
+
+		VkPipelineBindPoint descriptor_set_bind_point{VK_PIPELINE_BIND_POINT_MAX_ENUM};
+
+		std::vector<VkDescriptorSet> descriptor_sets;
+
+		/// Forgets the bound state, the memory of the arrays is kept
+		void reset();
+	};
+
+	BoundState bound_state;
+
+	ReplayStats stats;
+
+	/// Consecutive barriers, merged into a single pipeline barrier
+	std::vector<VkImageMemoryBarrier> image_memory_barriers;
+
+	std::vector<VkBufferMemoryBarrier> buffer_memory_barriers;
+
+	VkPipelineStageFlags barrier_src_stage_mask{0};
+
+	VkPipelineStageFlags barrier_dst_stage_mask{0};
+
+	/// Records the merged barriers, if any
+	void flush_barriers(CommandBuffer &command_buffer);
+
+	void bind_pipeline(CommandBuffer &command_buffer, const PipelineBinding &pipeline_binding);
+
+	void bind_descriptor_set(CommandBuffer &command_buffer, const CommandRecord &recorder, const DescriptorSetBinding &descriptor_set_binding);
+
+	void begin(CommandBuffer &command_buffer, const CommandRecord &recorder, const BeginCommand &command);
+
+	void end(CommandBuffer &command_buffer);
+
+	void next_subpass(CommandBuffer &command_buffer, VkSubpassContents contents);
+
+	void end_render_pass(CommandBuffer &command_buffer);
+
+	void push_constants(CommandBuffer &command_buffer, const PushConstantsCommand &command);
+
+	void bind_vertex_buffers(CommandBuffer &command_buffer, const BindVertexBuffersCommand &command);
+
+	void bind_index_buffer(CommandBuffer &command_buffer, const BindIndexBufferCommand &command);
+
+	void set_viewport(CommandBuffer &command_buffer, const SetViewportCommand &command);
 
-	void end(CommandBuffer &command_buffer, std::istringstream &stream);
+	void set_scissor(CommandBuffer &command_buffer, const SetScissorCommand &command);
 
-	void next_subpass(CommandBuffer &command_buffer, std::istringstream &stream);
+	void set_line_width(CommandBuffer &command_buffer, const SetLineWidthCommand &command);
 
-	void end_render_pass(CommandBuffer &command_buffer, std::istringstream &stream);
+	void set_depth_bias(CommandBuffer &command_buffer, const SetDepthBiasCommand &command);
 
-	void push_constants(CommandBuffer &command_buffer, std::istringstream &stream);
+	void set_blend_constants(CommandBuffer &command_buffer, const SetBlendConstantsCommand &command);
 
-	void bind_vertex_buffers(CommandBuffer &command_buffer, std::istringstream &stream);
+	void set_depth_bounds(CommandBuffer &command_buffer, const SetDepthBoundsCommand &command);
 
-	void bind_index_buffer(CommandBuffer &command_buffer, std::istringstream &stream);
+	void draw(CommandBuffer &command_buffer, const DrawCommand &command);
 
-	void set_viewport(CommandBuffer &command_buffer, std::istringstream &stream);
+	void draw_indexed(CommandBuffer &command_buffer, const DrawIndexedCommand &command);
 
-	void set_scissor(CommandBuffer &command_buffer, std::istringstream &stream);
+	void update_buffer(CommandBuffer &command_buffer, const UpdateBufferCommand &command);
 
-	void set_line_width(CommandBuffer &command_buffer, std::istringstream &stream);
+	void copy_image(CommandBuffer &command_buffer, const CopyImageCommand &command);
 
-	void set_depth_bias(CommandBuffer &command_buffer, std::istringstream &stream);
+	void copy_buffer(CommandBuffer &command_buffer, const CopyBufferCommand &command);
 
-	void set_blend_constants(CommandBuffer &command_buffer, std::istringstream &stream);
+	void copy_buffer_to_image(CommandBuffer &command_buffer, const CopyBufferToImageCommand &command);
 
-	void set_depth_bounds(CommandBuffer &command_buffer, std::istringstream &stream);
+	void image_memory_barrier(CommandBuffer &command_buffer, const ImageMemoryBarrierCommand &command);
 
-	void draw(CommandBuffer &command_buffer, std::istringstream &stream);
+	void execute_commands(CommandBuffer &command_buffer, const ExecuteCommandsCommand &command);
 
-	void draw_indexed(CommandBuffer &command_buffer, std::istringstream &stream);
+	void draw_indirect(CommandBuffer &command_buffer, const DrawIndirectCommand &command);
 
-	void update_buffer(CommandBuffer &command_buffer, std::istringstream &stream);
+	void draw_indexed_indirect(CommandBuffer &command_buffer, const DrawIndirectCommand &command);
 
-	void copy_image(CommandBuffer &command_buffer, std::istringstream &stream);
+	void dispatch(CommandBuffer &command_buffer, const DispatchCommand &command);
 
-	void copy_buffer_to_image(CommandBuffer &command_buffer, std::istringstream &stream);
+	void dispatch_indirect(CommandBuffer &command_buffer, const DispatchIndirectCommand &command);
 
-	void image_memory_barrier(CommandBuffer &command_buffer, std::istringstream &stream);
+	void buffer_memory_barrier(CommandBuffer &command_buffer, const BufferMemoryBarrierCommand &command);
 };
 }        // namespace vkb
@@ -77,6 +77,56 @@ uint32_t to_u32(const size_t value)
 	return static_cast<uint32_t>(value);
 }
 
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed)
+{
+	const uint64_t m = 0xc6a4a7935bd1e995ULL;
+	const int      r = 47;
+
+	uint64_t hash = seed ^ (size * m);
+
+	const uint8_t *bytes = static_cast<const uint8_t *>(data);
+	const uint8_t *end   = bytes + (size & ~size_t{7});
+
+	for (; bytes != end; bytes += 8)
+	{
+		uint64_t k;
+		std::memcpy(&k, bytes, sizeof(k));
+
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+
+		hash ^= k;
+		hash *= m;
+	}
+
+	// Mix the remaining bytes
+	switch (size & 7)
+	{
+		case 7:
+			hash ^= static_cast<uint64_t>(bytes[6]) << 48;
+		case 6:
+			hash ^= static_cast<uint64_t>(bytes[5]) << 40;
+		case 5:
+			hash ^= static_cast<uint64_t>(bytes[4]) << 32;
+		case 4:
+			hash ^= static_cast<uint64_t>(bytes[3]) << 24;
+		case 3:
+			hash ^= static_cast<uint64_t>(bytes[2]) << 16;
+		case 2:
+			hash ^= static_cast<uint64_t>(bytes[1]) << 8;
+		case 1:
+			hash ^= static_cast<uint64_t>(bytes[0]);
+			hash *= m;
+	}
+
+	hash ^= hash >> r;
+	hash *= m;
+	hash ^= hash >> r;
+
+	return hash;
+}
+
 bool is_depth_only_format(VkFormat format)
 {
 	return format == VK_FORMAT_D16_UNORM ||
@@ -91,6 +141,58 @@ bool is_depth_stencil_format(VkFormat format)
 	       is_depth_only_format(format);
 }
 
+ImageAccess get_image_access(ImageUsage usage, VkFormat format)
+{
+	switch (usage)
+	{
+		case ImageUsage::ColorAttachment:
+			return {VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
+			        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT};
+
+		case ImageUsage::DepthStencilAttachment:
+			return {VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
+			        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+			        VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT};
+
+		case ImageUsage::FragmentShaderRead:
+			return {is_depth_stencil_format(format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+			        VK_ACCESS_SHADER_READ_BIT};
+
+		case ImageUsage::ComputeShaderRead:
+			return {is_depth_stencil_format(format) ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+			        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			        VK_ACCESS_SHADER_READ_BIT};
+
+		case ImageUsage::ComputeShaderWrite:
+			return {VK_IMAGE_LAYOUT_GENERAL,
+			        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT};
+
+		case ImageUsage::TransferSrc:
+			return {VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			        VK_PIPELINE_STAGE_TRANSFER_BIT,
+			        VK_ACCESS_TRANSFER_READ_BIT};
+
+		case ImageUsage::TransferDst:
+			return {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+			        VK_PIPELINE_STAGE_TRANSFER_BIT,
+			        VK_ACCESS_TRANSFER_WRITE_BIT};
+
+		case ImageUsage::Present:
+			// The presentation engine waits on a semaphore, which makes writes visible.
+			// Acquiring the image again waits at the color attachment output stage,
+			// so the barrier of its next use waits for that stage.
+			return {VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+			        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			        0};
+
+		default:
+			return {};
+	}
+}
+
 int32_t get_bits_per_pixel(VkFormat format)
 {
 	switch (format)
@@ -312,4 +414,87 @@ std::vector<uint8_t> read_binary_file(const std::string &path)
 
 	return data;
 }
+
+namespace
+{
+std::string &get_temp_directory()
+{
+	static std::string temp_directory;
+
+	return temp_directory;
+}
+}        // namespace
+
+void set_temp_directory(const std::string &path)
+{
+	auto &temp_directory = get_temp_directory();
+
+	temp_directory = path;
+
+	if (!temp_directory.empty() && temp_directory.back() != '/')
+	{
+		temp_directory += '/';
+	}
+}
+
+std::vector<uint8_t> read_temp_file(const std::string &filename)
+{
+	std::vector<uint8_t> data;
+
+	std::ifstream file;
+
+	file.open(get_temp_directory() + filename, std::ios::in | std::ios::binary);
+
+	if (file.is_open())
+	{
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	return data;
+}
+
+bool write_temp_file(const std::vector<uint8_t> &data, const std::string &filename)
+{
+	std::string path      = get_temp_directory() + filename;
+	std::string temp_path = path + ".tmp";
+
+	{
+		std::ofstream file;
+
+		file.open(temp_path, std::ios::out | std::ios::binary | std::ios::trunc);
+
+		if (!file.is_open())
+		{
+			LOGE("Failed to open file for writing: %s", temp_path.c_str());
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char *>(data.data()), data.size());
+		file.flush();
+
+		if (!file.good())
+		{
+			LOGE("Failed to write file: %s", temp_path.c_str());
+			file.close();
+			std::remove(temp_path.c_str());
+			return false;
+		}
+	}
+
+	// Replace the previous file in a single step
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+	bool renamed = MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	bool renamed = std::rename(temp_path.c_str(), path.c_str()) == 0;
+#endif
+
+	if (!renamed)
+	{
+		LOGE("Failed to replace file: %s", path.c_str());
+		std::remove(temp_path.c_str());
+		return false;
+	}
+
+	return true;
+}
 }        // namespace vkb
@@ -27,6 +27,7 @@
 #include <chrono>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <functional>
 #include <iterator>
@@ -70,6 +71,49 @@ inline void hash_combine(size_t &seed, const T &v)
 	glm::detail::hash_combine(seed, hasher(v));
 }
 
+/**
+ * @brief Helper function to mix a 64-bit value into a 64-bit hash,
+ *        using the mixing step of MurmurHash64A.
+ * @param seed The hash to update
+ * @param value The value to mix in
+ * @return The updated hash
+ */
+inline uint64_t hash_mix(uint64_t seed, uint64_t value)
+{
+	const uint64_t m = 0xc6a4a7935bd1e995ULL;
+	const int      r = 47;
+
+	value *= m;
+	value ^= value >> r;
+	value *= m;
+
+	seed ^= value;
+	seed *= m;
+
+	return seed;
+}
+
+/**
+ * @brief Helper function to mix a Vulkan handle into a 64-bit hash
+ * @param seed The hash to update
+ * @param handle The handle to mix in, either a pointer or a 64-bit integer
+ * @return The updated hash
+ */
+template <class T>
+inline uint64_t hash_handle(uint64_t seed, T handle)
+{
+	return hash_mix(seed, reinterpret_cast<uint64_t>(handle));
+}
+
+/**
+ * @brief Helper function to compute the 64-bit MurmurHash64A of a block of memory
+ * @param data Pointer to the first byte
+ * @param size Number of bytes to hash
+ * @param seed Initial value of the hash
+ * @return The hash of the data
+ */
+uint64_t hash_bytes(const void *data, size_t size, uint64_t seed = 0);
+
 /**
  * @brief Helper function to convert a data type
  *        to string using output stream operator.
@@ -120,6 +164,34 @@ int32_t get_bits_per_pixel(VkFormat format);
  * @return A vector filled with data read from the file
  */
 std::vector<uint8_t> read_binary_file(const std::string &path);
+
+/**
+ * @brief Helper function to set the writable directory used for temporary files
+ *
+ * @param path The path to the directory, an empty string uses the working directory
+ */
+void set_temp_directory(const std::string &path);
+
+/**
+ * @brief Helper function to read a file from the temporary directory
+ *
+ * @param filename The name of the file (relative to the temporary directory)
+ *
+ * @return A vector filled with data read from the file, empty if the file does not exist
+ */
+std::vector<uint8_t> read_temp_file(const std::string &filename);
+
+/**
+ * @brief Helper function to write a file to the temporary directory.
+ *        The data is written to an intermediate file which then replaces
+ *        the target, so that a crash never leaves a partially written file.
+ *
+ * @param data The data to write
+ * @param filename The name of the file (relative to the temporary directory)
+ *
+ * @return True if the file was written successfully, false otherwise
+ */
+bool write_temp_file(const std::vector<uint8_t> &data, const std::string &filename);
 }        // namespace vkb
 
 namespace vkb
@@ -141,6 +213,66 @@ struct ImageMemoryBarrier
 	VkImageLayout old_layout{VK_IMAGE_LAYOUT_UNDEFINED};
 
 	VkImageLayout new_layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+	uint32_t old_queue_family{VK_QUEUE_FAMILY_IGNORED};
+
+	uint32_t new_queue_family{VK_QUEUE_FAMILY_IGNORED};
+};
+
+/**
+ * @brief Usage of an image by the next commands, from which the layout,
+ *        stages and access of its image memory barrier are derived.
+ */
+enum class ImageUsage
+{
+	ColorAttachment,
+	DepthStencilAttachment,
+	FragmentShaderRead,
+	ComputeShaderRead,
+	ComputeShaderWrite,
+	TransferSrc,
+	TransferDst,
+	Present
+};
+
+/**
+ * @brief Layout of an image, with the stages and memory access
+ *        of the commands which last used it.
+ */
+struct ImageAccess
+{
+	VkImageLayout layout{VK_IMAGE_LAYOUT_UNDEFINED};
+
+	VkPipelineStageFlags stage_mask{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+
+	VkAccessFlags access_mask{0};
+};
+
+/**
+ * @brief Helper function to get the layout, stages and access of an image usage
+ * @param usage The way the image is used
+ * @param format Format of the image, as depth formats use their own read-only layout
+ * @return The access of the image by the commands using it that way
+ */
+ImageAccess get_image_access(ImageUsage usage, VkFormat format);
+
+/**
+ * @brief Buffer memory barrier structure used to define
+ *        memory access for a buffer during command recording.
+ */
+struct BufferMemoryBarrier
+{
+	VkPipelineStageFlags src_stage_mask{VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT};
+
+	VkPipelineStageFlags dst_stage_mask{VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT};
+
+	VkAccessFlags src_access_mask{0};
+
+	VkAccessFlags dst_access_mask{0};
+
+	uint32_t old_queue_family{VK_QUEUE_FAMILY_IGNORED};
+
+	uint32_t new_queue_family{VK_QUEUE_FAMILY_IGNORED};
 };
 
 /*
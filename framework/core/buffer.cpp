@@ -38,15 +38,24 @@ Buffer::Buffer(Device &device, VkDeviceSize size, VkBufferUsageFlags buffer_usag
 	memory_info.usage = memory_usage;
 	memory_info.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
+	VmaAllocationInfo allocation_info{};
+
 	auto result = vmaCreateBuffer(device.get_memory_allocator(),
 	                              &buffer_info, &memory_info,
 	                              &handle, &memory,
-	                              nullptr);
+	                              &allocation_info);
 
 	if (result != VK_SUCCESS)
 	{
 		throw VulkanException{result, "Cannote create Buffer"};
 	}
+
+	// Host visible memory is mapped by the allocator until the buffer is destroyed
+	if (allocation_info.pMappedData)
+	{
+		mapped_data = static_cast<uint8_t *>(allocation_info.pMappedData);
+		persistent  = true;
+	}
 }
 
 Buffer::Buffer(Buffer &&other) :
@@ -54,7 +63,8 @@ Buffer::Buffer(Buffer &&other) :
     handle{other.handle},
     memory{other.memory},
     size{other.size},
-    mapped_data{other.mapped_data}
+    mapped_data{other.mapped_data},
+    persistent{other.persistent}
 {
 	// Reset other handles to avoid releasing on destruction
 	other.handle      = VK_NULL_HANDLE;
@@ -70,6 +80,11 @@ Buffer::~Buffer()
 	{
 		vmaDestroyBuffer(device.get_memory_allocator(), handle, memory);
 	}
+
+	if (handle != VK_NULL_HANDLE)
+	{
+		device.advance_resource_epoch();
+	}
 }
 
 const Device &Buffer::get_device() const
@@ -105,7 +120,7 @@ uint8_t *Buffer::map()
 
 void Buffer::unmap()
 {
-	if (mapped_data)
+	if (mapped_data && !persistent)
 	{
 		vmaUnmapMemory(device.get_memory_allocator(), memory);
 		mapped_data = nullptr;
@@ -119,7 +134,14 @@ VkDeviceSize Buffer::get_size() const
 
 void Buffer::update(const std::vector<uint8_t> &data)
 {
-	std::copy(std::begin(data), std::end(data), map());
+	update(data.data(), data.size());
+}
+
+void Buffer::update(const uint8_t *data, size_t size, size_t offset)
+{
+	std::copy(data, data + size, map() + offset);
+
+	vmaFlushAllocation(device.get_memory_allocator(), memory, offset, size);
 }
 }        // namespace core
 }        // namespace vkb
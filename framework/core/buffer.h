@@ -50,6 +50,12 @@ class Buffer : public NonCopyable
 	/// @brief data Data to upload
 	void update(const std::vector<uint8_t> &data);
 
+	/// @brief Updates a range of the buffer and flushes it, for memory which is not host coherent
+	/// @param data Pointer to the data to upload
+	/// @param size Size of the data, in bytes
+	/// @param offset Offset of the range in the buffer, in bytes
+	void update(const uint8_t *data, size_t size, size_t offset = 0);
+
   private:
 	/// @brief Maps the GPU memory to host memory
 	/// @return A pointer to the memory visible by the host
@@ -67,6 +73,9 @@ class Buffer : public NonCopyable
 	VkDeviceSize size{0};
 
 	uint8_t *mapped_data{nullptr};
+
+	/// Whether the memory stays mapped for the lifetime of the buffer
+	bool persistent{false};
 };
 }        // namespace core
 }        // namespace vkb
@@ -27,7 +27,8 @@ namespace vkb
 {
 CommandBuffer::CommandBuffer(CommandPool &command_pool, VkCommandBufferLevel level) :
     command_pool{command_pool},
-    recorder{command_pool.get_device()}
+    level{level},
+    recorder{command_pool.get_device(), command_pool.get_render_frame(), command_pool.get_thread_index()}
 {
 	VkCommandBufferAllocateInfo allocate_info{VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
 
@@ -54,6 +55,7 @@ CommandBuffer::~CommandBuffer()
 
 CommandBuffer::CommandBuffer(CommandBuffer &&other) :
     command_pool{other.command_pool},
+    level{other.level},
     handle{other.handle},
     recorder{std::move(other.recorder)},
     replayer{std::move(other.replayer)}
@@ -76,7 +78,17 @@ const VkCommandBuffer &CommandBuffer::get_handle() const
 	return handle;
 }
 
-VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags)
+VkCommandBufferLevel CommandBuffer::get_level() const
+{
+	return level;
+}
+
+const ReplayStats &CommandBuffer::get_replay_stats() const
+{
+	return replayer.get_stats();
+}
+
+VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags, CommandBuffer *primary_cmd_buf)
 {
 	assert(!recording_commands && "Command buffer is already recording, please call end before beginning again");
 
@@ -89,7 +101,16 @@ VkResult CommandBuffer::begin(VkCommandBufferUsageFlags flags)
 
 	recording_commands = true;
 
-	recorder.begin(flags);
+	if (level == VK_COMMAND_BUFFER_LEVEL_SECONDARY)
+	{
+		assert(primary_cmd_buf && "A secondary command buffer requires the primary command buffer executing it");
+
+		recorder.begin_secondary(flags, primary_cmd_buf->get_recorder());
+	}
+	else
+	{
+		recorder.begin(flags);
+	}
 
 	return VK_SUCCESS;
 }
@@ -107,11 +128,19 @@ VkResult CommandBuffer::end()
 
 	recorder.end();
 
-	replayer.play(*this, recorder);
+	if (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+	{
+		replay();
+	}
 
 	return VK_SUCCESS;
 }
 
+void CommandBuffer::replay()
+{
+	replayer.play(*this, recorder);
+}
+
 void CommandBuffer::begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values)
 {
 	recorder.begin_render_pass(render_target, load_store_infos, clear_values);
@@ -132,26 +161,51 @@ void CommandBuffer::bind_pipeline_layout(PipelineLayout &pipeline_layout)
 	recorder.bind_pipeline_layout(pipeline_layout);
 }
 
+void CommandBuffer::bind_compute_pipeline(PipelineLayout &pipeline_layout, const SpecializationInfo &specialization_info)
+{
+	recorder.bind_compute_pipeline(pipeline_layout, specialization_info);
+}
+
 void CommandBuffer::push_constants(uint32_t offset, const std::vector<uint8_t> &values)
 {
 	recorder.push_constants(offset, values);
 }
 
+void CommandBuffer::push_constants(uint32_t offset, const uint8_t *values, uint32_t size)
+{
+	recorder.push_constants(offset, values, size);
+}
+
 void CommandBuffer::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t arrayElement)
 {
 	recorder.bind_buffer(buffer, offset, range, set, binding, arrayElement);
 }
 
+void CommandBuffer::bind_buffer(const BufferAllocation &allocation, uint32_t set, uint32_t binding, uint32_t array_element)
+{
+	recorder.bind_buffer(allocation.get_buffer(), allocation.get_offset(), allocation.get_size(), set, binding, array_element);
+}
+
 void CommandBuffer::bind_image(const ImageView &image_view, VkSampler sampler, uint32_t set, uint32_t binding, uint32_t arrayElement)
 {
 	recorder.bind_image(image_view, sampler, set, binding, arrayElement);
 }
 
+void CommandBuffer::bind_descriptor_set(uint32_t set, const DescriptorSet &descriptor_set)
+{
+	recorder.bind_descriptor_set(set, descriptor_set);
+}
+
 void CommandBuffer::bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::Buffer>> &buffers, const std::vector<VkDeviceSize> &offsets)
 {
 	recorder.bind_vertex_buffers(first_binding, buffers, offsets);
 }
 
+void CommandBuffer::bind_vertex_buffers(uint32_t first_binding, uint32_t binding_count, const core::Buffer *const *buffers, const VkDeviceSize *offsets)
+{
+	recorder.bind_vertex_buffers(first_binding, binding_count, buffers, offsets);
+}
+
 void CommandBuffer::bind_index_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkIndexType index_type)
 {
 	recorder.bind_index_buffer(buffer, offset, index_type);
@@ -197,11 +251,21 @@ void CommandBuffer::set_viewport(uint32_t first_viewport, const std::vector<VkVi
 	recorder.set_viewport(first_viewport, viewports);
 }
 
+void CommandBuffer::set_viewport(uint32_t first_viewport, uint32_t viewport_count, const VkViewport *viewports)
+{
+	recorder.set_viewport(first_viewport, viewport_count, viewports);
+}
+
 void CommandBuffer::set_scissor(uint32_t first_scissor, const std::vector<VkRect2D> &scissors)
 {
 	recorder.set_scissor(first_scissor, scissors);
 }
 
+void CommandBuffer::set_scissor(uint32_t first_scissor, uint32_t scissor_count, const VkRect2D *scissors)
+{
+	recorder.set_scissor(first_scissor, scissor_count, scissors);
+}
+
 void CommandBuffer::set_line_width(float line_width)
 {
 	recorder.set_line_width(line_width);
@@ -232,16 +296,46 @@ void CommandBuffer::draw_indexed(uint32_t index_count, uint32_t instance_count,
 	recorder.draw_indexed(index_count, instance_count, first_index, vertex_offset, first_instance);
 }
 
+void CommandBuffer::draw_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
+{
+	recorder.draw_indirect(buffer, offset, draw_count, stride);
+}
+
+void CommandBuffer::draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride)
+{
+	recorder.draw_indexed_indirect(buffer, offset, draw_count, stride);
+}
+
+void CommandBuffer::dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z)
+{
+	recorder.dispatch(group_count_x, group_count_y, group_count_z);
+}
+
+void CommandBuffer::dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset)
+{
+	recorder.dispatch_indirect(buffer, offset);
+}
+
 void CommandBuffer::update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data)
 {
 	recorder.update_buffer(buffer, offset, data);
 }
 
+void CommandBuffer::update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, uint32_t size)
+{
+	recorder.update_buffer(buffer, offset, data, size);
+}
+
 void CommandBuffer::copy_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageCopy> &regions)
 {
 	recorder.copy_image(src_img, dst_img, regions);
 }
 
+void CommandBuffer::copy_buffer(const core::Buffer &src_buffer, const core::Buffer &dst_buffer, const std::vector<VkBufferCopy> &regions)
+{
+	recorder.copy_buffer(src_buffer, dst_buffer, regions);
+}
+
 void CommandBuffer::copy_buffer_to_image(const core::Buffer &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions)
 {
 	recorder.copy_buffer_to_image(buffer, image, regions);
@@ -251,4 +345,24 @@ void CommandBuffer::image_memory_barrier(const ImageView &image_view, const Imag
 {
 	recorder.image_memory_barrier(image_view, memory_barriers);
 }
+
+void CommandBuffer::transition_image(const ImageView &image_view, ImageUsage usage, bool discard_contents)
+{
+	recorder.transition_image(image_view, usage, discard_contents);
+}
+
+void CommandBuffer::buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier)
+{
+	recorder.buffer_memory_barrier(buffer, offset, size, memory_barrier);
+}
+
+void CommandBuffer::execute_commands(const std::vector<CommandBuffer *> &secondary_command_buffers, ThreadPool *thread_pool)
+{
+	recorder.execute_commands(secondary_command_buffers, thread_pool);
+}
+
+void CommandBuffer::append_commands(const CommandRecord &stream)
+{
+	recorder.append(stream);
+}
 }        // namespace vkb
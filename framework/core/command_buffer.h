@@ -22,6 +22,7 @@
 
 #include "common.h"
 
+#include "buffer_pool.h"
 #include "command_record.h"
 #include "command_replay.h"
 #include "core/buffer.h"
@@ -61,10 +62,34 @@ class CommandBuffer : public NonCopyable
 		return recording_commands;
 	}
 
-	VkResult begin(VkCommandBufferUsageFlags flags);
+	VkCommandBufferLevel get_level() const;
 
+	/**
+	 * @brief Counts of the commands in the last replay, including those
+	 *        dropped because they would not have changed the bound state
+	 */
+	const ReplayStats &get_replay_stats() const;
+
+	/**
+	 * @brief Begins recording commands
+	 * @param flags Usage of the command buffer
+	 * @param primary_cmd_buf For a secondary command buffer, the primary command buffer
+	 *        executing it, whose current subpass is continued by the secondary commands
+	 */
+	VkResult begin(VkCommandBufferUsageFlags flags, CommandBuffer *primary_cmd_buf = nullptr);
+
+	/**
+	 * @brief Ends recording commands and replays them in the Vulkan command buffer.
+	 *        Secondary command buffers are replayed by the primary command buffer
+	 *        executing them, when it ends the render pass.
+	 */
 	VkResult end();
 
+	/**
+	 * @brief Replays the recorded commands in the Vulkan command buffer
+	 */
+	void replay();
+
 	void begin_render_pass(const RenderTarget &render_target, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<VkClearValue> &clear_values);
 
 	void next_subpass();
@@ -73,22 +98,52 @@ class CommandBuffer : public NonCopyable
 
 	void bind_pipeline_layout(PipelineLayout &pipeline_layout);
 
+	/**
+	 * @brief Binds a compute pipeline, used by the next dispatches and by the push constants
+	 *        and resources bound until a graphics pipeline layout is bound
+	 * @param pipeline_layout Layout of a compute shader
+	 * @param specialization_info Constants the compute shader is specialized with
+	 */
+	void bind_compute_pipeline(PipelineLayout &pipeline_layout, const SpecializationInfo &specialization_info = {});
+
 	void push_constants(uint32_t offset, const std::vector<uint8_t> &values);
 
+	/**
+	 * @brief Pointer and count overload of push_constants, which does not allocate
+	 */
+	void push_constants(uint32_t offset, const uint8_t *values, uint32_t size);
+
 	template <typename T>
 	void push_constants(uint32_t offset, const T &value)
 	{
-		push_constants(offset,
-		               std::vector<uint8_t>{reinterpret_cast<const uint8_t *>(&value),
-		                                    reinterpret_cast<const uint8_t *>(&value) + sizeof(T)});
+		push_constants(offset, reinterpret_cast<const uint8_t *>(&value), to_u32(sizeof(T)));
 	}
 
 	void bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t arrayElement);
 
+	/**
+	 * @brief Binds the range of a transient allocation, for example a uniform buffer
+	 *        allocated from the active frame for a single draw
+	 */
+	void bind_buffer(const BufferAllocation &allocation, uint32_t set, uint32_t binding, uint32_t array_element);
+
 	void bind_image(const ImageView &image_view, VkSampler sampler, uint32_t set, uint32_t binding, uint32_t arrayElement);
 
+	/**
+	 * @brief Binds a descriptor set written by the caller in place of the resources bound to the set index,
+	 *        for example a bindless texture table bound once for all the draws
+	 */
+	void bind_descriptor_set(uint32_t set, const DescriptorSet &descriptor_set);
+
 	void bind_vertex_buffers(uint32_t first_binding, const std::vector<std::reference_wrapper<const vkb::core::Buffer>> &buffers, const std::vector<VkDeviceSize> &offsets);
 
+	/**
+	 * @brief Pointer and count overload of bind_vertex_buffers, which does not allocate
+	 * @param buffers Array of binding_count buffers
+	 * @param offsets Array of binding_count offsets
+	 */
+	void bind_vertex_buffers(uint32_t first_binding, uint32_t binding_count, const core::Buffer *const *buffers, const VkDeviceSize *offsets);
+
 	void bind_index_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkIndexType index_type);
 
 	void set_viewport_state(const ViewportState &state_info);
@@ -107,8 +162,12 @@ class CommandBuffer : public NonCopyable
 
 	void set_viewport(uint32_t first_viewport, const std::vector<VkViewport> &viewports);
 
+	void set_viewport(uint32_t first_viewport, uint32_t viewport_count, const VkViewport *viewports);
+
 	void set_scissor(uint32_t first_scissor, const std::vector<VkRect2D> &scissors);
 
+	void set_scissor(uint32_t first_scissor, uint32_t scissor_count, const VkRect2D *scissors);
+
 	void set_line_width(float line_width);
 
 	void set_depth_bias(float depth_bias_constant_factor, float depth_bias_clamp, float depth_bias_slope_factor);
@@ -121,19 +180,67 @@ class CommandBuffer : public NonCopyable
 
 	void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t first_index, int32_t vertex_offset, uint32_t first_instance);
 
+	/**
+	 * @brief Draws with parameters read from a buffer of VkDrawIndirectCommand.
+	 *        Consecutive draws reading contiguous parameters are merged when recorded.
+	 *        Without the multiDrawIndirect feature, each draw is replayed as a separate call.
+	 */
+	void draw_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride = sizeof(VkDrawIndirectCommand));
+
+	/**
+	 * @brief Draws with parameters read from a buffer of VkDrawIndexedIndirectCommand.
+	 *        Consecutive draws reading contiguous parameters are merged when recorded.
+	 *        Without the multiDrawIndirect feature, each draw is replayed as a separate call.
+	 */
+	void draw_indexed_indirect(const core::Buffer &buffer, VkDeviceSize offset, uint32_t draw_count, uint32_t stride = sizeof(VkDrawIndexedIndirectCommand));
+
+	void dispatch(uint32_t group_count_x, uint32_t group_count_y, uint32_t group_count_z);
+
+	void dispatch_indirect(const core::Buffer &buffer, VkDeviceSize offset);
+
 	void update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const std::vector<uint8_t> &data);
 
+	void update_buffer(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, uint32_t size);
+
 	void copy_image(const core::Image &src_img, const core::Image &dst_img, const std::vector<VkImageCopy> &regions);
 
+	void copy_buffer(const core::Buffer &src_buffer, const core::Buffer &dst_buffer, const std::vector<VkBufferCopy> &regions);
+
 	void copy_buffer_to_image(const core::Buffer &buffer, const core::Image &image, const std::vector<VkBufferImageCopy> &regions);
 
 	void image_memory_barrier(const ImageView &image_view, const ImageMemoryBarrier &memory_barrier);
 
+	/**
+	 * @brief Declares how an image is about to be used, and records the barrier derived
+	 *        from the tracked layout and access of the image if one is needed.
+	 *        Consecutive barriers are merged into a single pipeline barrier.
+	 * @param discard_contents Whether the previous contents of the image can be discarded
+	 */
+	void transition_image(const ImageView &image_view, ImageUsage usage, bool discard_contents = false);
+
+	void buffer_memory_barrier(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize size, const BufferMemoryBarrier &memory_barrier);
+
+	/**
+	 * @brief Executes secondary command buffers in the current subpass
+	 * @param thread_pool If not null, the secondary command buffers are replayed in parallel on it
+	 */
+	void execute_commands(const std::vector<CommandBuffer *> &secondary_command_buffers, ThreadPool *thread_pool = nullptr);
+
+	/**
+	 * @brief Appends commands recorded once in a standalone recorder, which skips building
+	 *        their pipelines and descriptor sets again. The recorder must be recorded again
+	 *        once it is no longer valid.
+	 * @param stream Recorder holding whole render passes, recorded for the current render frame
+	 */
+	void append_commands(const CommandRecord &stream);
+
   private:
 	bool recording_commands{false};
 
 	CommandPool &command_pool;
 
+	VkCommandBufferLevel level{VK_COMMAND_BUFFER_LEVEL_PRIMARY};
+
 	VkCommandBuffer handle{VK_NULL_HANDLE};
 
 	CommandRecord recorder;
@@ -24,8 +24,11 @@
 
 namespace vkb
 {
-CommandPool::CommandPool(Device &d, uint32_t queue_family_index) :
-    device{d}
+CommandPool::CommandPool(Device &d, uint32_t queue_family_index, RenderFrame *render_frame, size_t thread_index) :
+    device{d},
+    queue_family_index{queue_family_index},
+    render_frame{render_frame},
+    thread_index{thread_index}
 {
 	VkCommandPoolCreateInfo create_info{VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
 
@@ -42,7 +45,8 @@ CommandPool::CommandPool(Device &d, uint32_t queue_family_index) :
 
 CommandPool::~CommandPool()
 {
-	command_buffers.clear();
+	primary_command_buffers.clear();
+	secondary_command_buffers.clear();
 
 	// Destroy command pool
 	if (handle != VK_NULL_HANDLE)
@@ -55,14 +59,20 @@ CommandPool::CommandPool(CommandPool &&other) :
     device{other.device},
     handle{other.handle},
     queue_family_index{other.queue_family_index},
-    command_buffers{std::move(other.command_buffers)},
-    active_command_buffer_count{other.active_command_buffer_count}
+    render_frame{other.render_frame},
+    thread_index{other.thread_index},
+    primary_command_buffers{std::move(other.primary_command_buffers)},
+    active_primary_command_buffer_count{other.active_primary_command_buffer_count},
+    secondary_command_buffers{std::move(other.secondary_command_buffers)},
+    active_secondary_command_buffer_count{other.active_secondary_command_buffer_count}
 {
 	other.handle = VK_NULL_HANDLE;
 
 	other.queue_family_index = 0;
 
-	other.active_command_buffer_count = 0;
+	other.active_primary_command_buffer_count = 0;
+
+	other.active_secondary_command_buffer_count = 0;
 }
 
 Device &CommandPool::get_device()
@@ -75,6 +85,16 @@ uint32_t CommandPool::get_queue_family_index() const
 	return queue_family_index;
 }
 
+RenderFrame *CommandPool::get_render_frame()
+{
+	return render_frame;
+}
+
+size_t CommandPool::get_thread_index() const
+{
+	return thread_index;
+}
+
 VkCommandPool CommandPool::get_handle() const
 {
 	return handle;
@@ -89,13 +109,21 @@ VkResult CommandPool::reset()
 		return result;
 	}
 
-	active_command_buffer_count = 0;
+	active_primary_command_buffer_count = 0;
+
+	active_secondary_command_buffer_count = 0;
 
 	return VK_SUCCESS;
 }
 
 CommandBuffer &CommandPool::request_command_buffer(VkCommandBufferLevel level)
 {
+	// Command buffers are reused by level, as a primary cannot be recorded as a secondary
+	bool primary = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+	auto &command_buffers             = primary ? primary_command_buffers : secondary_command_buffers;
+	auto &active_command_buffer_count = primary ? active_primary_command_buffer_count : active_secondary_command_buffer_count;
+
 	if (active_command_buffer_count < command_buffers.size())
 	{
 		return command_buffers.at(active_command_buffer_count++);
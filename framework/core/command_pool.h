@@ -27,11 +27,18 @@
 namespace vkb
 {
 class Device;
+class RenderFrame;
 
 class CommandPool : public NonCopyable
 {
   public:
-	CommandPool(Device &device, uint32_t queue_family_index);
+	/**
+	 * @param device A valid Vulkan device
+	 * @param queue_family_index Queue family of the command buffers
+	 * @param render_frame Frame owning the pool, if any, whose resources are used while recording
+	 * @param thread_index Index of the thread recording the command buffers of the pool
+	 */
+	CommandPool(Device &device, uint32_t queue_family_index, RenderFrame *render_frame = nullptr, size_t thread_index = 0);
 
 	~CommandPool();
 
@@ -42,6 +49,10 @@ class CommandPool : public NonCopyable
 
 	uint32_t get_queue_family_index() const;
 
+	RenderFrame *get_render_frame();
+
+	size_t get_thread_index() const;
+
 	VkCommandPool get_handle() const;
 
 	VkResult reset();
@@ -55,8 +66,16 @@ class CommandPool : public NonCopyable
 
 	uint32_t queue_family_index{0};
 
-	std::vector<CommandBuffer> command_buffers;
+	RenderFrame *render_frame{nullptr};
+
+	size_t thread_index{0};
+
+	std::vector<CommandBuffer> primary_command_buffers;
+
+	uint32_t active_primary_command_buffer_count{0};
+
+	std::vector<CommandBuffer> secondary_command_buffers;
 
-	uint32_t active_command_buffer_count{0};
+	uint32_t active_secondary_command_buffer_count{0};
 };
 }        // namespace vkb
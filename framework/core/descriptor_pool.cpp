@@ -41,22 +41,35 @@ DescriptorPool::DescriptorPool(Device &                   device,
 		descriptor_type_counts[binding.descriptorType] += binding.descriptorCount;
 	}
 
-	// Allocate pool sizes array
-	pool_sizes.resize(descriptor_type_counts.size());
+	// Sets are allocated without a size for the runtime sized array, which is then empty
+	if (descriptor_set_layout.has_variable_descriptor_count())
+	{
+		auto &type_count = descriptor_type_counts[bindings.back().descriptorType];
+
+		type_count -= bindings.back().descriptorCount;
+
+		if (type_count == 0)
+		{
+			descriptor_type_counts.erase(bindings.back().descriptorType);
+		}
+	}
+
+	// Allocate set sizes array
+	set_sizes.resize(descriptor_type_counts.size());
 
-	auto pool_size_it = pool_sizes.begin();
+	auto set_size_it = set_sizes.begin();
 
-	// Fill pool size for each descriptor type count multiplied by the pool size
+	// Fill set size for each descriptor type count
 	for (auto &it : descriptor_type_counts)
 	{
-		pool_size_it->type = it.first;
+		set_size_it->type = it.first;
 
-		pool_size_it->descriptorCount = it.second * pool_size;
+		set_size_it->descriptorCount = it.second;
 
-		++pool_size_it;
+		++set_size_it;
 	}
 
-	pool_max_sets = pool_size;
+	initial_pool_max_sets = pool_size;
 }
 
 DescriptorPool::~DescriptorPool()
@@ -87,6 +100,8 @@ void DescriptorPool::set_descriptor_set_layout(const DescriptorSetLayout &set_la
 
 VkDescriptorSet DescriptorPool::allocate()
 {
+	std::lock_guard<std::mutex> lock{mutex};
+
 	pool_index = find_available_pool(pool_index);
 
 	// Increment allocated set count for the current pool
@@ -121,6 +136,8 @@ VkDescriptorSet DescriptorPool::allocate()
 
 VkResult DescriptorPool::free(VkDescriptorSet descriptor_set)
 {
+	std::lock_guard<std::mutex> lock{mutex};
+
 	// Get the pool index of the descriptor set
 	auto it = set_pool_mapping.find(descriptor_set);
 
@@ -146,42 +163,61 @@ VkResult DescriptorPool::free(VkDescriptorSet descriptor_set)
 	return VK_SUCCESS;
 }
 
-std::uint32_t DescriptorPool::find_available_pool(std::uint32_t pool_index)
+std::uint32_t DescriptorPool::find_available_pool(std::uint32_t search_index)
 {
-	// Create a new pool
-	if (pools.size() <= pool_index)
+	// Use the first pool with a free set, the previous ones being full
+	for (; search_index < pools.size(); ++search_index)
 	{
-		VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+		if (pool_sets_count[search_index] < pool_max_sets[search_index])
+		{
+			return search_index;
+		}
+	}
 
-		create_info.flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
-		create_info.poolSizeCount = to_u32(pool_sizes.size());
-		create_info.pPoolSizes    = pool_sizes.data();
-		create_info.maxSets       = pool_max_sets;
+	// Grow geometrically, so that few pools are needed for layouts used by many sets
+	uint32_t max_sets = initial_pool_max_sets;
 
-		VkDescriptorPool handle = VK_NULL_HANDLE;
+	for (size_t i = 0; i < pools.size() && max_sets * 2 <= MAX_SETS_PER_POOL; ++i)
+	{
+		max_sets *= 2;
+	}
 
-		// Create the Vulkan descriptor pool
-		auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
+	std::vector<VkDescriptorPoolSize> pool_sizes = set_sizes;
 
-		if (result != VK_SUCCESS)
-		{
-			return VK_NULL_HANDLE;
-		}
+	for (auto &pool_size : pool_sizes)
+	{
+		pool_size.descriptorCount *= max_sets;
+	}
 
-		// Store internally the Vulkan handle
-		pools.push_back(handle);
+	VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
 
-		// Add set count for the descriptor pool
-		pool_sets_count.push_back(0);
+	create_info.flags         = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+	create_info.poolSizeCount = to_u32(pool_sizes.size());
+	create_info.pPoolSizes    = pool_sizes.data();
+	create_info.maxSets       = max_sets;
 
-		return pool_index;
+	if (get_descriptor_set_layout().has_variable_descriptor_count())
+	{
+		create_info.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
 	}
-	else if (pool_sets_count[pool_index] < pool_max_sets)
+
+	VkDescriptorPool handle = VK_NULL_HANDLE;
+
+	// Create the Vulkan descriptor pool
+	auto result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
 	{
-		return pool_index;
+		throw VulkanException{result, "Cannot create descriptor pool"};
 	}
 
-	// Increment pool index
-	return find_available_pool(++pool_index);
+	// Store internally the Vulkan handle
+	pools.push_back(handle);
+
+	// Add set count and capacity for the descriptor pool
+	pool_sets_count.push_back(0);
+	pool_max_sets.push_back(max_sets);
+
+	return to_u32(pools.size()) - 1;
 }
 }        // namespace vkb
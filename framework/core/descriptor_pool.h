@@ -22,6 +22,7 @@
 
 #include "common.h"
 
+#include <mutex>
 #include <unordered_map>
 
 namespace vkb
@@ -29,17 +30,19 @@ namespace vkb
 class Device;
 class DescriptorSetLayout;
 
-// Manages an array of fixed size VkDescriptorPool and is able to allocate descriptor sets
+// Manages an array of VkDescriptorPool and is able to allocate and free descriptor sets
+// Each new pool holds twice as many sets as the previous one, up to MAX_SETS_PER_POOL
+// Allocations and frees are synchronized, as descriptor sets may be requested from multiple threads
 class DescriptorPool : public NonCopyable
 {
   public:
-	static const uint32_t MAX_SETS_PER_POOL = 16;
+	static const uint32_t MIN_SETS_PER_POOL = 16;
+
+	static const uint32_t MAX_SETS_PER_POOL = 1024;
 
 	DescriptorPool(Device &                   device,
 	               const DescriptorSetLayout &descriptor_set_layout,
-	               uint32_t                   pool_size = MAX_SETS_PER_POOL);
-
-	DescriptorPool(DescriptorPool &&) = default;
+	               uint32_t                   pool_size = MIN_SETS_PER_POOL);
 
 	~DescriptorPool();
 
@@ -56,15 +59,18 @@ class DescriptorPool : public NonCopyable
 
 	const DescriptorSetLayout *descriptor_set_layout{nullptr};
 
-	// Descriptor pool size
-	std::vector<VkDescriptorPoolSize> pool_sizes;
+	// Descriptor counts of a single set, multiplied by the number of sets of each pool
+	std::vector<VkDescriptorPoolSize> set_sizes;
 
-	// Number of sets to allocate for each pool
-	uint32_t pool_max_sets{0};
+	// Number of sets of the first pool
+	uint32_t initial_pool_max_sets{0};
 
 	// Total descriptor pools created
 	std::vector<VkDescriptorPool> pools;
 
+	// Maximum number of sets of each pool
+	std::vector<uint32_t> pool_max_sets;
+
 	// Count sets for each pool
 	std::vector<uint32_t> pool_sets_count;
 
@@ -74,7 +80,10 @@ class DescriptorPool : public NonCopyable
 	// Map between descriptor set and pool index
 	std::unordered_map<VkDescriptorSet, uint32_t> set_pool_mapping;
 
-	// Find next pool index or create new pool
-	uint32_t find_available_pool(uint32_t pool_index);
+	// Guards the pools, as they are externally synchronized Vulkan objects
+	std::mutex mutex;
+
+	// Find next pool index with a free set, starting from the given one, or create new pool
+	uint32_t find_available_pool(uint32_t search_index);
 };
 }        // namespace vkb
@@ -23,6 +23,7 @@
 #include "descriptor_pool.h"
 #include "descriptor_set_layout.h"
 #include "device.h"
+#include "transient_descriptor_pool.h"
 
 namespace vkb
 {
@@ -40,8 +41,37 @@ DescriptorSet::DescriptorSet(Device &                                  device,
 	}
 }
 
+DescriptorSet::DescriptorSet(Device &                                  device,
+                             DescriptorSetLayout &                     descriptor_set_layout,
+                             TransientDescriptorPool &                 descriptor_pool,
+                             const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                             const BindingMap<VkDescriptorImageInfo> & image_infos) :
+    device{device},
+    descriptor_set_layout{descriptor_set_layout},
+    handle{descriptor_pool.allocate(descriptor_set_layout)},
+    external_pool{true}
+{
+	if (!buffer_infos.empty() || !image_infos.empty())
+	{
+		update(buffer_infos, image_infos);
+	}
+}
+
+DescriptorSet::DescriptorSet(Device &device, DescriptorSetLayout &descriptor_set_layout, VkDescriptorSet handle) :
+    device{device},
+    descriptor_set_layout{descriptor_set_layout},
+    handle{handle},
+    external_pool{true}
+{
+}
+
 void DescriptorSet::update(const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos)
 {
+	if (update_with_template(buffer_infos, image_infos))
+	{
+		return;
+	}
+
 	std::vector<VkWriteDescriptorSet> set_updates;
 
 	// Iterate over all buffer bindings
@@ -113,18 +143,81 @@ void DescriptorSet::update(const BindingMap<VkDescriptorBufferInfo> &buffer_info
 	vkUpdateDescriptorSets(device.get_handle(), to_u32(set_updates.size()), set_updates.data(), 0, nullptr);
 }
 
+bool DescriptorSet::update_with_template(const BindingMap<VkDescriptorBufferInfo> &buffer_infos, const BindingMap<VkDescriptorImageInfo> &image_infos)
+{
+	VkDescriptorUpdateTemplateKHR update_template = descriptor_set_layout.get_update_template();
+
+	if (update_template == VK_NULL_HANDLE)
+	{
+		return false;
+	}
+
+	// Reused across updates, so that writing a set does not allocate
+	static thread_local std::vector<DescriptorUpdateEntry> update_entries;
+
+	update_entries.resize(descriptor_set_layout.get_update_entry_count());
+
+	uint32_t written_count{0};
+
+	// Packs the infos of a binding map, failing on descriptors the template cannot write
+	auto pack_entries = [&](const auto &infos, auto DescriptorUpdateEntry::*info_member) {
+		for (auto &binding_it : infos)
+		{
+			uint32_t first_entry;
+			if (!descriptor_set_layout.get_update_entry_index(binding_it.first, first_entry))
+			{
+				return false;
+			}
+
+			VkDescriptorSetLayoutBinding binding_info;
+			descriptor_set_layout.get_layout_binding(binding_it.first, binding_info);
+
+			for (auto &element_it : binding_it.second)
+			{
+				if (element_it.first >= binding_info.descriptorCount)
+				{
+					return false;
+				}
+
+				update_entries[first_entry + element_it.first].*info_member = element_it.second;
+
+				++written_count;
+			}
+		}
+
+		return true;
+	};
+
+	if (!pack_entries(buffer_infos, &DescriptorUpdateEntry::buffer_info) ||
+	    !pack_entries(image_infos, &DescriptorUpdateEntry::image_info))
+	{
+		return false;
+	}
+
+	// The template writes every descriptor, so a partial update goes through individual writes
+	if (written_count != update_entries.size())
+	{
+		return false;
+	}
+
+	vkUpdateDescriptorSetWithTemplateKHR(device.get_handle(), handle, update_template, update_entries.data());
+
+	return true;
+}
+
 DescriptorSet::DescriptorSet(DescriptorSet &&other) :
     device{other.device},
     descriptor_set_layout{other.descriptor_set_layout},
-    handle{other.handle}
+    handle{other.handle},
+    external_pool{other.external_pool}
 {
 	other.handle = VK_NULL_HANDLE;
 }
 
 DescriptorSet::~DescriptorSet()
 {
-	// Destroy descriptor set
-	if (handle != VK_NULL_HANDLE)
+	// Destroy descriptor set, sets of other pools being released by their pool
+	if (handle != VK_NULL_HANDLE && !external_pool)
 	{
 		descriptor_set_layout.get_descriptor_pool().free(handle);
 	}
@@ -134,4 +227,16 @@ VkDescriptorSet DescriptorSet::get_handle() const
 {
 	return handle;
 }
+
+size_t DescriptorSet::get_size() const
+{
+	size_t size = sizeof(DescriptorSet);
+
+	for (auto &binding : descriptor_set_layout.get_bindings())
+	{
+		size += binding.descriptorCount * std::max(sizeof(VkDescriptorBufferInfo), sizeof(VkDescriptorImageInfo));
+	}
+
+	return size;
+}
 }        // namespace vkb
@@ -26,6 +26,7 @@ namespace vkb
 {
 class Device;
 class DescriptorSetLayout;
+class TransientDescriptorPool;
 
 class DescriptorSet : public NonCopyable
 {
@@ -35,6 +36,21 @@ class DescriptorSet : public NonCopyable
 	              const BindingMap<VkDescriptorBufferInfo> &buffer_infos = {},
 	              const BindingMap<VkDescriptorImageInfo> & image_infos  = {});
 
+	/**
+	 * @brief Creates a set allocated from a transient pool, which is not freed on destruction
+	 *        but released with the other sets of the pool when it is reset
+	 */
+	DescriptorSet(Device &                                  device,
+	              DescriptorSetLayout &                     descriptor_set_layout,
+	              TransientDescriptorPool &                 descriptor_pool,
+	              const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	              const BindingMap<VkDescriptorImageInfo> & image_infos);
+
+	/**
+	 * @brief Wraps a set allocated by the caller from its own pool, which remains responsible for freeing it
+	 */
+	DescriptorSet(Device &device, DescriptorSetLayout &descriptor_set_layout, VkDescriptorSet handle);
+
 	DescriptorSet(DescriptorSet &&other);
 
 	~DescriptorSet();
@@ -44,11 +60,27 @@ class DescriptorSet : public NonCopyable
 
 	VkDescriptorSet get_handle() const;
 
+	/**
+	 * @return Estimated memory used by the set, as each descriptor of the layout takes
+	 *         about as much memory in the pool as the info it is written from
+	 */
+	size_t get_size() const;
+
   private:
 	Device &device;
 
 	DescriptorSetLayout &descriptor_set_layout;
 
 	VkDescriptorSet handle{VK_NULL_HANDLE};
+
+	/// Allocated from a transient pool or by the caller, rather than from the pool of the layout
+	bool external_pool{false};
+
+	/**
+	 * @brief Writes all the descriptors of the set at once with the update template of the layout
+	 * @return False if the layout has no template, or if the infos do not cover every descriptor of the set
+	 */
+	bool update_with_template(const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                          const BindingMap<VkDescriptorImageInfo> & image_infos);
 };
 }        // namespace vkb
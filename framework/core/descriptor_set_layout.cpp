@@ -31,7 +31,7 @@ namespace vkb
 {
 namespace
 {
-inline VkDescriptorType find_descriptor_type(ShaderResourceType resource_type)
+inline VkDescriptorType find_descriptor_type(ShaderResourceType resource_type, bool dynamic)
 {
 	switch (resource_type)
 	{
@@ -51,10 +51,10 @@ inline VkDescriptorType find_descriptor_type(ShaderResourceType resource_type)
 			return VK_DESCRIPTOR_TYPE_SAMPLER;
 			break;
 		case ShaderResourceType::BufferUniform:
-			return VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+			return dynamic ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
 			break;
 		case ShaderResourceType::BufferStorage:
-			return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			return dynamic ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC : VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
 			break;
 		default:
 			throw std::runtime_error("No conversion possible for the shader resource type.");
@@ -78,7 +78,7 @@ DescriptorSetLayout::DescriptorSetLayout(Device &device, const std::vector<Shade
 		}
 
 		// Convert from ShaderResourceType to VkDescriptorType.
-		auto descriptor_type = find_descriptor_type(resource.type);
+		auto descriptor_type = find_descriptor_type(resource.type, resource.dynamic);
 
 		// Convert ShaderResource to VkDescriptorSetLayoutBinding
 		VkDescriptorSetLayoutBinding layout_binding{};
@@ -88,17 +88,69 @@ DescriptorSetLayout::DescriptorSetLayout(Device &device, const std::vector<Shade
 		layout_binding.descriptorType  = descriptor_type;
 		layout_binding.stageFlags      = static_cast<VkShaderStageFlags>(resource.stages);
 
+		// Runtime sized arrays take up to the device limit, the size of each set being given when it is allocated
+		if (resource.array_size == 0)
+		{
+			if (resource.type != ShaderResourceType::ImageSampler && resource.type != ShaderResourceType::Image)
+			{
+				throw std::runtime_error("Runtime sized arrays are only supported for textures");
+			}
+
+			if (device.get_max_bindless_textures() == 0)
+			{
+				throw std::runtime_error("Runtime sized texture arrays require descriptor indexing");
+			}
+
+			if (variable_descriptor_count)
+			{
+				throw std::runtime_error("A set can only have one runtime sized array");
+			}
+
+			layout_binding.descriptorCount = device.get_max_bindless_textures();
+
+			variable_descriptor_count   = true;
+			variable_descriptor_binding = resource.binding;
+		}
+
 		bindings.push_back(layout_binding);
 
 		// Store mapping between binding and the binding point
 		bindings_lookup.emplace(resource.binding, layout_binding);
 	}
 
+	// Dynamic offsets are consumed in binding order when the set is bound
+	std::sort(bindings.begin(), bindings.end(),
+	          [](const VkDescriptorSetLayoutBinding &lhs, const VkDescriptorSetLayoutBinding &rhs) { return lhs.binding < rhs.binding; });
+
 	VkDescriptorSetLayoutCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
 
 	create_info.bindingCount = to_u32(bindings.size());
 	create_info.pBindings    = bindings.data();
 
+	std::vector<VkDescriptorBindingFlagsEXT> binding_flags;
+
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT binding_flags_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT};
+
+	if (variable_descriptor_count)
+	{
+		if (bindings.back().binding != variable_descriptor_binding)
+		{
+			throw std::runtime_error("A runtime sized array must have the highest binding of its set");
+		}
+
+		// The array is written once and only partially, then grows while the set is bound
+		binding_flags.resize(bindings.size(), 0);
+		binding_flags.back() = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+		                       VK_DESCRIPTOR_BINDING_VARIABLE_DESCRIPTOR_COUNT_BIT_EXT |
+		                       VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT;
+
+		binding_flags_info.bindingCount  = to_u32(binding_flags.size());
+		binding_flags_info.pBindingFlags = binding_flags.data();
+
+		create_info.pNext = &binding_flags_info;
+		create_info.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+	}
+
 	// Create the Vulkan descriptor set layout handle
 	VkResult result = vkCreateDescriptorSetLayout(device.get_handle(), &create_info, nullptr, &handle);
 
@@ -108,6 +160,12 @@ DescriptorSetLayout::DescriptorSetLayout(Device &device, const std::vector<Shade
 	}
 
 	descriptor_pool = std::make_unique<DescriptorPool>(device, *this);
+
+	// A template would write the whole runtime sized array, beyond the size of the sets
+	if (device.is_enabled(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME) && !variable_descriptor_count)
+	{
+		create_update_template();
+	}
 }
 
 DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
@@ -115,15 +173,26 @@ DescriptorSetLayout::DescriptorSetLayout(DescriptorSetLayout &&other) :
     descriptor_pool{std::move(other.descriptor_pool)},
     handle{other.handle},
     bindings{std::move(other.bindings)},
-    bindings_lookup{std::move(other.bindings_lookup)}
+    bindings_lookup{std::move(other.bindings_lookup)},
+    variable_descriptor_count{other.variable_descriptor_count},
+    variable_descriptor_binding{other.variable_descriptor_binding},
+    update_template{other.update_template},
+    update_entry_count{other.update_entry_count},
+    update_entry_indices{std::move(other.update_entry_indices)}
 {
-	other.handle = VK_NULL_HANDLE;
+	other.handle          = VK_NULL_HANDLE;
+	other.update_template = VK_NULL_HANDLE;
 
 	descriptor_pool->set_descriptor_set_layout(*this);
 }
 
 DescriptorSetLayout::~DescriptorSetLayout()
 {
+	if (update_template != VK_NULL_HANDLE)
+	{
+		vkDestroyDescriptorUpdateTemplateKHR(device.get_handle(), update_template, nullptr);
+	}
+
 	// Destroy descriptor set layout
 	if (handle != VK_NULL_HANDLE)
 	{
@@ -160,4 +229,85 @@ bool DescriptorSetLayout::get_layout_binding(uint32_t binding_index, VkDescripto
 
 	return true;
 }
+
+bool DescriptorSetLayout::has_variable_descriptor_count() const
+{
+	return variable_descriptor_count;
+}
+
+VkDescriptorUpdateTemplateKHR DescriptorSetLayout::get_update_template() const
+{
+	return update_template;
+}
+
+uint32_t DescriptorSetLayout::get_update_entry_count() const
+{
+	return update_entry_count;
+}
+
+bool DescriptorSetLayout::get_update_entry_index(uint32_t binding_index, uint32_t &first_entry) const
+{
+	auto it = update_entry_indices.find(binding_index);
+
+	if (it == update_entry_indices.end())
+	{
+		return false;
+	}
+
+	first_entry = it->second;
+
+	return true;
+}
+
+void DescriptorSetLayout::create_update_template()
+{
+	std::vector<VkDescriptorUpdateTemplateEntryKHR> template_entries;
+
+	// Array elements of all bindings are laid out one after the other, in binding order
+	for (auto &binding : bindings)
+	{
+		if (binding.descriptorCount == 0)
+		{
+			continue;
+		}
+
+		VkDescriptorUpdateTemplateEntryKHR template_entry{};
+
+		template_entry.dstBinding      = binding.binding;
+		template_entry.dstArrayElement = 0;
+		template_entry.descriptorCount = binding.descriptorCount;
+		template_entry.descriptorType  = binding.descriptorType;
+		template_entry.offset          = update_entry_count * sizeof(DescriptorUpdateEntry);
+		template_entry.stride          = sizeof(DescriptorUpdateEntry);
+
+		template_entries.push_back(template_entry);
+
+		update_entry_indices.emplace(binding.binding, update_entry_count);
+
+		update_entry_count += binding.descriptorCount;
+	}
+
+	if (template_entries.empty())
+	{
+		return;
+	}
+
+	VkDescriptorUpdateTemplateCreateInfoKHR create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR};
+
+	create_info.descriptorUpdateEntryCount = to_u32(template_entries.size());
+	create_info.pDescriptorUpdateEntries   = template_entries.data();
+	create_info.templateType               = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+	create_info.descriptorSetLayout        = handle;
+
+	VkResult result = vkCreateDescriptorUpdateTemplateKHR(device.get_handle(), &create_info, nullptr, &update_template);
+
+	if (result != VK_SUCCESS)
+	{
+		LOGW("Cannot create descriptor update template, descriptor sets will be written individually");
+
+		update_template    = VK_NULL_HANDLE;
+		update_entry_count = 0;
+		update_entry_indices.clear();
+	}
+}
 }        // namespace vkb
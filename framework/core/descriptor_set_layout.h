@@ -31,6 +31,17 @@ class PipelineLayout;
 
 struct ShaderResource;
 
+/**
+ * @brief Element of the flat array a descriptor set is written from with an update template,
+ *        every descriptor of the set taking the same amount of space
+ */
+union DescriptorUpdateEntry
+{
+	VkDescriptorBufferInfo buffer_info;
+
+	VkDescriptorImageInfo image_info;
+};
+
 // Caches DescriptorSet objects for the shader's set index.
 // Creates a DescriptorPool to allocate the DescriptorSet objects
 class DescriptorSetLayout : public NonCopyable
@@ -46,10 +57,40 @@ class DescriptorSetLayout : public NonCopyable
 
 	DescriptorPool &get_descriptor_pool();
 
+	/**
+	 * @return The bindings of the layout, sorted by binding index
+	 */
 	const std::vector<VkDescriptorSetLayoutBinding> &get_bindings() const;
 
 	bool get_layout_binding(uint32_t binding_index, VkDescriptorSetLayoutBinding &binding) const;
 
+	/**
+	 * @brief The last binding of the layout is a runtime sized array, such as bindless textures.
+	 *        It is partially bound and can be updated after being bound, and its size is given
+	 *        when a set is allocated, sets allocated without a size having an empty array.
+	 *        Sets are allocated from pools created with VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT.
+	 */
+	bool has_variable_descriptor_count() const;
+
+	/**
+	 * @return The template writing all the descriptors of the set from an array of DescriptorUpdateEntry,
+	 *         or VK_NULL_HANDLE if VK_KHR_descriptor_update_template is not enabled
+	 */
+	VkDescriptorUpdateTemplateKHR get_update_template() const;
+
+	/**
+	 * @return The number of entries in the array the update template reads from
+	 */
+	uint32_t get_update_entry_count() const;
+
+	/**
+	 * @brief Finds where the descriptors of a binding are in the array the update template reads from
+	 * @param binding_index The binding of the descriptors
+	 * @param first_entry The index of the entry of the first array element of the binding
+	 * @return True if the layout has the binding
+	 */
+	bool get_update_entry_index(uint32_t binding_index, uint32_t &first_entry) const;
+
   private:
 	Device &device;
 
@@ -60,5 +101,18 @@ class DescriptorSetLayout : public NonCopyable
 	std::vector<VkDescriptorSetLayoutBinding> bindings;
 
 	std::unordered_map<uint32_t, VkDescriptorSetLayoutBinding> bindings_lookup;
+
+	bool variable_descriptor_count{false};
+
+	uint32_t variable_descriptor_binding{0};
+
+	VkDescriptorUpdateTemplateKHR update_template{VK_NULL_HANDLE};
+
+	uint32_t update_entry_count{0};
+
+	/// Index of the first entry of each binding in the update template array
+	std::unordered_map<uint32_t, uint32_t> update_entry_indices;
+
+	void create_update_template();
 };
 }        // namespace vkb
@@ -28,8 +28,132 @@
 
 namespace vkb
 {
+namespace
+{
+const char *PIPELINE_CACHE_FILENAME = "pipeline_cache.data";
+
+const char *PIPELINE_MANIFEST_FILENAME = "pipeline_manifest.data";
+
+const uint32_t PIPELINE_CACHE_MAGIC = 0x564b4250;        // "VKBP"
+
+/// Number of frames after which unused descriptor sets and framebuffers are evicted by default
+const uint64_t DEFAULT_CACHE_MAX_AGE = 64;
+
+/// Extensions the framework takes advantage of, enabled only if the device supports them
+const std::vector<const char *> OPTIONAL_EXTENSIONS = {VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME};
+
+/// Upper bound of the size of bindless texture arrays, below the limits of most devices
+const uint32_t MAX_BINDLESS_TEXTURES = 4096;
+
+/**
+ * @brief Header written in front of the pipeline cache data,
+ *        identifying the device and driver which produced it
+ */
+struct PipelineCacheFileHeader
+{
+	uint32_t magic;
+
+	uint32_t data_size;
+
+	uint32_t vendor_id;
+
+	uint32_t device_id;
+
+	uint32_t driver_version;
+
+	uint8_t uuid[VK_UUID_SIZE];
+};
+
+/**
+ * @brief Extracts the pipeline cache data from a file, if it was produced
+ *        by the same device and driver as the one described by properties
+ * @return The pipeline cache data, empty if the file is missing or invalid
+ */
+std::vector<uint8_t> load_pipeline_cache_data(const VkPhysicalDeviceProperties &properties)
+{
+	std::vector<uint8_t> file_data = read_temp_file(PIPELINE_CACHE_FILENAME);
+
+	if (file_data.empty())
+	{
+		return {};
+	}
+
+	PipelineCacheFileHeader header{};
+
+	if (file_data.size() < sizeof(header))
+	{
+		LOGW("Pipeline cache file is too small, ignoring it");
+		return {};
+	}
+
+	std::memcpy(&header, file_data.data(), sizeof(header));
+
+	if (header.magic != PIPELINE_CACHE_MAGIC ||
+	    header.data_size != file_data.size() - sizeof(header))
+	{
+		LOGW("Pipeline cache file is corrupted, ignoring it");
+		return {};
+	}
+
+	if (header.vendor_id != properties.vendorID ||
+	    header.device_id != properties.deviceID ||
+	    header.driver_version != properties.driverVersion ||
+	    std::memcmp(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		LOGI("Pipeline cache file was created by a different device or driver, ignoring it");
+		return {};
+	}
+
+	std::vector<uint8_t> data(file_data.begin() + sizeof(header), file_data.end());
+
+	// Validate the header the driver writes at the start of the data
+	const size_t vk_header_size = 16 + VK_UUID_SIZE;
+
+	uint32_t vk_header_length{0};
+	uint32_t vk_header_version{0};
+
+	if (data.size() < vk_header_size)
+	{
+		LOGW("Pipeline cache data is too small, ignoring it");
+		return {};
+	}
+
+	std::memcpy(&vk_header_length, data.data(), sizeof(uint32_t));
+	std::memcpy(&vk_header_version, data.data() + 4, sizeof(uint32_t));
+
+	if (vk_header_length < vk_header_size ||
+	    vk_header_version != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+	    std::memcmp(data.data() + 16, properties.pipelineCacheUUID, VK_UUID_SIZE) != 0)
+	{
+		LOGW("Pipeline cache data header is invalid, ignoring it");
+		return {};
+	}
+
+	return data;
+}
+
+/**
+ * @brief Combines the hash maintained by the graphics state with the specialization constants
+ */
+uint64_t get_graphics_pipeline_hash(const GraphicsPipelineState &graphics_state, const ShaderStageMap<SpecializationInfo> &specialization_infos)
+{
+	uint64_t pipeline_hash = graphics_state.get_hash();
+
+	for (auto &stage_specialization : specialization_infos)
+	{
+		auto &data = stage_specialization.second.get_data();
+
+		pipeline_hash = hash_mix(pipeline_hash, stage_specialization.first);
+		pipeline_hash = hash_mix(pipeline_hash, hash_bytes(data.data(), data.size()));
+	}
+
+	return pipeline_hash;
+}
+}        // namespace
+
 Device::Device(VkPhysicalDevice physical_device, VkSurfaceKHR surface, const std::vector<const char *> extensions, const VkPhysicalDeviceFeatures &features) :
-    physical_device{physical_device}
+    physical_device{physical_device},
+    features(features)
 {
 	// Gpu properties
 	vkGetPhysicalDeviceProperties(physical_device, &properties);
@@ -56,13 +180,105 @@ Device::Device(VkPhysicalDevice physical_device, VkSurfaceKHR surface, const std
 		queue_create_info.pQueuePriorities = queue_priorities[queue_family_index].data();
 	}
 
+	uint32_t device_extension_count = 0;
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &device_extension_count, nullptr));
+
+	std::vector<VkExtensionProperties> device_extensions(device_extension_count);
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(physical_device, nullptr, &device_extension_count, device_extensions.data()));
+
+	std::vector<const char *> active_extensions(extensions);
+
+	auto is_supported = [&device_extensions](const char *extension) {
+		return std::any_of(device_extensions.begin(), device_extensions.end(),
+		                   [extension](const VkExtensionProperties &properties) { return std::strcmp(properties.extensionName, extension) == 0; });
+	};
+
+	auto enable_extension = [&active_extensions](const char *extension) {
+		if (std::none_of(active_extensions.begin(), active_extensions.end(),
+		                 [extension](const char *active_extension) { return std::strcmp(active_extension, extension) == 0; }))
+		{
+			active_extensions.push_back(extension);
+		}
+	};
+
+	for (auto optional_extension : OPTIONAL_EXTENSIONS)
+	{
+		if (is_supported(optional_extension))
+		{
+			enable_extension(optional_extension);
+		}
+	}
+
+	// Indirect draws are replayed as a single call when the device supports it
+	VkPhysicalDeviceFeatures supported_features;
+	vkGetPhysicalDeviceFeatures(physical_device, &supported_features);
+
+	if (supported_features.multiDrawIndirect)
+	{
+		this->features.multiDrawIndirect = VK_TRUE;
+	}
+
+	// Descriptor indexing is only enabled along with the features bindless textures rely on
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT descriptor_indexing_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT};
+
+	if (vkGetPhysicalDeviceFeatures2KHR &&
+	    is_supported(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) &&
+	    is_supported(VK_KHR_MAINTENANCE3_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceFeatures2KHR supported_features{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR};
+		supported_features.pNext = &descriptor_indexing_features;
+
+		vkGetPhysicalDeviceFeatures2KHR(physical_device, &supported_features);
+	}
+
+	bool bindless_supported = descriptor_indexing_features.runtimeDescriptorArray &&
+	                          descriptor_indexing_features.descriptorBindingPartiallyBound &&
+	                          descriptor_indexing_features.descriptorBindingVariableDescriptorCount &&
+	                          descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind;
+
+	if (bindless_supported)
+	{
+		enable_extension(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+		enable_extension(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+
+		VkPhysicalDeviceDescriptorIndexingPropertiesEXT descriptor_indexing_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT};
+
+		VkPhysicalDeviceProperties2KHR supported_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+		supported_properties.pNext = &descriptor_indexing_properties;
+
+		vkGetPhysicalDeviceProperties2KHR(physical_device, &supported_properties);
+
+		// Combined image samplers count against both the sampled image and the sampler limits
+		max_bindless_textures = std::min({MAX_BINDLESS_TEXTURES,
+		                                  descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+		                                  descriptor_indexing_properties.maxPerStageDescriptorUpdateAfterBindSamplers,
+		                                  descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSampledImages,
+		                                  descriptor_indexing_properties.maxDescriptorSetUpdateAfterBindSamplers});
+
+		// Enable the features used by bindless textures only
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT supported_indexing_features = descriptor_indexing_features;
+
+		descriptor_indexing_features = {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT};
+
+		descriptor_indexing_features.runtimeDescriptorArray                       = VK_TRUE;
+		descriptor_indexing_features.descriptorBindingPartiallyBound              = VK_TRUE;
+		descriptor_indexing_features.descriptorBindingVariableDescriptorCount     = VK_TRUE;
+		descriptor_indexing_features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+		descriptor_indexing_features.shaderSampledImageArrayNonUniformIndexing    = supported_indexing_features.shaderSampledImageArrayNonUniformIndexing;
+	}
+
 	VkDeviceCreateInfo create_info{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
 
 	create_info.pQueueCreateInfos       = queue_create_infos.data();
 	create_info.queueCreateInfoCount    = to_u32(queue_create_infos.size());
-	create_info.pEnabledFeatures        = &features;
-	create_info.enabledExtensionCount   = to_u32(extensions.size());
-	create_info.ppEnabledExtensionNames = extensions.data();
+	create_info.pEnabledFeatures        = &this->features;
+	create_info.enabledExtensionCount   = to_u32(active_extensions.size());
+	create_info.ppEnabledExtensionNames = active_extensions.data();
+
+	if (bindless_supported)
+	{
+		create_info.pNext = &descriptor_indexing_features;
+	}
 
 	VkResult result = vkCreateDevice(physical_device, &create_info, nullptr, &handle);
 
@@ -71,6 +287,8 @@ Device::Device(VkPhysicalDevice physical_device, VkSurfaceKHR surface, const std
 		throw VulkanException{result, "Cannot create device"};
 	}
 
+	enabled_extensions.assign(active_extensions.begin(), active_extensions.end());
+
 	queues.resize(queue_family_count);
 
 	for (uint32_t queue_family_index = 0U; queue_family_index < queue_family_count; ++queue_family_index)
@@ -116,12 +334,56 @@ Device::Device(VkPhysicalDevice physical_device, VkSurfaceKHR surface, const std
 		throw VulkanException{result, "Cannot create allocator"};
 	}
 
+	std::vector<uint8_t> pipeline_cache_data = load_pipeline_cache_data(properties);
+
+	VkPipelineCacheCreateInfo pipeline_cache_info{VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO};
+
+	pipeline_cache_info.initialDataSize = pipeline_cache_data.size();
+	pipeline_cache_info.pInitialData    = pipeline_cache_data.data();
+
+	result = vkCreatePipelineCache(handle, &pipeline_cache_info, nullptr, &pipeline_cache);
+
+	if (result != VK_SUCCESS)
+	{
+		LOGW("Cannot create pipeline cache from file data, creating an empty one");
+
+		pipeline_cache_info.initialDataSize = 0;
+		pipeline_cache_info.pInitialData    = nullptr;
+
+		result = vkCreatePipelineCache(handle, &pipeline_cache_info, nullptr, &pipeline_cache);
+
+		if (result != VK_SUCCESS)
+		{
+			throw VulkanException{result, "Cannot create pipeline cache"};
+		}
+	}
+	else if (!pipeline_cache_data.empty())
+	{
+		LOGI("Pipeline cache loaded (%zu bytes)", pipeline_cache_data.size());
+	}
+
+	// Descriptor sets and framebuffers are cheap to rebuild, and bound to transient bindings
+	CacheBudget transient_cache_budget{};
+	transient_cache_budget.max_age = DEFAULT_CACHE_MAX_AGE;
+
+	cache_descriptor_sets.set_budget(transient_cache_budget);
+	cache_framebuffers.set_budget(transient_cache_budget);
+
+	// Leave some cores to the threads recording and submitting frames
+	pipeline_compile_pool = std::make_unique<ThreadPool>(std::max(1U, std::thread::hardware_concurrency() / 2));
+
 	command_pool = std::make_unique<CommandPool>(*this, get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).get_family_index());
 	fence_pool   = std::make_unique<FencePool>(*this);
+
+	upload_manager = std::make_unique<UploadManager>(*this);
 }
 
 Device::~Device()
 {
+	// Let the pipelines being compiled be inserted in the cache before clearing it
+	pipeline_compile_pool->wait();
+	pipeline_compile_pool.reset();
+
 	// Clear caches
 	cache_framebuffers.clear();
 	cache_render_passes.clear();
@@ -130,6 +392,19 @@ Device::~Device()
 	cache_graphics_pipelines.clear();
 	cache_pipeline_layouts.clear();
 
+	if (pipeline_manifest_recording)
+	{
+		save_pipeline_manifest();
+	}
+
+	if (pipeline_cache != VK_NULL_HANDLE)
+	{
+		save_pipeline_cache();
+
+		vkDestroyPipelineCache(handle, pipeline_cache, nullptr);
+	}
+
+	upload_manager.reset();
 	command_pool.reset();
 	fence_pool.reset();
 
@@ -169,12 +444,27 @@ const VkPhysicalDeviceProperties &Device::get_properties() const
 	return properties;
 }
 
+const VkPhysicalDeviceFeatures &Device::get_features() const
+{
+	return features;
+}
+
+bool Device::is_enabled(const char *extension) const
+{
+	return std::find(enabled_extensions.begin(), enabled_extensions.end(), extension) != enabled_extensions.end();
+}
+
+uint32_t Device::get_max_bindless_textures() const
+{
+	return max_bindless_textures;
+}
+
 const Queue &Device::get_queue(uint32_t queue_family_index, uint32_t queue_index)
 {
 	return queues[queue_family_index][queue_index];
 }
 
-const Queue &Device::get_queue_by_flags(VkQueueFlags queue_flags, uint32_t queue_index)
+const Queue &Device::get_queue_by_flags(VkQueueFlags required_queue_flags, uint32_t queue_index)
 {
 	for (uint32_t queue_family_index = 0U; queue_family_index < queues.size(); ++queue_family_index)
 	{
@@ -183,7 +473,7 @@ const Queue &Device::get_queue_by_flags(VkQueueFlags queue_flags, uint32_t queue
 		VkQueueFlags queue_flags = first_queue.get_properties().queueFlags;
 		uint32_t     queue_count = first_queue.get_properties().queueCount;
 
-		if (((queue_flags & queue_flags) == queue_flags) && queue_index < queue_count)
+		if (((queue_flags & required_queue_flags) == required_queue_flags) && queue_index < queue_count)
 		{
 			return queues[queue_family_index][queue_index];
 		}
@@ -192,6 +482,26 @@ const Queue &Device::get_queue_by_flags(VkQueueFlags queue_flags, uint32_t queue
 	throw std::runtime_error("Queue not found");
 }
 
+const Queue *Device::find_dedicated_queue(VkQueueFlags required_queue_flags, VkQueueFlags excluded_queue_flags, uint32_t queue_index)
+{
+	for (uint32_t queue_family_index = 0U; queue_family_index < queues.size(); ++queue_family_index)
+	{
+		Queue &first_queue = queues[queue_family_index][0];
+
+		VkQueueFlags queue_flags = first_queue.get_properties().queueFlags;
+		uint32_t     queue_count = first_queue.get_properties().queueCount;
+
+		if (((queue_flags & required_queue_flags) == required_queue_flags) &&
+		    !(queue_flags & excluded_queue_flags) &&
+		    queue_index < queue_count)
+		{
+			return &queues[queue_family_index][queue_index];
+		}
+	}
+
+	return nullptr;
+}
+
 const Queue &Device::get_queue_by_present(uint32_t queue_index)
 {
 	for (uint32_t queue_family_index = 0U; queue_family_index < queues.size(); ++queue_family_index)
@@ -224,6 +534,50 @@ VkResult Device::wait_idle()
 	return vkDeviceWaitIdle(handle);
 }
 
+VkPipelineCache Device::get_pipeline_cache() const
+{
+	return pipeline_cache;
+}
+
+bool Device::save_pipeline_cache()
+{
+	size_t data_size{0};
+
+	VkResult result = vkGetPipelineCacheData(handle, pipeline_cache, &data_size, nullptr);
+
+	if (result != VK_SUCCESS)
+	{
+		LOGE("Cannot get pipeline cache data size");
+		return false;
+	}
+
+	std::vector<uint8_t> file_data(sizeof(PipelineCacheFileHeader) + data_size);
+
+	result = vkGetPipelineCacheData(handle, pipeline_cache, &data_size, file_data.data() + sizeof(PipelineCacheFileHeader));
+
+	if (result != VK_SUCCESS)
+	{
+		LOGE("Cannot get pipeline cache data");
+		return false;
+	}
+
+	// The cache may have shrunk between the two calls
+	file_data.resize(sizeof(PipelineCacheFileHeader) + data_size);
+
+	PipelineCacheFileHeader header{};
+
+	header.magic          = PIPELINE_CACHE_MAGIC;
+	header.data_size      = to_u32(data_size);
+	header.vendor_id      = properties.vendorID;
+	header.device_id      = properties.deviceID;
+	header.driver_version = properties.driverVersion;
+	std::memcpy(header.uuid, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+	std::memcpy(file_data.data(), &header, sizeof(header));
+
+	return write_temp_file(file_data, PIPELINE_CACHE_FILENAME);
+}
+
 PipelineLayout &Device::request_pipeline_layout(std::vector<ShaderModule> &&shader_modules)
 {
 	return cache_pipeline_layouts.request_resource(*this, std::move(shader_modules));
@@ -232,7 +586,188 @@ PipelineLayout &Device::request_pipeline_layout(std::vector<ShaderModule> &&shad
 GraphicsPipeline &Device::request_graphics_pipeline(GraphicsPipelineState &                   graphics_state,
                                                     const ShaderStageMap<SpecializationInfo> &specialization_infos)
 {
-	return cache_graphics_pipelines.request_resource(*this, graphics_state, specialization_infos);
+	uint64_t pipeline_hash = get_graphics_pipeline_hash(graphics_state, specialization_infos);
+
+	auto build = [&]() {
+		return build_graphics_pipeline(pipeline_hash, graphics_state, specialization_infos);
+	};
+
+	return cache_graphics_pipelines.request_resource_with_builder(pipeline_hash, build, *this, graphics_state, specialization_infos);
+}
+
+GraphicsPipeline *Device::request_graphics_pipeline_async(const GraphicsPipelineState &             graphics_state,
+                                                          const ShaderStageMap<SpecializationInfo> &specialization_infos)
+{
+	uint64_t pipeline_hash = get_graphics_pipeline_hash(graphics_state, specialization_infos);
+
+	GraphicsPipeline *pipeline = dispatch_graphics_pipeline(pipeline_hash, graphics_state, specialization_infos);
+
+	if (!pipeline)
+	{
+		++stalled_pipeline_count;
+	}
+
+	return pipeline;
+}
+
+GraphicsPipeline Device::build_graphics_pipeline(uint64_t pipeline_hash, GraphicsPipelineState &graphics_state, const ShaderStageMap<SpecializationInfo> &specialization_infos)
+{
+	GraphicsPipeline pipeline{*this, graphics_state, specialization_infos};
+
+	std::lock_guard<std::mutex> lock{pipeline_manifest_mutex};
+
+	if (pipeline_manifest_recording)
+	{
+		pipeline_manifest.add_pipeline(pipeline_hash, graphics_state, specialization_infos);
+	}
+
+	return pipeline;
+}
+
+GraphicsPipeline *Device::dispatch_graphics_pipeline(uint64_t pipeline_hash, const GraphicsPipelineState &graphics_state, const ShaderStageMap<SpecializationInfo> &specialization_infos, std::shared_future<void> *pending_build)
+{
+	// The worker compiles from copies of the states, as the caller's ones may change in the meantime
+	auto build = [this, pipeline_hash, graphics_state, specialization_infos]() mutable {
+		return build_graphics_pipeline(pipeline_hash, graphics_state, specialization_infos);
+	};
+
+	return cache_graphics_pipelines.request_resource_async(pipeline_hash, *pipeline_compile_pool, build, pending_build, *this, graphics_state, specialization_infos);
+}
+
+const PipelineCompileStats &Device::get_pipeline_compile_stats() const
+{
+	return pipeline_compile_stats;
+}
+
+void Device::set_pipeline_manifest_recording(bool enable)
+{
+	std::lock_guard<std::mutex> lock{pipeline_manifest_mutex};
+
+	pipeline_manifest_recording = enable;
+}
+
+std::vector<uint8_t> Device::get_pipeline_manifest()
+{
+	std::lock_guard<std::mutex> lock{pipeline_manifest_mutex};
+
+	return pipeline_manifest.serialize();
+}
+
+bool Device::save_pipeline_manifest()
+{
+	return write_temp_file(get_pipeline_manifest(), PIPELINE_MANIFEST_FILENAME);
+}
+
+uint32_t Device::prewarm_pipelines(const std::vector<uint8_t> &manifest_data)
+{
+	if (manifest_data.empty())
+	{
+		return 0;
+	}
+
+	auto start_time = std::chrono::steady_clock::now();
+
+	std::unique_ptr<PipelineManifest> manifest;
+
+	try
+	{
+		manifest = std::make_unique<PipelineManifest>(manifest_data);
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Pipeline manifest is invalid (%s), ignoring it", e.what());
+		return 0;
+	}
+
+	auto &shaders = manifest->get_shaders();
+
+	// Pipeline layouts are looked up by shader content, so they are shared with the ones requested at runtime
+	std::map<std::vector<uint32_t>, PipelineLayout *> pipeline_layouts;
+
+	std::vector<RenderPass *> render_passes;
+
+	for (auto &render_pass : manifest->get_render_passes())
+	{
+		render_passes.push_back(&request_render_pass(render_pass.attachments, render_pass.load_store_infos, render_pass.subpasses));
+	}
+
+	uint32_t pipeline_count{0};
+
+	// Builds dispatched to the workers, or already in flight from another thread
+	std::vector<std::shared_future<void>> pending_builds;
+
+	for (auto &pipeline : manifest->get_pipelines())
+	{
+		try
+		{
+			auto layout_it = pipeline_layouts.find(pipeline.shaders);
+
+			if (layout_it == pipeline_layouts.end())
+			{
+				std::vector<ShaderModule> shader_modules;
+
+				for (uint32_t shader_index : pipeline.shaders)
+				{
+					auto &shader = shaders[shader_index];
+
+					shader_modules.emplace_back(*this, shader.stage, shader.spirv, shader.entry_point);
+
+					for (auto &resource_name : shader.dynamic_resources)
+					{
+						shader_modules.back().set_resource_dynamic(resource_name);
+					}
+				}
+
+				layout_it = pipeline_layouts.emplace(pipeline.shaders, &request_pipeline_layout(std::move(shader_modules))).first;
+			}
+
+			GraphicsPipelineState graphics_state;
+
+			graphics_state.set_pipeline_layout(*layout_it->second);
+			graphics_state.set_render_pass(*render_passes[pipeline.render_pass]);
+			graphics_state.set_subpass_index(pipeline.subpass_index);
+			graphics_state.set_vertex_input_state(pipeline.vertex_input_state);
+			graphics_state.set_input_assembly_state(pipeline.input_assembly_state);
+			graphics_state.set_rasterization_state(pipeline.rasterization_state);
+			graphics_state.set_viewport_state(pipeline.viewport_state);
+			graphics_state.set_multisample_state(pipeline.multisample_state);
+			graphics_state.set_depth_stencil_state(pipeline.depth_stencil_state);
+			graphics_state.set_color_blend_state(pipeline.color_blend_state);
+
+			uint64_t pipeline_hash = get_graphics_pipeline_hash(graphics_state, pipeline.specialization_infos);
+
+			std::shared_future<void> pending_build;
+
+			dispatch_graphics_pipeline(pipeline_hash, graphics_state, pipeline.specialization_infos, &pending_build);
+
+			if (pending_build.valid())
+			{
+				pending_builds.push_back(std::move(pending_build));
+			}
+
+			++pipeline_count;
+		}
+		catch (const std::exception &e)
+		{
+			LOGW("Failed to prewarm pipeline (%s), skipping it", e.what());
+		}
+	}
+
+	for (auto &pending_build : pending_builds)
+	{
+		pending_build.wait();
+	}
+
+	auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time);
+
+	LOGI("Prewarmed %u pipelines in %lld ms", pipeline_count, static_cast<long long>(elapsed.count()));
+
+	return pipeline_count;
+}
+
+uint32_t Device::prewarm_pipelines()
+{
+	return prewarm_pipelines(read_temp_file(PIPELINE_MANIFEST_FILENAME));
 }
 
 ComputePipeline &Device::request_compute_pipeline(const PipelineLayout &    pipeline_layout,
@@ -248,6 +783,26 @@ DescriptorSet &Device::request_descriptor_set(DescriptorSetLayout &
 	return cache_descriptor_sets.request_resource(*this, descriptor_set_layout, buffer_infos, image_infos);
 }
 
+DescriptorSet &Device::request_descriptor_set(DescriptorSetLayout &                     descriptor_set_layout,
+                                              const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+                                              const BindingMap<VkDescriptorImageInfo> & image_infos,
+                                              uint64_t                                  bindings_hash)
+{
+	uint64_t descriptor_set_hash = hash_handle(bindings_hash, descriptor_set_layout.get_handle());
+
+	return cache_descriptor_sets.request_resource_with_hash(descriptor_set_hash, *this, descriptor_set_layout, buffer_infos, image_infos);
+}
+
+DescriptorSet &Device::request_descriptor_set(DescriptorSetLayout &                  descriptor_set_layout,
+                                              uint64_t                               bindings_hash,
+                                              const CacheKey &                       key,
+                                              const std::function<DescriptorSet()> &build)
+{
+	uint64_t descriptor_set_hash = hash_handle(bindings_hash, descriptor_set_layout.get_handle());
+
+	return cache_descriptor_sets.request_resource_with_key(descriptor_set_hash, key, build);
+}
+
 RenderPass &Device::request_render_pass(const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses)
 {
 	return cache_render_passes.request_resource(*this, attachments, load_store_infos, subpasses);
@@ -261,6 +816,59 @@ Framebuffer &Device::request_framebuffer(const RenderTarget &render_target, cons
 void Device::clear_framebuffers()
 {
 	cache_framebuffers.clear();
+
+	advance_resource_epoch();
+}
+
+void Device::evict_image_view_resources()
+{
+	cache_framebuffers.evict_all();
+	cache_descriptor_sets.evict_all();
+
+	advance_resource_epoch();
+}
+
+uint64_t Device::get_resource_epoch() const
+{
+	return resource_epoch.load();
+}
+
+void Device::advance_resource_epoch()
+{
+	++resource_epoch;
+}
+
+void Device::begin_frame(uint64_t frame_index, uint64_t completed_frame)
+{
+	pipeline_compile_stats.pending = to_u32(cache_graphics_pipelines.get_async_build_count());
+	pipeline_compile_stats.stalled = stalled_pipeline_count.exchange(0);
+
+	size_t evicted_count = cache_descriptor_sets.trim(frame_index, completed_frame) +
+	                       cache_framebuffers.trim(frame_index, completed_frame) +
+	                       cache_graphics_pipelines.trim(frame_index, completed_frame);
+
+	// Recorded command streams may reference the evicted resources
+	if (evicted_count > 0)
+	{
+		advance_resource_epoch();
+	}
+
+	upload_manager->update();
+}
+
+void Device::set_descriptor_set_cache_budget(const CacheBudget &budget)
+{
+	cache_descriptor_sets.set_budget(budget);
+}
+
+void Device::set_framebuffer_cache_budget(const CacheBudget &budget)
+{
+	cache_framebuffers.set_budget(budget);
+}
+
+void Device::set_graphics_pipeline_cache_budget(const CacheBudget &budget)
+{
+	cache_graphics_pipelines.set_budget(budget);
 }
 
 }        // namespace vkb
@@ -38,11 +38,26 @@
 
 #include "cache_resource.h"
 #include "graphics_pipeline_state.h"
+#include "pipeline_manifest.h"
+#include "platform/thread_pool.h"
 #include "render_frame.h"
 #include "render_target.h"
+#include "upload_manager.h"
 
 namespace vkb
 {
+/**
+ * @brief Counters of the graphics pipelines compiled in the background
+ */
+struct PipelineCompileStats
+{
+	/// Number of pipelines being compiled at the beginning of the frame
+	uint32_t pending{0};
+
+	/// Number of pipeline requests in the previous frame which were not ready
+	uint32_t stalled{0};
+};
+
 class Device : public NonCopyable
 {
   public:
@@ -58,9 +73,33 @@ class Device : public NonCopyable
 
 	const VkPhysicalDeviceProperties &get_properties() const;
 
+	/**
+	 * @return The features enabled when the device was created
+	 */
+	const VkPhysicalDeviceFeatures &get_features() const;
+
+	/**
+	 * @brief Checks whether an extension was enabled when the device was created,
+	 *        either requested by the sample or enabled by the framework as optional
+	 */
+	bool is_enabled(const char *extension) const;
+
+	/**
+	 * @return The maximum size of runtime sized texture arrays, or 0 if
+	 *         the device does not support the descriptor indexing they need
+	 */
+	uint32_t get_max_bindless_textures() const;
+
 	const Queue &get_queue(uint32_t queue_family_index, uint32_t queue_index);
 
-	const Queue &get_queue_by_flags(VkQueueFlags queue_flags, uint32_t queue_index);
+	const Queue &get_queue_by_flags(VkQueueFlags required_queue_flags, uint32_t queue_index);
+
+	/**
+	 * @brief Finds a queue of a family supporting the required flags but none of the excluded ones,
+	 *        for example a transfer queue which runs concurrently with the graphics queue
+	 * @return The queue, or nullptr if no queue family matches
+	 */
+	const Queue *find_dedicated_queue(VkQueueFlags required_queue_flags, VkQueueFlags excluded_queue_flags, uint32_t queue_index);
 
 	const Queue &get_queue_by_present(uint32_t queue_index);
 
@@ -92,13 +131,80 @@ class Device : public NonCopyable
 	 */
 	VkFence request_fence();
 
+	/**
+	 * @return The upload manager, streaming data to device local buffers and images
+	 */
+	UploadManager &get_upload_manager()
+	{
+		return *upload_manager;
+	}
+
 	VkResult wait_idle();
 
+	/**
+	 * @return The pipeline cache used to create every pipeline
+	 */
+	VkPipelineCache get_pipeline_cache() const;
+
+	/**
+	 * @brief Writes the content of the pipeline cache to disk,
+	 *        so that it can seed the cache on the next launch
+	 * @return True if the pipeline cache was saved successfully
+	 */
+	bool save_pipeline_cache();
+
 	PipelineLayout &request_pipeline_layout(std::vector<ShaderModule> &&shader_modules);
 
 	GraphicsPipeline &request_graphics_pipeline(GraphicsPipelineState &                   graphics_state,
 	                                            const ShaderStageMap<SpecializationInfo> &specialization_infos);
 
+	/**
+	 * @brief Requests a graphics pipeline without blocking on a cache miss.
+	 *        A missing pipeline is compiled by a worker thread, and can be
+	 *        used once a later request returns it. A pipeline which failed
+	 *        to compile is not compiled again.
+	 * @return The pipeline, or nullptr if it is still being compiled or failed to compile
+	 */
+	GraphicsPipeline *request_graphics_pipeline_async(const GraphicsPipelineState &             graphics_state,
+	                                                  const ShaderStageMap<SpecializationInfo> &specialization_infos);
+
+	/**
+	 * @return The background compilation counters of the previous frame
+	 */
+	const PipelineCompileStats &get_pipeline_compile_stats() const;
+
+	/**
+	 * @brief Enables recording of the graphics pipelines built by the device in a manifest,
+	 *        which is written to disk when the device is destroyed
+	 */
+	void set_pipeline_manifest_recording(bool enable);
+
+	/**
+	 * @return The serialized manifest of the graphics pipelines recorded so far
+	 */
+	std::vector<uint8_t> get_pipeline_manifest();
+
+	/**
+	 * @brief Writes the pipeline manifest to disk, so that the pipelines
+	 *        can be prewarmed on the next launch
+	 * @return True if the manifest was saved successfully
+	 */
+	bool save_pipeline_manifest();
+
+	/**
+	 * @brief Builds all the graphics pipelines of a manifest on the worker threads,
+	 *        and waits for them, so that the first frames do not compile any pipeline
+	 * @param manifest_data A manifest returned by get_pipeline_manifest
+	 * @return The number of pipelines built
+	 */
+	uint32_t prewarm_pipelines(const std::vector<uint8_t> &manifest_data);
+
+	/**
+	 * @brief Prewarms the pipelines of the manifest saved by a previous run, if any
+	 * @return The number of pipelines built
+	 */
+	uint32_t prewarm_pipelines();
+
 	ComputePipeline &request_compute_pipeline(const PipelineLayout &    pipeline_layout,
 	                                          const SpecializationInfo &specialization_info);
 
@@ -106,6 +212,28 @@ class Device : public NonCopyable
 	                                      const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
 	                                      const BindingMap<VkDescriptorImageInfo> & image_infos);
 
+	/**
+	 * @brief Requests a descriptor set using a hash of the bindings computed by the caller,
+	 *        which avoids hashing the binding maps on every request
+	 * @param bindings_hash Hash of the resources the descriptor set is written with
+	 */
+	DescriptorSet &request_descriptor_set(DescriptorSetLayout &                     descriptor_set_layout,
+	                                      const BindingMap<VkDescriptorBufferInfo> &buffer_infos,
+	                                      const BindingMap<VkDescriptorImageInfo> & image_infos,
+	                                      uint64_t                                  bindings_hash);
+
+	/**
+	 * @brief Requests a descriptor set identified by a key written by the caller from the bound
+	 *        resources, so that their descriptor infos are only gathered on a cache miss
+	 * @param bindings_hash Hash of the resources the descriptor set is written with
+	 * @param key Key of the resources, which must not start with the handle of the device
+	 * @param build Function building the descriptor set on a cache miss
+	 */
+	DescriptorSet &request_descriptor_set(DescriptorSetLayout &                  descriptor_set_layout,
+	                                      uint64_t                               bindings_hash,
+	                                      const CacheKey &                       key,
+	                                      const std::function<DescriptorSet()> &build);
+
 	RenderPass &request_render_pass(const std::vector<Attachment> &   attachments,
 	                                const std::vector<LoadStoreInfo> &load_store_infos,
 	                                const std::vector<SubpassInfo> &  subpasses);
@@ -118,6 +246,41 @@ class Device : public NonCopyable
 	 */
 	void clear_framebuffers();
 
+	/**
+	 * @brief Evicts the framebuffers and descriptor sets, which are identified by the handles of
+	 *        their image views, after image views were destroyed while frames may be in flight.
+	 *        Views created afterwards may reuse the same handles, and must not match them.
+	 *        The evicted resources are destroyed once the frames in flight completed.
+	 */
+	void evict_image_view_resources();
+
+	/**
+	 * @brief The resource epoch is advanced whenever a resource which recorded commands
+	 *        may reference is destroyed, such as a buffer, an image or a cached object
+	 * @return The current resource epoch
+	 */
+	uint64_t get_resource_epoch() const;
+
+	/**
+	 * @brief Advances the resource epoch, invalidating the command streams recorded before
+	 */
+	void advance_resource_epoch();
+
+	/**
+	 * @brief Marks the beginning of a frame, evicting the cached descriptor sets,
+	 *        framebuffers and graphics pipelines which exceed their budget
+	 *        and are not used by a frame still in flight, and releasing completed uploads
+	 * @param frame_index Monotonically increasing index of the frame being started
+	 * @param completed_frame Index of the latest frame which completed on the GPU along with all the frames before it
+	 */
+	void begin_frame(uint64_t frame_index, uint64_t completed_frame);
+
+	void set_descriptor_set_cache_budget(const CacheBudget &budget);
+
+	void set_framebuffer_cache_budget(const CacheBudget &budget);
+
+	void set_graphics_pipeline_cache_budget(const CacheBudget &budget);
+
   private:
 	VkPhysicalDevice physical_device{VK_NULL_HANDLE};
 
@@ -131,6 +294,32 @@ class Device : public NonCopyable
 
 	VkPhysicalDeviceProperties properties;
 
+	VkPhysicalDeviceFeatures features;
+
+	std::vector<std::string> enabled_extensions;
+
+	uint32_t max_bindless_textures{0};
+
+	VkPipelineCache pipeline_cache{VK_NULL_HANDLE};
+
+	/// Worker threads compiling the pipelines requested asynchronously
+	std::unique_ptr<ThreadPool> pipeline_compile_pool;
+
+	/// Number of asynchronous pipeline requests in the current frame which were not ready
+	std::atomic<uint32_t> stalled_pipeline_count{0};
+
+	PipelineCompileStats pipeline_compile_stats;
+
+	bool pipeline_manifest_recording{false};
+
+	/// Graphics pipelines built by the device, guarded as they may be built by worker threads
+	PipelineManifest pipeline_manifest;
+
+	std::mutex pipeline_manifest_mutex;
+
+	/// Advanced by the destruction of resources, which may happen on any thread
+	std::atomic<uint64_t> resource_epoch{0};
+
 	std::vector<std::vector<Queue>> queues;
 
 	/// A command pool associated to the primary queue
@@ -139,6 +328,8 @@ class Device : public NonCopyable
 	/// A fence pool associated to the primary queue
 	std::unique_ptr<FencePool> fence_pool;
 
+	std::unique_ptr<UploadManager> upload_manager;
+
 	CacheResource<PipelineLayout> cache_pipeline_layouts;
 
 	CacheResource<GraphicsPipeline> cache_graphics_pipelines;
@@ -150,6 +341,12 @@ class Device : public NonCopyable
 	CacheResource<RenderPass> cache_render_passes;
 
 	CacheResource<Framebuffer> cache_framebuffers;
+
+	/// Builds a graphics pipeline on a cache miss, recording it in the manifest if enabled
+	GraphicsPipeline build_graphics_pipeline(uint64_t pipeline_hash, GraphicsPipelineState &graphics_state, const ShaderStageMap<SpecializationInfo> &specialization_infos);
+
+	/// Returns the cached pipeline, or dispatches its build to the worker threads, setting pending_build to its completion
+	GraphicsPipeline *dispatch_graphics_pipeline(uint64_t pipeline_hash, const GraphicsPipelineState &graphics_state, const ShaderStageMap<SpecializationInfo> &specialization_infos, std::shared_future<void> *pending_build = nullptr);
 };
 
 }        // namespace vkb
@@ -277,9 +474,9 @@ struct hash<vkb::SpecializationInfo>
 	{
 		std::size_t result = 0;
 
-		auto data = specialization_info.get_data();
+		auto &data = specialization_info.get_data();
 
-		vkb::hash_combine(result, std::string(data.begin(), data.end()));
+		vkb::hash_combine(result, vkb::hash_bytes(data.data(), data.size()));
 
 		for (auto &map_entry : specialization_info.get_map_entries())
 		{
@@ -483,76 +680,7 @@ struct hash<vkb::GraphicsPipelineState>
 {
 	std::size_t operator()(const vkb::GraphicsPipelineState &graphics_state) const
 	{
-		std::size_t result = 0;
-
-		vkb::hash_combine(result, graphics_state.get_pipeline_layout().get_handle());
-		vkb::hash_combine(result, graphics_state.get_render_pass().get_handle());
-		vkb::hash_combine(result, graphics_state.get_subpass_index());
-
-		for (auto &stage : graphics_state.get_pipeline_layout().get_stages())
-		{
-			vkb::hash_combine(result, stage.get_handle());
-		}
-
-		// VkPipelineVertexInputStateCreateInfo
-		for (auto &attribute : graphics_state.get_vertex_input_state().attributes)
-		{
-			vkb::hash_combine(result, attribute);
-		}
-
-		for (auto &binding : graphics_state.get_vertex_input_state().bindings)
-		{
-			vkb::hash_combine(result, binding);
-		}
-
-		// VkPipelineInputAssemblyStateCreateInfo
-
-		vkb::hash_combine(result, graphics_state.get_input_assembly_state().primitive_restart_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkPrimitiveTopology>::type>(graphics_state.get_input_assembly_state().topology));
-
-		//VkPipelineViewportStateCreateInfo
-		vkb::hash_combine(result, graphics_state.get_viewport_state().viewport_count);
-		vkb::hash_combine(result, graphics_state.get_viewport_state().scissor_count);
-
-		// VkPipelineRasterizationStateCreateInfo
-
-		vkb::hash_combine(result, graphics_state.get_rasterization_state().cull_mode);
-		vkb::hash_combine(result, graphics_state.get_rasterization_state().depth_bias_enable);
-		vkb::hash_combine(result, graphics_state.get_rasterization_state().depth_clamp_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkFrontFace>::type>(graphics_state.get_rasterization_state().front_face));
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkPolygonMode>::type>(graphics_state.get_rasterization_state().polygon_mode));
-		vkb::hash_combine(result, graphics_state.get_rasterization_state().rasterizer_discard_enable);
-
-		// VkPipelineMultisampleStateCreateInfo
-
-		vkb::hash_combine(result, graphics_state.get_multisample_state().alpha_to_coverage_enable);
-		vkb::hash_combine(result, graphics_state.get_multisample_state().alpha_to_one_enable);
-		vkb::hash_combine(result, graphics_state.get_multisample_state().min_sample_shading);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkSampleCountFlagBits>::type>(graphics_state.get_multisample_state().rasterization_samples));
-		vkb::hash_combine(result, graphics_state.get_multisample_state().sample_shading_enable);
-		vkb::hash_combine(result, graphics_state.get_multisample_state().sample_mask);
-
-		// VkPipelineDepthStencilStateCreateInfo
-
-		vkb::hash_combine(result, graphics_state.get_depth_stencil_state().back);
-		vkb::hash_combine(result, graphics_state.get_depth_stencil_state().depth_bounds_test_enable);
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkCompareOp>::type>(graphics_state.get_depth_stencil_state().depth_compare_op));
-		vkb::hash_combine(result, graphics_state.get_depth_stencil_state().depth_test_enable);
-		vkb::hash_combine(result, graphics_state.get_depth_stencil_state().depth_write_enable);
-		vkb::hash_combine(result, graphics_state.get_depth_stencil_state().front);
-		vkb::hash_combine(result, graphics_state.get_depth_stencil_state().stencil_test_enable);
-
-		// VkPipelineColorBlendStateCreateInfo
-
-		vkb::hash_combine(result, static_cast<std::underlying_type<VkLogicOp>::type>(graphics_state.get_color_blend_state().logic_op));
-		vkb::hash_combine(result, graphics_state.get_color_blend_state().logic_op_enable);
-
-		for (auto &attachment : graphics_state.get_color_blend_state().attachments)
-		{
-			vkb::hash_combine(result, attachment);
-		}
-
-		return result;
+		return static_cast<std::size_t>(graphics_state.get_hash());
 	}
 };
 }        // namespace std
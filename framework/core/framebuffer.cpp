@@ -29,8 +29,14 @@ VkFramebuffer Framebuffer::get_handle() const
 	return handle;
 }
 
+size_t Framebuffer::get_size() const
+{
+	return sizeof(Framebuffer) + attachment_count * sizeof(VkImageView);
+}
+
 Framebuffer::Framebuffer(Device &device, const RenderTarget &render_target, const RenderPass &render_pass) :
-    device{device}
+    device{device},
+    attachment_count{to_u32(render_target.get_views().size())}
 {
 	auto &extent = render_target.get_extent();
 
@@ -60,7 +66,8 @@ Framebuffer::Framebuffer(Device &device, const RenderTarget &render_target, cons
 
 Framebuffer::Framebuffer(Framebuffer &&other) :
     device{other.device},
-    handle{other.handle}
+    handle{other.handle},
+    attachment_count{other.attachment_count}
 {
 	other.handle = VK_NULL_HANDLE;
 }
@@ -38,9 +38,16 @@ class Framebuffer : public NonCopyable
 
 	VkFramebuffer get_handle() const;
 
+	/**
+	 * @return Estimated memory used by the framebuffer, which only references the memory of its attachments
+	 */
+	size_t get_size() const;
+
   private:
 	Device &device;
 
 	VkFramebuffer handle{VK_NULL_HANDLE};
+
+	uint32_t attachment_count{0};
 };
 }        // namespace vkb
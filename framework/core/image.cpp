@@ -118,7 +118,10 @@ Image::Image(Device &device, VkImage handle, const VkExtent3D &extent, VkFormat
     extent{extent},
     format{format},
     samples{VK_SAMPLE_COUNT_1_BIT}
-{}
+{
+	// Swapchain images are used once acquired, which the frame waits for at this stage
+	access.stage_mask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+}
 
 Image::Image(Image &&other) :
     device{other.device},
@@ -127,7 +130,8 @@ Image::Image(Image &&other) :
     type{other.type},
     extent{other.extent},
     format{other.format},
-    samples{other.samples}
+    samples{other.samples},
+    access{other.access}
 {
 	other.handle = VK_NULL_HANDLE;
 	other.memory = VK_NULL_HANDLE;
@@ -139,6 +143,12 @@ Image::~Image()
 	{
 		vmaDestroyImage(device.get_memory_allocator(), handle, memory);
 	}
+
+	// Swapchain images are not destroyed here, but are no longer used either
+	if (handle != VK_NULL_HANDLE)
+	{
+		device.advance_resource_epoch();
+	}
 }
 
 const Device &Image::get_device() const
@@ -175,5 +185,15 @@ VkSampleCountFlagBits Image::get_samples() const
 {
 	return samples;
 }
+
+const ImageAccess &Image::get_access() const
+{
+	return access;
+}
+
+void Image::set_access(const ImageAccess &new_access) const
+{
+	access = new_access;
+}
 }        // namespace core
 }        // namespace vkb
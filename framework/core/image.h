@@ -61,6 +61,17 @@ class Image : public NonCopyable
 
 	VkSampleCountFlagBits get_samples() const;
 
+	/**
+	 * @return The access of the image by the last recorded command using it,
+	 *         from which the barrier of the next command is derived
+	 */
+	const ImageAccess &get_access() const;
+
+	/**
+	 * @brief Updates the tracked access of the image, as commands are recorded
+	 */
+	void set_access(const ImageAccess &access) const;
+
   private:
 	Device &device;
 
@@ -75,6 +86,9 @@ class Image : public NonCopyable
 	VkFormat format{};
 
 	VkSampleCountFlagBits samples{};
+
+	/// Tracked while recording, which happens in submission order on the thread owning the frame
+	mutable ImageAccess access;
 };
 }        // namespace core
 }        // namespace vkb
@@ -76,7 +76,7 @@ ComputePipeline::ComputePipeline(Device &                  device,
 	create_info.layout = pipeline_layout.get_handle();
 	create_info.stage  = stage;
 
-	VkResult result = vkCreateComputePipelines(device.get_handle(), VK_NULL_HANDLE, 1, &create_info, 0, &handle);
+	VkResult result = vkCreateComputePipelines(device.get_handle(), device.get_pipeline_cache(), 1, &create_info, 0, &handle);
 
 	if (result != VK_SUCCESS)
 	{
@@ -108,6 +108,8 @@ GraphicsPipeline::GraphicsPipeline(Device &                                  dev
 		}
 
 		stage_create_infos.push_back(stage_create_info);
+
+		size += shader_module.get_binary().size() * sizeof(uint32_t);
 	}
 
 	VkGraphicsPipelineCreateInfo create_info{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
@@ -221,11 +223,16 @@ GraphicsPipeline::GraphicsPipeline(Device &                                  dev
 	create_info.renderPass = graphics_state.get_render_pass().get_handle();
 	create_info.subpass    = graphics_state.get_subpass_index();
 
-	auto result = vkCreateGraphicsPipelines(device.get_handle(), VK_NULL_HANDLE, 1, &create_info, NULL, &handle);
+	auto result = vkCreateGraphicsPipelines(device.get_handle(), device.get_pipeline_cache(), 1, &create_info, NULL, &handle);
 
 	if (result != VK_SUCCESS)
 	{
 		throw VulkanException{result, "Cannot create GraphicsPipelines"};
 	}
 }
+
+size_t GraphicsPipeline::get_size() const
+{
+	return size;
+}
 }        // namespace vkb
@@ -71,5 +71,14 @@ class GraphicsPipeline : public Pipeline
 	GraphicsPipeline(Device &                                  device,
 	                 GraphicsPipelineState &                   graphics_state,
 	                 const ShaderStageMap<SpecializationInfo> &specialization_infos);
+
+	/**
+	 * @return Estimated memory used by the pipeline, taking the size of the SPIR-V
+	 *         of its stages as that of the code compiled from them
+	 */
+	size_t get_size() const;
+
+  private:
+	size_t size{sizeof(GraphicsPipeline)};
 };
 }        // namespace vkb
@@ -52,6 +52,9 @@ PipelineLayout::PipelineLayout(Device &device, std::vector<ShaderModule> &&stage
 			{
 				// Append stage flags if resource already exists
 				it->second.stages |= resource.stages;
+
+				// A buffer is bound with a dynamic offset if any stage declares it so
+				it->second.dynamic |= resource.dynamic;
 			}
 			else
 			{
@@ -61,6 +64,16 @@ PipelineLayout::PipelineLayout(Device &device, std::vector<ShaderModule> &&stage
 		}
 	}
 
+	// Collect the vertex input attributes
+	for (auto &it : resources)
+	{
+		if (it.second.stages == VK_SHADER_STAGE_VERTEX_BIT &&
+		    it.second.type == ShaderResourceType::Input)
+		{
+			vertex_input_attributes.push_back(it.second);
+		}
+	}
+
 	// Separate all resources by set index
 	for (auto &it : resources)
 	{
@@ -144,6 +157,7 @@ PipelineLayout::PipelineLayout(PipelineLayout &&other) :
     stages{std::move(other.stages)},
     handle{other.handle},
     resources{std::move(other.resources)},
+    vertex_input_attributes{std::move(other.vertex_input_attributes)},
     set_bindings{std::move(other.set_bindings)},
     set_layouts{std::move(other.set_layouts)}
 {
@@ -169,6 +183,21 @@ const std::vector<ShaderModule> &PipelineLayout::get_stages() const
 	return stages;
 }
 
+size_t PipelineLayout::get_size() const
+{
+	size_t size = sizeof(PipelineLayout);
+
+	for (auto &shader_module : stages)
+	{
+		size += sizeof(ShaderModule) + shader_module.get_binary().size() * sizeof(uint32_t);
+	}
+
+	size += (resources.size() + vertex_input_attributes.size()) * sizeof(ShaderResource);
+	size += set_layouts.size() * sizeof(DescriptorSetLayout);
+
+	return size;
+}
+
 const std::unordered_map<uint32_t, std::vector<ShaderResource>> &PipelineLayout::get_bindings() const
 {
 	return set_bindings;
@@ -189,20 +218,8 @@ DescriptorSetLayout &PipelineLayout::get_set_layout(uint32_t set_index)
 	return set_layouts.at(set_index);
 }
 
-std::vector<ShaderResource> PipelineLayout::get_vertex_input_attributes() const
+const std::vector<ShaderResource> &PipelineLayout::get_vertex_input_attributes() const
 {
-	std::vector<ShaderResource> vertex_input_attributes;
-
-	// Iterate over all resources
-	for (auto it : resources)
-	{
-		if (it.second.stages == VK_SHADER_STAGE_VERTEX_BIT &&
-		    it.second.type == ShaderResourceType::Input)
-		{
-			vertex_input_attributes.push_back(it.second);
-		}
-	}
-
 	return vertex_input_attributes;
 }
 
@@ -55,7 +55,11 @@ class PipelineLayout : public NonCopyable
 
 	DescriptorSetLayout &get_set_layout(uint32_t set_index);
 
-	std::vector<ShaderResource> get_vertex_input_attributes() const;
+	/**
+	 * @return The vertex shader inputs, collected once when the layout is created
+	 *         so that drawing does not allocate a copy for each draw call
+	 */
+	const std::vector<ShaderResource> &get_vertex_input_attributes() const;
 
 	std::vector<ShaderResource> get_fragment_output_attachments() const;
 
@@ -63,6 +67,11 @@ class PipelineLayout : public NonCopyable
 
 	VkShaderStageFlags get_push_constant_range_stage(uint32_t offset, uint32_t size) const;
 
+	/**
+	 * @return Estimated memory used by the layout, dominated by the SPIR-V of the shader modules it keeps
+	 */
+	size_t get_size() const;
+
   private:
 	Device &device;
 
@@ -72,6 +81,8 @@ class PipelineLayout : public NonCopyable
 
 	std::map<std::string, ShaderResource> resources;
 
+	std::vector<ShaderResource> vertex_input_attributes;
+
 	std::unordered_map<uint32_t, std::vector<ShaderResource>> set_bindings;
 
 	std::unordered_map<uint32_t, DescriptorSetLayout> set_layouts;
@@ -82,6 +82,8 @@ VkBool32 Queue::support_present() const
 
 VkResult Queue::submit(const std::vector<VkSubmitInfo> &submit_infos, VkFence fence) const
 {
+	std::lock_guard<std::mutex> lock{mutex};
+
 	return vkQueueSubmit(handle, to_u32(submit_infos.size()), submit_infos.data(), fence);
 }
 
@@ -101,11 +103,15 @@ VkResult Queue::present(const VkPresentInfoKHR &present_info) const
 		return VK_ERROR_INCOMPATIBLE_DISPLAY_KHR;
 	}
 
+	std::lock_guard<std::mutex> lock{mutex};
+
 	return vkQueuePresentKHR(handle, &present_info);
 }        // namespace vkb
 
 VkResult Queue::wait_idle() const
 {
+	std::lock_guard<std::mutex> lock{mutex};
+
 	return vkQueueWaitIdle(handle);
 }
 }        // namespace vkb
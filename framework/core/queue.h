@@ -24,6 +24,8 @@
 #include "common.h"
 #include "core/swapchain.h"
 
+#include <mutex>
+
 namespace vkb
 {
 class Device;
@@ -68,5 +70,8 @@ class Queue : NonCopyable
 	VkBool32 can_present{VK_FALSE};
 
 	VkQueueFamilyProperties properties{};
+
+	/// Queue operations must be externally synchronized, as the queue may be used from several threads
+	mutable std::mutex mutex;
 };
 }        // namespace vkb
@@ -31,7 +31,10 @@ VkRenderPass RenderPass::get_handle() const
 }
 
 RenderPass::RenderPass(Device &device, const std::vector<Attachment> &attachments, const std::vector<LoadStoreInfo> &load_store_infos, const std::vector<SubpassInfo> &subpasses) :
-    device{device}
+    device{device},
+    attachments{attachments},
+    load_store_infos{load_store_infos},
+    subpasses{subpasses}
 {
 	uint32_t depth_stencil_attachment{VK_ATTACHMENT_UNUSED};
 
@@ -60,142 +63,129 @@ RenderPass::RenderPass(Device &device, const std::vector<Attachment> &attachment
 		attachment_descriptions.push_back(std::move(attachment));
 	}
 
-	std::vector<VkSubpassDescription>  subpass_descriptions;
-	std::vector<VkAttachmentReference> input_attachments;
-	std::vector<VkAttachmentReference> color_attachments;
-	std::vector<VkAttachmentReference> depth_stencil_attachments;
+	// A render pass without subpass information has a single subpass writing to every attachment
+	size_t subpass_count = std::max<size_t>(1, subpasses.size());
 
-	for (uint32_t i = 0U; i < subpasses.size(); ++i)
-	{
-		VkSubpassDescription subpass_description{};
-		subpass_description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	// Each subpass points to its own references, which are all filled before taking their address
+	std::vector<std::vector<VkAttachmentReference>> input_attachments(subpass_count);
+	std::vector<std::vector<VkAttachmentReference>> color_attachments(subpass_count);
+	std::vector<std::vector<VkAttachmentReference>> depth_stencil_attachments(subpass_count);
 
+	for (size_t i = 0U; i < subpasses.size(); ++i)
+	{
 		for (uint32_t k : subpasses[i].input_attachments)
 		{
 			if (is_depth_stencil_format(attachment_descriptions[k].format))
 			{
-				input_attachments.push_back({k, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL});
+				input_attachments[i].push_back({k, VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL});
 			}
 			else
 			{
-				input_attachments.push_back({k, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
-			}
-
-			if (!subpass_description.pInputAttachments)
-			{
-				subpass_description.pInputAttachments = &(*input_attachments.rbegin());
+				input_attachments[i].push_back({k, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL});
 			}
 		}
 
-		subpass_description.inputAttachmentCount = to_u32(subpasses[i].input_attachments.size());
-
-		for (auto k : subpasses[i].output_attachments)
+		for (uint32_t k : subpasses[i].output_attachments)
 		{
-			if (k == depth_stencil_attachment)
+			if (k != depth_stencil_attachment)
 			{
-				continue;
+				color_attachments[i].push_back({k, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
 			}
+		}
+	}
 
-			color_attachments.push_back({k, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
-
-			if (!subpass_description.pColorAttachments)
+	if (subpasses.empty())
+	{
+		for (uint32_t k = 0U; k < attachment_descriptions.size(); ++k)
+		{
+			if (k != depth_stencil_attachment)
 			{
-				subpass_description.pColorAttachments = &(*color_attachments.rbegin());
+				color_attachments[0].push_back({k, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
 			}
 		}
+	}
 
-		if (depth_stencil_attachment != VK_ATTACHMENT_UNUSED)
+	if (depth_stencil_attachment != VK_ATTACHMENT_UNUSED)
+	{
+		for (auto &depth_stencil_references : depth_stencil_attachments)
 		{
-			depth_stencil_attachments.push_back({depth_stencil_attachment, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
-
-			subpass_description.pDepthStencilAttachment = &(*depth_stencil_attachments.rbegin());
+			depth_stencil_references.push_back({depth_stencil_attachment, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
 		}
-
-		subpass_description.colorAttachmentCount = to_u32(subpasses[i].output_attachments.size());
-
-		subpass_descriptions.push_back(subpass_description);
 	}
 
-	if (subpasses.empty())
+	std::vector<VkSubpassDescription> subpass_descriptions;
+
+	for (size_t i = 0U; i < subpass_count; ++i)
 	{
 		VkSubpassDescription subpass_description{};
 		subpass_description.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
 
-		for (uint32_t k = 0U; k < attachment_descriptions.size(); ++k)
-		{
-			if (k == depth_stencil_attachment)
-			{
-				continue;
-			}
+		subpass_description.inputAttachmentCount = to_u32(input_attachments[i].size());
+		subpass_description.pInputAttachments    = input_attachments[i].empty() ? nullptr : input_attachments[i].data();
 
-			color_attachments.push_back({k, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL});
+		subpass_description.colorAttachmentCount = to_u32(color_attachments[i].size());
+		subpass_description.pColorAttachments    = color_attachments[i].empty() ? nullptr : color_attachments[i].data();
 
-			if (!subpass_description.pColorAttachments)
-			{
-				subpass_description.pColorAttachments = &(*color_attachments.rbegin());
-			}
-		}
-
-		if (depth_stencil_attachment != VK_ATTACHMENT_UNUSED)
-		{
-			depth_stencil_attachments.push_back({depth_stencil_attachment, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL});
-
-			subpass_description.pDepthStencilAttachment = &(*depth_stencil_attachments.rbegin());
-		}
+		subpass_description.pDepthStencilAttachment = depth_stencil_attachments[i].empty() ? nullptr : depth_stencil_attachments[i].data();
 
 		subpass_descriptions.push_back(subpass_description);
 	}
 
-	// Make the initial layout same as the first subpass layout
-	{
-		const VkSubpassDescription &subpass = subpass_descriptions.front();
+	// Make the initial layout same as the layout of the first subpass using the attachment,
+	// and the final layout same as the layout of the last one
+	std::vector<bool> attachment_used(attachment_descriptions.size(), false);
 
-		for (uint32_t k = 0U; k < subpass.colorAttachmentCount; ++k)
+	auto set_layouts = [&](const std::vector<VkAttachmentReference> &references) {
+		for (auto &reference : references)
 		{
-			VkAttachmentReference reference = subpass.pColorAttachments[k];
+			auto &attachment = attachment_descriptions[reference.attachment];
 
-			attachment_descriptions[reference.attachment].initialLayout = reference.layout;
-		}
+			if (!attachment_used[reference.attachment])
+			{
+				attachment.initialLayout = reference.layout;
 
-		for (uint32_t k = 0U; k < subpass.inputAttachmentCount; ++k)
-		{
-			VkAttachmentReference reference = subpass.pInputAttachments[k];
+				attachment_used[reference.attachment] = true;
+			}
 
-			attachment_descriptions[reference.attachment].initialLayout = reference.layout;
+			attachment.finalLayout = reference.layout;
 		}
+	};
 
-		if (subpass.pDepthStencilAttachment)
-		{
-			VkAttachmentReference reference = *subpass.pDepthStencilAttachment;
-
-			attachment_descriptions[reference.attachment].initialLayout = reference.layout;
-		}
+	for (size_t i = 0U; i < subpass_count; ++i)
+	{
+		set_layouts(color_attachments[i]);
+		set_layouts(input_attachments[i]);
+		set_layouts(depth_stencil_attachments[i]);
 	}
 
-	// Make the final layout same as the last subpass layout
+	// The final layout cannot be undefined, even for attachments no subpass uses
+	for (uint32_t k = 0U; k < attachment_descriptions.size(); ++k)
 	{
-		const VkSubpassDescription &subpass = subpass_descriptions.back();
-
-		for (uint32_t k = 0U; k < subpass.colorAttachmentCount; ++k)
+		if (!attachment_used[k])
 		{
-			VkAttachmentReference reference = subpass.pColorAttachments[k];
-
-			attachment_descriptions[reference.attachment].finalLayout = reference.layout;
+			attachment_descriptions[k].finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 		}
+	}
 
-		for (uint32_t k = 0U; k < subpass.inputAttachmentCount; ++k)
-		{
-			VkAttachmentReference reference = subpass.pInputAttachments[k];
+	// Attachments written by a subpass are read as input attachments, or written again, by the next one
+	std::vector<VkSubpassDependency> subpass_dependencies;
 
-			attachment_descriptions[reference.attachment].finalLayout = reference.layout;
-		}
+	for (uint32_t i = 1U; i < subpass_count; ++i)
+	{
+		VkSubpassDependency dependency{};
 
-		if (subpass.pDepthStencilAttachment)
-		{
-			VkAttachmentReference reference = *subpass.pDepthStencilAttachment;
+		dependency.srcSubpass    = i - 1;
+		dependency.dstSubpass    = i;
+		dependency.srcStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		dependency.dstStageMask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		dependency.dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT |
+		                           VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+		                           VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
-			attachment_descriptions[reference.attachment].finalLayout = reference.layout;
-		}
+		dependency.dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+		subpass_dependencies.push_back(dependency);
 	}
 
 	VkRenderPassCreateInfo create_info{VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
@@ -204,6 +194,8 @@ RenderPass::RenderPass(Device &device, const std::vector<Attachment> &attachment
 	create_info.pAttachments    = attachment_descriptions.data();
 	create_info.subpassCount    = to_u32(subpass_descriptions.size());
 	create_info.pSubpasses      = subpass_descriptions.data();
+	create_info.dependencyCount = to_u32(subpass_dependencies.size());
+	create_info.pDependencies   = subpass_dependencies.data();
 
 	auto result = vkCreateRenderPass(device.get_handle(), &create_info, nullptr, &handle);
 
@@ -215,11 +207,29 @@ RenderPass::RenderPass(Device &device, const std::vector<Attachment> &attachment
 
 RenderPass::RenderPass(RenderPass &&other) :
     device{other.device},
-    handle{other.handle}
+    handle{other.handle},
+    attachments{std::move(other.attachments)},
+    load_store_infos{std::move(other.load_store_infos)},
+    subpasses{std::move(other.subpasses)}
 {
 	other.handle = VK_NULL_HANDLE;
 }
 
+const std::vector<Attachment> &RenderPass::get_attachments() const
+{
+	return attachments;
+}
+
+const std::vector<LoadStoreInfo> &RenderPass::get_load_store_infos() const
+{
+	return load_store_infos;
+}
+
+const std::vector<SubpassInfo> &RenderPass::get_subpasses() const
+{
+	return subpasses;
+}
+
 RenderPass::~RenderPass()
 {
 	// Destroy render pass
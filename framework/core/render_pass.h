@@ -21,10 +21,10 @@
 #pragma once
 
 #include "common.h"
+#include "render_target.h"
 
 namespace vkb
 {
-struct Attachment;
 class Device;
 
 struct LoadStoreInfo
@@ -55,9 +55,22 @@ class RenderPass : public NonCopyable
 
 	~RenderPass();
 
+	const std::vector<Attachment> &get_attachments() const;
+
+	const std::vector<LoadStoreInfo> &get_load_store_infos() const;
+
+	const std::vector<SubpassInfo> &get_subpasses() const;
+
   private:
 	Device &device;
 
 	VkRenderPass handle{VK_NULL_HANDLE};
+
+	// Creation parameters, kept so that the render pass can be recreated (e.g. by the pipeline manifest)
+	std::vector<Attachment> attachments;
+
+	std::vector<LoadStoreInfo> load_store_infos;
+
+	std::vector<SubpassInfo> subpasses;
 };
 }        // namespace vkb
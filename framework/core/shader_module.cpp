@@ -20,12 +20,72 @@
 
 #include "shader_module.h"
 
+#include <iomanip>
+
 #include "device.h"
 #include "glsl_compiler.h"
+#include "shader_binary.h"
 #include "spirv_reflection.h"
 
 namespace vkb
 {
+namespace
+{
+/// Name of the file caching the shader of the given key in the temporary directory
+std::string get_shader_cache_filename(uint64_t key)
+{
+	std::stringstream filename;
+
+	filename << "shader_" << std::hex << std::setw(16) << std::setfill('0') << key << ".cache";
+
+	return filename.str();
+}
+
+/**
+ * @brief Reads the SPIR-V and the reflected resources of a shader compiled by a previous run
+ * @return False if the shader is not cached, or if its cache file is invalid
+ */
+bool load_cached_shader(uint64_t key, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources)
+{
+	std::vector<uint8_t> data = read_temp_file(get_shader_cache_filename(key));
+
+	if (data.empty())
+	{
+		return false;
+	}
+
+	try
+	{
+		if (deserialize_shader(data, spirv, resources) != key)
+		{
+			throw std::runtime_error("Key does not match");
+		}
+	}
+	catch (const std::exception &e)
+	{
+		LOGW("Shader cache file is invalid (%s), ignoring it", e.what());
+
+		spirv.clear();
+		resources.clear();
+
+		return false;
+	}
+
+	return true;
+}
+
+/**
+ * @brief Writes the SPIR-V and the reflected resources of a shader, so that the next runs skip compiling and reflecting it
+ */
+void save_cached_shader(uint64_t key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources)
+{
+	if (!write_temp_file(serialize_shader(key, spirv, resources), get_shader_cache_filename(key)))
+	{
+		LOGW("Cannot write shader cache file");
+	}
+}
+}        // namespace
+
 ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const std::vector<uint8_t> &glsl_source, const std::string &entry_point) :
     device{device},
     stage{stage},
@@ -43,6 +103,16 @@ ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const st
 		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
 	}
 
+	// The cache is addressed by everything the SPIR-V depends on
+	uint64_t cache_key = get_shader_key(stage, glsl_source, entry_point);
+
+	// Shaders compiled by a previous run skip both compilation and reflection
+	if (load_cached_shader(cache_key, spirv, resources))
+	{
+		create();
+		return;
+	}
+
 	GLSLCompiler glsl_compiler;
 
 	// Compile the GLSL source
@@ -51,31 +121,48 @@ ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const st
 		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
 	}
 
-	SPIRVReflection spirv_reflection;
+	reflect();
 
-	// Reflect all shader resouces
-	if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources))
+	save_cached_shader(cache_key, spirv, resources);
+
+	create();
+}
+
+ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const std::vector<uint32_t> &spirv, const std::string &entry_point) :
+    device{device},
+    stage{stage},
+    entry_point{entry_point},
+    spirv{spirv}
+{
+	if (spirv.empty() || entry_point.empty())
 	{
 		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
 	}
 
-	// Create the Vulkan handle
-	VkShaderModuleCreateInfo vk_create_info{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
-
-	vk_create_info.codeSize = spirv.size() * sizeof(uint32_t);
-	vk_create_info.pCode    = spirv.data();
+	reflect();
 
-	VkResult result = vkCreateShaderModule(device.get_handle(), &vk_create_info, nullptr, &handle);
+	create();
+}
 
-	if (result != VK_SUCCESS)
+ShaderModule::ShaderModule(Device &device, VkShaderStageFlagBits stage, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources, const std::string &entry_point) :
+    device{device},
+    stage{stage},
+    entry_point{entry_point},
+    spirv{spirv},
+    resources{resources}
+{
+	if (spirv.empty() || entry_point.empty())
 	{
-		throw VulkanException{result};
+		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
 	}
+
+	create();
 }
 
 ShaderModule::ShaderModule(ShaderModule &&other) :
     device{other.device},
     handle{other.handle},
+    id{other.id},
     stage{other.stage},
     entry_point{other.entry_point},
     spirv{other.spirv},
@@ -101,6 +188,11 @@ VkShaderModule ShaderModule::get_handle() const
 	return handle;
 }
 
+uint64_t ShaderModule::get_id() const
+{
+	return id;
+}
+
 VkShaderStageFlagBits ShaderModule::get_stage() const
 {
 	return stage;
@@ -116,6 +208,25 @@ const std::vector<ShaderResource> &ShaderModule::get_resources() const
 	return resources;
 }
 
+void ShaderModule::set_resource_dynamic(const std::string &resource_name)
+{
+	auto it = std::find_if(resources.begin(), resources.end(), [&resource_name](const ShaderResource &resource) {
+		return resource.name == resource_name &&
+		       (resource.type == ShaderResourceType::BufferUniform || resource.type == ShaderResourceType::BufferStorage);
+	});
+
+	if (it == resources.end())
+	{
+		LOGW("Buffer %s not found in shader, it cannot be bound with a dynamic offset", resource_name.c_str());
+		return;
+	}
+
+	it->dynamic = true;
+
+	// Descriptor set layouts differ from those of the same shader without dynamic offsets
+	update_id();
+}
+
 const std::string &ShaderModule::get_info_log() const
 {
 	return info_log;
@@ -126,4 +237,48 @@ const std::vector<uint32_t> &ShaderModule::get_binary() const
 	return spirv;
 }
 
+void ShaderModule::reflect()
+{
+	SPIRVReflection spirv_reflection;
+
+	// Reflect all shader resouces
+	if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources))
+	{
+		throw VulkanException{VK_ERROR_INITIALIZATION_FAILED};
+	}
+}
+
+void ShaderModule::create()
+{
+	update_id();
+
+	// Create the Vulkan handle
+	VkShaderModuleCreateInfo vk_create_info{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+
+	vk_create_info.codeSize = spirv.size() * sizeof(uint32_t);
+	vk_create_info.pCode    = spirv.data();
+
+	VkResult result = vkCreateShaderModule(device.get_handle(), &vk_create_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result};
+	}
+}
+
+void ShaderModule::update_id()
+{
+	id = hash_bytes(spirv.data(), spirv.size() * sizeof(uint32_t));
+	id = hash_mix(id, stage);
+	id = hash_bytes(entry_point.data(), entry_point.size(), id);
+
+	for (auto &resource : resources)
+	{
+		if (resource.dynamic)
+		{
+			id = hash_bytes(resource.name.data(), resource.name.size(), id);
+		}
+	}
+}
+
 }        // namespace vkb
@@ -68,29 +68,69 @@ struct ShaderResource
 
 	uint32_t size;
 
+	/// Whether a uniform or storage buffer is bound with a dynamic offset
+	bool dynamic;
+
 	std::string name;
 };
 
 class ShaderModule : public NonCopyable
 {
   public:
+	/**
+	 * @brief Compiles a shader from GLSL source. The SPIR-V and the reflected resources are cached
+	 *        in the temporary directory, so that the next runs skip compiling and reflecting it.
+	 */
 	ShaderModule(Device &                    device,
 	             VkShaderStageFlagBits       stage,
 	             const std::vector<uint8_t> &glsl_source,
 	             const std::string &         entry_point);
 
+	/**
+	 * @brief Creates a shader module from already compiled SPIR-V
+	 */
+	ShaderModule(Device &                     device,
+	             VkShaderStageFlagBits        stage,
+	             const std::vector<uint32_t> &spirv,
+	             const std::string &          entry_point);
+
+	/**
+	 * @brief Creates a shader module from SPIR-V and resources reflected beforehand,
+	 *        such as a shader precompiled at build time
+	 */
+	ShaderModule(Device &                           device,
+	             VkShaderStageFlagBits              stage,
+	             const std::vector<uint32_t> &      spirv,
+	             const std::vector<ShaderResource> &resources,
+	             const std::string &                entry_point);
+
 	ShaderModule(ShaderModule &&other);
 
 	~ShaderModule();
 
 	VkShaderModule get_handle() const;
 
+	/**
+	 * @return Identifier computed from the stage, entry point, SPIR-V and the names
+	 *         of the buffers bound with dynamic offsets, which is equal for modules
+	 *         built from the same shader
+	 */
+	uint64_t get_id() const;
+
 	VkShaderStageFlagBits get_stage() const;
 
 	const std::string &get_entry_point() const;
 
 	const std::vector<ShaderResource> &get_resources() const;
 
+	/**
+	 * @brief Marks a uniform or storage buffer to be bound with a dynamic offset, so that
+	 *        binding the buffer at another offset reuses the same descriptor set.
+	 *        Must be called before the module is used to request a pipeline layout.
+	 * @param resource_name Name of the buffer in the shader
+	 */
+	void set_resource_dynamic(const std::string &resource_name);
+
 	const std::string &get_info_log() const;
 
 	const std::vector<uint32_t> &get_binary() const;
@@ -100,6 +140,8 @@ class ShaderModule : public NonCopyable
 
 	VkShaderModule handle{VK_NULL_HANDLE};
 
+	uint64_t id{0};
+
 	VkShaderStageFlagBits stage{};
 
 	std::string entry_point;
@@ -109,5 +151,14 @@ class ShaderModule : public NonCopyable
 	std::vector<ShaderResource> resources;
 
 	std::string info_log;
+
+	/// Reflects the resources of the SPIR-V
+	void reflect();
+
+	/// Creates the Vulkan handle from the SPIR-V and its resources
+	void create();
+
+	/// Computes the id from the SPIR-V and the buffers bound with dynamic offsets
+	void update_id();
 };
 }        // namespace vkb
@@ -32,6 +32,11 @@ namespace vkb
 {
 namespace
 {
+const EShMessages GLSL_MESSAGES = static_cast<EShMessages>(EShMsgDefault | EShMsgVulkanRules | EShMsgSpvRules);
+
+/// Version of the sources which do not declare one
+const int GLSL_DEFAULT_VERSION = 100;
+
 inline EShLanguage FindShaderLanguage(VkShaderStageFlagBits stage)
 {
 	switch (stage)
@@ -69,7 +74,7 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
 	// Initialize glslang library.
 	glslang::InitializeProcess();
 
-	EShMessages messages = static_cast<EShMessages>(EShMsgDefault | EShMsgVulkanRules | EShMsgSpvRules);
+	EShMessages messages = GLSL_MESSAGES;
 
 	EShLanguage language = FindShaderLanguage(stage);
 	std::string source   = std::string(glsl_source.begin(), glsl_source.end());
@@ -82,7 +87,7 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
 	shader.setEntryPoint(entry_point.c_str());
 	shader.setSourceEntryPoint(entry_point.c_str());
 
-	if (!shader.parse(&glslang::DefaultTBuiltInResource, 100, false, messages))
+	if (!shader.parse(&glslang::DefaultTBuiltInResource, GLSL_DEFAULT_VERSION, false, messages))
 	{
 		info_log = std::string(shader.getInfoLog()) + "\n" + std::string(shader.getInfoDebugLog());
 		return false;
@@ -130,4 +135,16 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
 
 	return true;
 }
+
+uint64_t GLSLCompiler::get_options_hash()
+{
+	const char *glslang_version = glslang::GetGlslVersionString();
+
+	uint64_t hash = hash_bytes(glslang_version, std::strlen(glslang_version));
+
+	hash = hash_mix(hash, GLSL_MESSAGES);
+	hash = hash_mix(hash, GLSL_DEFAULT_VERSION);
+
+	return hash;
+}
 }        // namespace vkb
@@ -45,5 +45,9 @@ class GLSLCompiler
 	                      const std::string &         entry_point,
 	                      std::vector<std::uint32_t> &spirv,
 	                      std::string &               info_log);
+
+	/// @brief Hashes the compilation options and the glslang version, which together
+	///        with the stage, entry point and source identify the generated SPIRV
+	static uint64_t get_options_hash();
 };
 }        // namespace vkb
@@ -29,6 +29,7 @@
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
+#include <map>
 #include <queue>
 
 #include "core/image.h"
@@ -131,6 +132,13 @@ inline std::size_t get_attribute_stride(const tinygltf::Model *model, std::uint3
 	return accessor.ByteStride(bufferView);
 };
 
+inline std::size_t get_attribute_element_size(const tinygltf::Model *model, std::uint32_t accessorId)
+{
+	auto &accessor = model->accessors.at(accessorId);
+
+	return tinygltf::GetComponentSizeInBytes(accessor.componentType) * tinygltf::GetNumComponentsInType(accessor.type);
+};
+
 inline VkFormat get_attribute_format(const tinygltf::Model *model, std::uint32_t accessorId)
 {
 	auto &accessor = model->accessors.at(accessorId);
@@ -263,44 +271,11 @@ inline std::vector<uint8_t> convert_data(const std::vector<uint8_t> &srcData, st
 
 	return result;
 }
-
-inline void upload_image(CommandBuffer &command_buffer, core::Buffer &data, core::Image &image, ImageView &image_view)
-{
-	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.src_access_mask = 0;
-		memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-		command_buffer.image_memory_barrier(image_view, memory_barrier);
-	}
-
-	VkBufferImageCopy buffer_copy_region{};
-	buffer_copy_region.imageSubresource.layerCount = image_view.get_subresource_range().layerCount;
-	buffer_copy_region.imageSubresource.aspectMask = image_view.get_subresource_range().aspectMask;
-	buffer_copy_region.imageExtent                 = image.get_extent();
-
-	command_buffer.copy_buffer_to_image(data, image, {buffer_copy_region});
-
-	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-		memory_barrier.src_access_mask = 0;
-		memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-
-		command_buffer.image_memory_barrier(image_view, memory_barrier);
-	}
-}
 }        // namespace
 
-GLTFLoader::GLTFLoader(Device &device) :
-    device{device}
+GLTFLoader::GLTFLoader(Device &device, sg::VertexLayout vertex_layout) :
+    device{device},
+    vertex_layout{vertex_layout}
 {
 }
 
@@ -404,36 +379,18 @@ void GLTFLoader::load_scene(sg::Scene &scene)
 
 	scene.set_components(image_components);
 
-	std::vector<core::Buffer> transient_buffers;
-
-	auto &command_buffer = device.request_command_buffer();
-
-	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+	// Images are copied on the upload queue while the rest of the scene is parsed
+	auto &upload_manager = device.get_upload_manager();
 
 	for (std::size_t image_index = 0; image_index < image_components.size(); image_index++)
 	{
 		auto &image      = image_components.at(image_index);
 		auto &gltf_image = model.images.at(image_index);
 
-		core::Buffer stage_buffer{device, gltf_image.image.size(), VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU};
-		stage_buffer.update(gltf_image.image);
-
-		upload_image(command_buffer, stage_buffer, *image->image, *image->image_view);
-
-		transient_buffers.push_back(std::move(stage_buffer));
+		upload_manager.upload_image(*image->image_view, gltf_image.image.data(), gltf_image.image.size());
 	}
 
-	command_buffer.end();
-
-	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-	queue.submit(command_buffer, device.request_fence());
-
-	device.get_fence_pool().wait();
-	device.get_fence_pool().reset();
-	device.get_command_pool().reset();
-
-	transient_buffers.clear();
+	upload_manager.flush();
 
 	auto end_time = std::chrono::high_resolution_clock::now();
 
@@ -506,6 +463,11 @@ void GLTFLoader::load_scene(sg::Scene &scene)
 
 	auto materials = scene.get_components<sg::PBRMaterial>();
 
+	// Vertices and indices of all the submeshes are sub-allocated from a few device local buffers
+	geometry_buffers = std::make_shared<BufferPool>(device, GEOMETRY_BLOCK_SIZE * 1024 * 1024,
+	                                                VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+	                                                VMA_MEMORY_USAGE_GPU_ONLY);
+
 	for (auto &gltf_mesh : model.meshes)
 	{
 		auto mesh = parse_mesh(gltf_mesh);
@@ -617,6 +579,11 @@ void GLTFLoader::load_scene(sg::Scene &scene)
 	camera_node->set_component(camera_transform);
 
 	default_camera->set_node(camera_node);
+
+	geometry_buffers.reset();
+
+	// Textures and geometry have no placeholder, so the scene is ready once they are uploaded
+	upload_manager.wait(upload_manager.flush());
 }
 
 std::shared_ptr<sg::Node> GLTFLoader::parse_node(const tinygltf::Node &gltf_node)
@@ -705,26 +672,89 @@ std::shared_ptr<sg::SubMesh> GLTFLoader::parse_primitive(const tinygltf::Primiti
 {
 	auto submesh = std::make_shared<sg::SubMesh>();
 
+	submesh->geometry_buffers = geometry_buffers;
+
+	auto &upload_manager = device.get_upload_manager();
+
+	// Names and accessors of the attributes of each vertex stream
+	std::map<uint32_t, std::vector<std::pair<std::string, std::uint32_t>>> vertex_streams;
+
 	for (auto &attribute : gltf_primitive.attributes)
 	{
 		std::string attrib_name = attribute.first;
 		std::transform(attrib_name.begin(), attrib_name.end(), attrib_name.begin(), ::tolower);
 
-		auto vertex_data = get_attribute_data(&model, attribute.second);
+		uint32_t stream_index{0};
 
-		core::Buffer buffer{device, vertex_data.size(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU};
+		switch (vertex_layout)
+		{
+			case sg::VertexLayout::Interleaved:
+				stream_index = 0;
+				break;
+			case sg::VertexLayout::SeparatePosition:
+				stream_index = attrib_name == "position" ? 0 : 1;
+				break;
+			default:
+				stream_index = to_u32(vertex_streams.size());
+				break;
+		}
+
+		vertex_streams[stream_index].emplace_back(attrib_name, to_u32(attribute.second));
+	}
+
+	for (auto &vertex_stream : vertex_streams)
+	{
+		auto &attributes = vertex_stream.second;
+
+		auto vertex_count = get_attribute_size(&model, attributes.front().second);
+
+		std::vector<sg::VertexAttribute> stream_attributes(attributes.size());
+
+		uint32_t stream_stride{0};
 
-		buffer.update(vertex_data);
+		for (std::size_t i = 0; i < attributes.size(); i++)
+		{
+			stream_attributes[i].format = get_attribute_format(&model, attributes[i].second);
+			stream_attributes[i].offset = stream_stride;
 
-		auto pair = std::make_pair(attrib_name, std::move(buffer));
+			// Keep each attribute aligned to 4 bytes, as required by the vertex formats of the device
+			stream_stride += (to_u32(get_attribute_element_size(&model, attributes[i].second)) + 3) & ~3u;
+		}
 
-		submesh->vertex_buffers.insert(std::move(pair));
+		std::vector<uint8_t> vertex_data(vertex_count * stream_stride);
 
-		sg::VertexAttribute attrib;
-		attrib.format = get_attribute_format(&model, attribute.second);
-		attrib.stride = to_u32(get_attribute_stride(&model, attribute.second));
+		if (vertex_data.empty())
+		{
+			LOGW("gltf primitive has an empty vertex stream");
+			continue;
+		}
 
-		submesh->vertex_attributes[attrib_name] = attrib;
+		for (std::size_t i = 0; i < attributes.size(); i++)
+		{
+			auto attribute_data = get_attribute_data(&model, attributes[i].second);
+			auto element_size   = get_attribute_element_size(&model, attributes[i].second);
+			auto source_stride  = get_attribute_stride(&model, attributes[i].second);
+
+			for (std::size_t vertex = 0; vertex < vertex_count; vertex++)
+			{
+				std::copy_n(attribute_data.begin() + vertex * source_stride, element_size,
+				            vertex_data.begin() + vertex * stream_stride + stream_attributes[i].offset);
+			}
+
+			stream_attributes[i].stride = stream_stride;
+		}
+
+		auto allocation = geometry_buffers->allocate(vertex_data.size());
+
+		upload_manager.upload_buffer(allocation.get_buffer(), allocation.get_offset(), vertex_data.data(), vertex_data.size(),
+		                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT);
+
+		for (std::size_t i = 0; i < attributes.size(); i++)
+		{
+			submesh->vertex_buffers[attributes[i].first] = allocation;
+
+			submesh->vertex_attributes[attributes[i].first] = stream_attributes[i];
+		}
 	}
 
 	if (gltf_primitive.indices >= 0)
@@ -733,8 +763,7 @@ std::shared_ptr<sg::SubMesh> GLTFLoader::parse_primitive(const tinygltf::Primiti
 
 		auto format = get_attribute_format(&model, gltf_primitive.indices);
 
-		auto vertex_data = get_attribute_data(&model, gltf_primitive.indices);
-		auto index_data  = get_attribute_data(&model, gltf_primitive.indices);
+		auto index_data = get_attribute_data(&model, gltf_primitive.indices);
 
 		switch (format)
 		{
@@ -754,9 +783,16 @@ std::shared_ptr<sg::SubMesh> GLTFLoader::parse_primitive(const tinygltf::Primiti
 				break;
 		}
 
-		submesh->index_buffer = std::make_unique<core::Buffer>(device, index_data.size(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
+		if (index_data.empty())
+		{
+			LOGW("gltf primitive has no indices");
+			return submesh;
+		}
+
+		submesh->index_buffer = geometry_buffers->allocate(index_data.size());
 
-		submesh->index_buffer->update(index_data);
+		upload_manager.upload_buffer(submesh->index_buffer.get_buffer(), submesh->index_buffer.get_offset(), index_data.data(), index_data.size(),
+		                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, VK_ACCESS_INDEX_READ_BIT);
 	}
 	else
 	{
@@ -54,13 +54,18 @@ extern AAssetManager *asset_manager;
 
 namespace vkb
 {
+/**
+ * @brief Block size of the device local buffers holding the vertices and indices of a scene, in megabytes
+ */
+const uint32_t GEOMETRY_BLOCK_SIZE = 4;
+
 /// Read a gltf file and return a scene object. Converts the gltf objects
 /// to our internal scene implementation. Mesh data is copied to vulkan buffers and
 /// images are loaded from the folder of gltf file to vulkan images.
 class GLTFLoader
 {
   public:
-	GLTFLoader(Device &device);
+	GLTFLoader(Device &device, sg::VertexLayout vertex_layout = sg::VertexLayout::Separate);
 
 	bool read_scene_from_file(const std::string &file_name, sg::Scene &scene);
 
@@ -89,10 +94,16 @@ class GLTFLoader
 
 	Device &device;
 
+	/// Arrangement of the vertex attributes of the submeshes
+	sg::VertexLayout vertex_layout{sg::VertexLayout::Separate};
+
 	tinygltf::Model model;
 
 	std::string model_path;
 
+	/// Vertex and index buffers of the scene being loaded, from which the submeshes allocate their data
+	std::shared_ptr<BufferPool> geometry_buffers;
+
   private:
 	void load_scene(sg::Scene &scene);
 };
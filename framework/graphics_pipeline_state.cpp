@@ -87,6 +87,138 @@ bool operator!=(const vkb::ColorBlendState &lhs, const vkb::ColorBlendState &rhs
 
 namespace vkb
 {
+namespace
+{
+inline uint64_t hash_float(uint64_t seed, float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	return hash_mix(seed, bits);
+}
+
+uint64_t get_state_hash(const VertexInputState &state)
+{
+	uint64_t result = 0;
+
+	for (auto &binding : state.bindings)
+	{
+		result = hash_mix(result, binding.binding);
+		result = hash_mix(result, binding.stride);
+		result = hash_mix(result, binding.inputRate);
+	}
+
+	result = hash_mix(result, state.bindings.size());
+
+	for (auto &attribute : state.attributes)
+	{
+		result = hash_mix(result, attribute.location);
+		result = hash_mix(result, attribute.binding);
+		result = hash_mix(result, attribute.format);
+		result = hash_mix(result, attribute.offset);
+	}
+
+	return result;
+}
+
+uint64_t get_state_hash(const InputAssemblyState &state)
+{
+	uint64_t result = 0;
+
+	result = hash_mix(result, state.topology);
+	result = hash_mix(result, state.primitive_restart_enable);
+
+	return result;
+}
+
+uint64_t get_state_hash(const RasterizationState &state)
+{
+	uint64_t result = 0;
+
+	result = hash_mix(result, state.depth_clamp_enable);
+	result = hash_mix(result, state.rasterizer_discard_enable);
+	result = hash_mix(result, state.polygon_mode);
+	result = hash_mix(result, state.cull_mode);
+	result = hash_mix(result, state.front_face);
+	result = hash_mix(result, state.depth_bias_enable);
+
+	return result;
+}
+
+uint64_t get_state_hash(const ViewportState &state)
+{
+	uint64_t result = 0;
+
+	result = hash_mix(result, state.viewport_count);
+	result = hash_mix(result, state.scissor_count);
+
+	return result;
+}
+
+uint64_t get_state_hash(const MultisampleState &state)
+{
+	uint64_t result = 0;
+
+	result = hash_mix(result, state.rasterization_samples);
+	result = hash_mix(result, state.sample_shading_enable);
+	result = hash_float(result, state.min_sample_shading);
+	result = hash_mix(result, state.sample_mask);
+	result = hash_mix(result, state.alpha_to_coverage_enable);
+	result = hash_mix(result, state.alpha_to_one_enable);
+
+	return result;
+}
+
+uint64_t get_state_hash(const StencilOpState &state)
+{
+	uint64_t result = 0;
+
+	result = hash_mix(result, state.fail_op);
+	result = hash_mix(result, state.pass_op);
+	result = hash_mix(result, state.depth_fail_op);
+	result = hash_mix(result, state.compare_op);
+
+	return result;
+}
+
+uint64_t get_state_hash(const DepthStencilState &state)
+{
+	uint64_t result = 0;
+
+	result = hash_mix(result, state.depth_test_enable);
+	result = hash_mix(result, state.depth_write_enable);
+	result = hash_mix(result, state.depth_compare_op);
+	result = hash_mix(result, state.depth_bounds_test_enable);
+	result = hash_mix(result, state.stencil_test_enable);
+	result = hash_mix(result, get_state_hash(state.front));
+	result = hash_mix(result, get_state_hash(state.back));
+
+	return result;
+}
+
+uint64_t get_state_hash(const ColorBlendState &state)
+{
+	uint64_t result = 0;
+
+	result = hash_mix(result, state.logic_op_enable);
+	result = hash_mix(result, state.logic_op);
+
+	for (auto &attachment : state.attachments)
+	{
+		result = hash_mix(result, attachment.blend_enable);
+		result = hash_mix(result, attachment.src_color_blend_factor);
+		result = hash_mix(result, attachment.dst_color_blend_factor);
+		result = hash_mix(result, attachment.color_blend_op);
+		result = hash_mix(result, attachment.src_alpha_blend_factor);
+		result = hash_mix(result, attachment.dst_alpha_blend_factor);
+		result = hash_mix(result, attachment.alpha_blend_op);
+		result = hash_mix(result, attachment.color_write_mask);
+	}
+
+	return result;
+}
+}        // namespace
+
 void SpecializationInfo::set_constant(uint32_t constant_id, const std::vector<uint8_t> &value)
 {
 	VkSpecializationMapEntry specialization_entry;
@@ -120,10 +252,17 @@ const VkSpecializationInfo &SpecializationInfo::get_handle() const
 	return handle;
 }
 
+GraphicsPipelineState::GraphicsPipelineState()
+{
+	reset();
+}
+
 void GraphicsPipelineState::reset()
 {
 	clear_dirty();
 
+	key_dirty = true;
+
 	pipeline_layout = nullptr;
 
 	render_pass = nullptr;
@@ -134,6 +273,8 @@ void GraphicsPipelineState::reset()
 
 	rasterization_state = {};
 
+	viewport_state = {};
+
 	multisample_state = {};
 
 	depth_stencil_state = {};
@@ -141,6 +282,24 @@ void GraphicsPipelineState::reset()
 	color_blend_state = {};
 
 	subpass_index = {0U};
+
+	pipeline_layout_hash = 0;
+
+	render_pass_hash = 0;
+
+	vertex_input_state_hash = get_state_hash(vertex_input_sate);
+
+	input_assembly_state_hash = get_state_hash(input_assembly_state);
+
+	rasterization_state_hash = get_state_hash(rasterization_state);
+
+	viewport_state_hash = get_state_hash(viewport_state);
+
+	multisample_state_hash = get_state_hash(multisample_state);
+
+	depth_stencil_state_hash = get_state_hash(depth_stencil_state);
+
+	color_blend_state_hash = get_state_hash(color_blend_state);
 }
 
 void GraphicsPipelineState::set_pipeline_layout(PipelineLayout &pipeline_layout)
@@ -151,14 +310,22 @@ void GraphicsPipelineState::set_pipeline_layout(PipelineLayout &pipeline_layout)
 		{
 			this->pipeline_layout = &pipeline_layout;
 
+			pipeline_layout_hash = hash_handle(0, pipeline_layout.get_handle());
+
 			dirty = true;
+
+			key_dirty = true;
 		}
 	}
 	else
 	{
 		this->pipeline_layout = &pipeline_layout;
 
+		pipeline_layout_hash = hash_handle(0, pipeline_layout.get_handle());
+
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -170,14 +337,22 @@ void GraphicsPipelineState::set_render_pass(const RenderPass &render_pass)
 		{
 			this->render_pass = &render_pass;
 
+			render_pass_hash = hash_handle(0, render_pass.get_handle());
+
 			dirty = true;
+
+			key_dirty = true;
 		}
 	}
 	else
 	{
 		this->render_pass = &render_pass;
 
+		render_pass_hash = hash_handle(0, render_pass.get_handle());
+
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -187,7 +362,11 @@ void GraphicsPipelineState::set_vertex_input_state(const VertexInputState &verte
 	{
 		this->vertex_input_sate = vertex_input_sate;
 
+		vertex_input_state_hash = get_state_hash(vertex_input_sate);
+
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -197,7 +376,11 @@ void GraphicsPipelineState::set_input_assembly_state(const InputAssemblyState &i
 	{
 		this->input_assembly_state = input_assembly_state;
 
+		input_assembly_state_hash = get_state_hash(input_assembly_state);
+
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -207,7 +390,11 @@ void GraphicsPipelineState::set_rasterization_state(const RasterizationState &ra
 	{
 		this->rasterization_state = rasterization_state;
 
+		rasterization_state_hash = get_state_hash(rasterization_state);
+
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -217,7 +404,11 @@ void GraphicsPipelineState::set_viewport_state(const ViewportState &viewport_sta
 	{
 		this->viewport_state = viewport_state;
 
+		viewport_state_hash = get_state_hash(viewport_state);
+
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -227,7 +418,11 @@ void GraphicsPipelineState::set_multisample_state(const MultisampleState &multis
 	{
 		this->multisample_state = multisample_state;
 
+		multisample_state_hash = get_state_hash(multisample_state);
+
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -237,7 +432,11 @@ void GraphicsPipelineState::set_depth_stencil_state(const DepthStencilState &dep
 	{
 		this->depth_stencil_state = depth_stencil_state;
 
+		depth_stencil_state_hash = get_state_hash(depth_stencil_state);
+
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -247,7 +446,11 @@ void GraphicsPipelineState::set_color_blend_state(const ColorBlendState &color_b
 	{
 		this->color_blend_state = color_blend_state;
 
+		color_blend_state_hash = get_state_hash(color_blend_state);
+
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -258,6 +461,8 @@ void GraphicsPipelineState::set_subpass_index(uint32_t subpass_index)
 		this->subpass_index = subpass_index;
 
 		dirty = true;
+
+		key_dirty = true;
 	}
 }
 
@@ -321,4 +526,131 @@ void GraphicsPipelineState::clear_dirty()
 {
 	dirty = false;
 }
+
+uint64_t GraphicsPipelineState::get_hash() const
+{
+	uint64_t result = 0;
+
+	result = hash_mix(result, pipeline_layout_hash);
+	result = hash_mix(result, render_pass_hash);
+	result = hash_mix(result, subpass_index);
+	result = hash_mix(result, vertex_input_state_hash);
+	result = hash_mix(result, input_assembly_state_hash);
+	result = hash_mix(result, rasterization_state_hash);
+	result = hash_mix(result, viewport_state_hash);
+	result = hash_mix(result, multisample_state_hash);
+	result = hash_mix(result, depth_stencil_state_hash);
+	result = hash_mix(result, color_blend_state_hash);
+
+	return result;
+}
+
+const std::vector<uint8_t> &GraphicsPipelineState::get_key() const
+{
+	if (!key_dirty)
+	{
+		return key.get_data();
+	}
+
+	key.clear();
+
+	key.write(get_pipeline_layout().get_handle());
+	key.write(get_render_pass().get_handle());
+	key.write(subpass_index);
+
+	key.write(get_pipeline_layout().get_stages().size());
+
+	for (auto &stage : get_pipeline_layout().get_stages())
+	{
+		key.write(stage.get_handle());
+	}
+
+	// VkPipelineVertexInputStateCreateInfo
+
+	key.write(vertex_input_sate.attributes.size());
+
+	for (auto &attribute : vertex_input_sate.attributes)
+	{
+		key.write(attribute.location);
+		key.write(attribute.binding);
+		key.write(attribute.format);
+		key.write(attribute.offset);
+	}
+
+	key.write(vertex_input_sate.bindings.size());
+
+	for (auto &binding : vertex_input_sate.bindings)
+	{
+		key.write(binding.binding);
+		key.write(binding.stride);
+		key.write(binding.inputRate);
+	}
+
+	// VkPipelineInputAssemblyStateCreateInfo
+
+	key.write(input_assembly_state.topology);
+	key.write(input_assembly_state.primitive_restart_enable);
+
+	// VkPipelineViewportStateCreateInfo
+
+	key.write(viewport_state.viewport_count);
+	key.write(viewport_state.scissor_count);
+
+	// VkPipelineRasterizationStateCreateInfo
+
+	key.write(rasterization_state.depth_clamp_enable);
+	key.write(rasterization_state.rasterizer_discard_enable);
+	key.write(rasterization_state.polygon_mode);
+	key.write(rasterization_state.cull_mode);
+	key.write(rasterization_state.front_face);
+	key.write(rasterization_state.depth_bias_enable);
+
+	// VkPipelineMultisampleStateCreateInfo
+
+	key.write(multisample_state.rasterization_samples);
+	key.write(multisample_state.sample_shading_enable);
+	key.write(multisample_state.min_sample_shading);
+	key.write(multisample_state.sample_mask);
+	key.write(multisample_state.alpha_to_coverage_enable);
+	key.write(multisample_state.alpha_to_one_enable);
+
+	// VkPipelineDepthStencilStateCreateInfo
+
+	key.write(depth_stencil_state.depth_test_enable);
+	key.write(depth_stencil_state.depth_write_enable);
+	key.write(depth_stencil_state.depth_compare_op);
+	key.write(depth_stencil_state.depth_bounds_test_enable);
+	key.write(depth_stencil_state.stencil_test_enable);
+
+	for (auto &stencil : {depth_stencil_state.front, depth_stencil_state.back})
+	{
+		key.write(stencil.fail_op);
+		key.write(stencil.pass_op);
+		key.write(stencil.depth_fail_op);
+		key.write(stencil.compare_op);
+	}
+
+	// VkPipelineColorBlendStateCreateInfo
+
+	key.write(color_blend_state.logic_op_enable);
+	key.write(color_blend_state.logic_op);
+
+	key.write(color_blend_state.attachments.size());
+
+	for (auto &attachment : color_blend_state.attachments)
+	{
+		key.write(attachment.blend_enable);
+		key.write(attachment.src_color_blend_factor);
+		key.write(attachment.dst_color_blend_factor);
+		key.write(attachment.color_blend_op);
+		key.write(attachment.src_alpha_blend_factor);
+		key.write(attachment.dst_alpha_blend_factor);
+		key.write(attachment.alpha_blend_op);
+		key.write(attachment.color_write_mask);
+	}
+
+	key_dirty = false;
+
+	return key.get_data();
+}
 }        // namespace vkb
@@ -24,6 +24,7 @@
 
 #include "core/pipeline_layout.h"
 #include "core/render_pass.h"
+#include "serialization.h"
 
 namespace vkb
 {
@@ -181,6 +182,8 @@ inline void SpecializationInfo::set_constant<bool>(std::uint32_t constant_id, co
 class GraphicsPipelineState
 {
   public:
+	GraphicsPipelineState();
+
 	void reset();
 
 	void set_pipeline_layout(PipelineLayout &pipeline_layout);
@@ -227,9 +230,43 @@ class GraphicsPipelineState
 
 	void clear_dirty();
 
+	/**
+	 * @brief Hash of the whole state, computed in constant time by combining
+	 *        the hashes of the individual states, which are updated by the setters
+	 */
+	uint64_t get_hash() const;
+
+	/**
+	 * @brief Bytes identifying the whole state in the pipeline cache. They are kept with
+	 *        the state and only written again when it is requested after a setter changed it.
+	 */
+	const std::vector<uint8_t> &get_key() const;
+
   private:
 	bool dirty{false};
 
+	mutable bool key_dirty{true};
+
+	mutable BinaryWriter key;
+
+	uint64_t pipeline_layout_hash{0};
+
+	uint64_t render_pass_hash{0};
+
+	uint64_t vertex_input_state_hash{0};
+
+	uint64_t input_assembly_state_hash{0};
+
+	uint64_t rasterization_state_hash{0};
+
+	uint64_t viewport_state_hash{0};
+
+	uint64_t multisample_state_hash{0};
+
+	uint64_t depth_stencil_state_hash{0};
+
+	uint64_t color_blend_state_hash{0};
+
 	PipelineLayout *pipeline_layout{nullptr};
 
 	const RenderPass *render_pass{nullptr};
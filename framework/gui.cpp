@@ -116,65 +116,10 @@ Gui::Gui(RenderContext &render_context, const float dpi_factor) :
                                                VMA_MEMORY_USAGE_GPU_ONLY);
 	font_image_view = std::make_unique<ImageView>(*font_image, VK_IMAGE_VIEW_TYPE_2D);
 
-	// Upload font data into the vulkan image memory
-	{
-		core::Buffer stage_buffer{device, upload_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY};
-		stage_buffer.update({font_data, font_data + upload_size});
-
-		auto &graphics_queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-		auto &command_buffer = device.request_command_buffer();
-
-		FencePool fence_pool{device};
-
-		// Begin recording
-		command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-
-		{
-			// Prepare for transfer
-			ImageMemoryBarrier memory_barrier{};
-			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
-			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			memory_barrier.src_access_mask = 0;
-			memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
-			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_HOST_BIT;
-			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-
-			command_buffer.image_memory_barrier(*font_image_view, memory_barrier);
-		}
-
-		// Copy
-		VkBufferImageCopy buffer_copy_region{};
-		buffer_copy_region.imageSubresource.layerCount = font_image_view->get_subresource_range().layerCount;
-		buffer_copy_region.imageSubresource.aspectMask = font_image_view->get_subresource_range().aspectMask;
-		buffer_copy_region.imageExtent                 = font_image->get_extent();
+	// Upload font data into the vulkan image memory, without waiting for the copy to complete
+	font_upload_token = device.get_upload_manager().upload_image(*font_image_view, font_data, upload_size);
 
-		command_buffer.copy_buffer_to_image(stage_buffer, *font_image, {buffer_copy_region});
-
-		{
-			// Prepare for fragmen shader
-			ImageMemoryBarrier memory_barrier{};
-			memory_barrier.old_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-			memory_barrier.new_layout      = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-			memory_barrier.src_access_mask = 0;
-			memory_barrier.dst_access_mask = VK_ACCESS_SHADER_READ_BIT;
-			memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
-			memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-
-			command_buffer.image_memory_barrier(*font_image_view, memory_barrier);
-		}
-
-		// End recording
-		command_buffer.end();
-
-		auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
-
-		queue.submit(command_buffer, device.request_fence());
-
-		// Wait for the command buffer to finish its work before destroying the staging buffer
-		device.get_fence_pool().wait();
-		device.get_fence_pool().reset();
-		device.get_command_pool().reset();
-	}
+	device.get_upload_manager().flush();
 
 	// Create texture sampler
 	VkSamplerCreateInfo sampler_info{VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
@@ -215,66 +160,37 @@ void Gui::update_buffers()
 	size_t vertex_buffer_size = draw_data->TotalVtxCount * sizeof(ImDrawVert);
 	size_t index_buffer_size  = draw_data->TotalIdxCount * sizeof(ImDrawIdx);
 
+	vertex_buffer_allocation = {};
+	index_buffer_allocation  = {};
+
 	if ((vertex_buffer_size == 0) || (index_buffer_size == 0))
 	{
 		return;
 	}
 
-	std::vector<uint8_t> vertex_data(vertex_buffer_size);
-	std::vector<uint8_t> index_data(index_buffer_size);
+	// Allocate buffers from the frame, recycled once its commands completed
+	auto &frame = render_context.get_active_frame();
+
+	vertex_buffer_allocation = frame.allocate_buffer(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertex_buffer_size);
+	index_buffer_allocation  = frame.allocate_buffer(VK_BUFFER_USAGE_INDEX_BUFFER_BIT, index_buffer_size);
 
-	// Upload data
-	ImDrawVert *vtx_dst = (ImDrawVert *) vertex_data.data();
-	ImDrawIdx * idx_dst = (ImDrawIdx *) index_data.data();
+	// Upload data straight to the mapped memory
+	size_t vertex_offset = 0;
+	size_t index_offset  = 0;
 
 	for (int n = 0; n < draw_data->CmdListsCount; n++)
 	{
 		const ImDrawList *cmd_list = draw_data->CmdLists[n];
-		memcpy(vtx_dst, cmd_list->VtxBuffer.Data, cmd_list->VtxBuffer.Size * sizeof(ImDrawVert));
-		memcpy(idx_dst, cmd_list->IdxBuffer.Data, cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx));
-		vtx_dst += cmd_list->VtxBuffer.Size;
-		idx_dst += cmd_list->IdxBuffer.Size;
-	}
-
-	auto &frame = render_context.get_active_frame();
-	// Get vertex buffer for the current image
-	auto &vertex_buffer = frame.gui_vertex_buffer;
-
-	// Upload to buffers to make writes visible to GPU
-	// If buffer size is not enough
-	if (vertex_buffer && vertex_buffer->get_size() < vertex_buffer_size)
-	{
-		// Destroy the old buffer before creating a new one
-		vertex_buffer.reset();
-	}
 
-	if (!vertex_buffer)
-	{
-		// Create a buffer for vertices
-		vertex_buffer = std::make_unique<core::Buffer>(render_context.get_device(), vertex_buffer_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-	}
+		size_t vertex_size = cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+		size_t index_size  = cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
 
-	// Update current buffer with new data
-	vertex_buffer->update(vertex_data);
+		vertex_buffer_allocation.update(reinterpret_cast<const uint8_t *>(cmd_list->VtxBuffer.Data), vertex_size, vertex_offset);
+		index_buffer_allocation.update(reinterpret_cast<const uint8_t *>(cmd_list->IdxBuffer.Data), index_size, index_offset);
 
-	// Get vertex buffer for the current image
-	auto &index_buffer = frame.gui_index_buffer;
-
-	// If buffer size is not enough
-	if (index_buffer && index_buffer->get_size() < index_buffer_size)
-	{
-		// Destroy the old buffer before creating a new one
-		index_buffer.reset();
+		vertex_offset += vertex_size;
+		index_offset += index_size;
 	}
-
-	if (!index_buffer)
-	{
-		// Create a buffer for indices
-		index_buffer = std::make_unique<core::Buffer>(render_context.get_device(), index_buffer_size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU);
-	}
-
-	// Update current buffer with new data
-	index_buffer->update(index_data);
 }
 
 void Gui::resize(const uint32_t width, const uint32_t height) const
@@ -286,7 +202,7 @@ void Gui::resize(const uint32_t width, const uint32_t height) const
 
 void Gui::draw(CommandBuffer &command_buffer)
 {
-	if (!visible)
+	if (!visible || !render_context.get_device().get_upload_manager().is_complete(font_upload_token))
 	{
 		return;
 	}
@@ -376,23 +292,16 @@ void Gui::draw(CommandBuffer &command_buffer)
 
 	if (draw_data->CmdListsCount > 0)
 	{
-		auto &frame = render_context.get_active_frame();
-
 		// Vertex buffers
-		assert(frame.gui_vertex_buffer && "Gui vertex buffer is invalid");
-		const auto &vertex_buffer = *frame.gui_vertex_buffer;
-
-		std::vector<std::reference_wrapper<const core::Buffer>> buffers;
-		buffers.emplace_back(std::ref(vertex_buffer));
+		assert(!vertex_buffer_allocation.empty() && "Gui vertex buffer is invalid");
+		const core::Buffer *vertex_buffer = &vertex_buffer_allocation.get_buffer();
+		VkDeviceSize        buffer_offset = vertex_buffer_allocation.get_offset();
 
-		std::vector<VkDeviceSize> offsets{0};
-
-		command_buffer.bind_vertex_buffers(0, buffers, offsets);
+		command_buffer.bind_vertex_buffers(0, 1, &vertex_buffer, &buffer_offset);
 
 		// Index buffer
-		assert(frame.gui_index_buffer && "Gui index buffer is invalid");
-		const auto &index_buffer = *frame.gui_index_buffer;
-		command_buffer.bind_index_buffer(index_buffer, 0, VK_INDEX_TYPE_UINT16);
+		assert(!index_buffer_allocation.empty() && "Gui index buffer is invalid");
+		command_buffer.bind_index_buffer(index_buffer_allocation.get_buffer(), index_buffer_allocation.get_offset(), VK_INDEX_TYPE_UINT16);
 
 		for (int32_t i = 0; i < draw_data->CmdListsCount; i++)
 		{
@@ -431,7 +340,7 @@ void Gui::draw(CommandBuffer &command_buffer)
 					scissor_rect.extent.height = static_cast<uint32_t>(cmd->ClipRect.w - cmd->ClipRect.y);
 				}
 
-				command_buffer.set_scissor(0, {scissor_rect});
+				command_buffer.set_scissor(0, 1, &scissor_rect);
 				command_buffer.draw_indexed(cmd->ElemCount, 1, index_offset, vertex_offset, 0);
 				index_offset += cmd->ElemCount;
 			}
@@ -442,6 +351,9 @@ void Gui::draw(CommandBuffer &command_buffer)
 
 Gui::~Gui()
 {
+	// The font image must not be destroyed while it is being uploaded
+	render_context.get_device().get_upload_manager().wait(font_upload_token);
+
 	if (sampler)
 	{
 		vkDestroySampler(render_context.get_device().get_handle(), sampler, nullptr);
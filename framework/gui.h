@@ -222,8 +222,7 @@ class Gui
 
   private:
 	/**
-	 * @brief Updates Vulkan buffers
-	 * @param frame Frame to render into
+	 * @brief Updates Vulkan buffers, allocated from the active frame
 	 */
 	void update_buffers();
 
@@ -249,8 +248,16 @@ class Gui
 	std::unique_ptr<core::Image> font_image;
 	std::unique_ptr<ImageView>   font_image_view;
 
+	/// The font is not drawn until its upload completed
+	UploadToken font_upload_token{0};
+
 	VkSampler sampler{VK_NULL_HANDLE};
 
+	/// Vertices and indices of the active frame
+	BufferAllocation vertex_buffer_allocation;
+
+	BufferAllocation index_buffer_allocation;
+
 	PipelineLayout &pipeline_layout;
 
 	StatsView stats_view;
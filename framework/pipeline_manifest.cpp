@@ -0,0 +1,540 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "pipeline_manifest.h"
+
+#include "serialization.h"
+
+namespace vkb
+{
+namespace
+{
+const uint32_t PIPELINE_MANIFEST_MAGIC = 0x4d504b56;        // "VKPM"
+
+const uint32_t PIPELINE_MANIFEST_VERSION = 3;
+
+/*
+ * States are written field by field, so that the padding of the structures
+ * does not end up in the manifest, whose content is then deterministic
+ */
+
+void write_state(BinaryWriter &writer, const LoadStoreInfo &state)
+{
+	writer.write(state.load_op);
+	writer.write(state.store_op);
+}
+
+void read_state(BinaryReader &reader, LoadStoreInfo &state)
+{
+	state.load_op  = reader.read<VkAttachmentLoadOp>();
+	state.store_op = reader.read<VkAttachmentStoreOp>();
+}
+
+void write_state(BinaryWriter &writer, const VkVertexInputBindingDescription &state)
+{
+	writer.write(state.binding);
+	writer.write(state.stride);
+	writer.write(state.inputRate);
+}
+
+void read_state(BinaryReader &reader, VkVertexInputBindingDescription &state)
+{
+	state.binding   = reader.read<uint32_t>();
+	state.stride    = reader.read<uint32_t>();
+	state.inputRate = reader.read<VkVertexInputRate>();
+}
+
+void write_state(BinaryWriter &writer, const VkVertexInputAttributeDescription &state)
+{
+	writer.write(state.location);
+	writer.write(state.binding);
+	writer.write(state.format);
+	writer.write(state.offset);
+}
+
+void read_state(BinaryReader &reader, VkVertexInputAttributeDescription &state)
+{
+	state.location = reader.read<uint32_t>();
+	state.binding  = reader.read<uint32_t>();
+	state.format   = reader.read<VkFormat>();
+	state.offset   = reader.read<uint32_t>();
+}
+
+void write_state(BinaryWriter &writer, const InputAssemblyState &state)
+{
+	writer.write(state.topology);
+	writer.write(state.primitive_restart_enable);
+}
+
+void read_state(BinaryReader &reader, InputAssemblyState &state)
+{
+	state.topology                 = reader.read<VkPrimitiveTopology>();
+	state.primitive_restart_enable = reader.read<VkBool32>();
+}
+
+void write_state(BinaryWriter &writer, const RasterizationState &state)
+{
+	writer.write(state.depth_clamp_enable);
+	writer.write(state.rasterizer_discard_enable);
+	writer.write(state.polygon_mode);
+	writer.write(state.cull_mode);
+	writer.write(state.front_face);
+	writer.write(state.depth_bias_enable);
+}
+
+void read_state(BinaryReader &reader, RasterizationState &state)
+{
+	state.depth_clamp_enable        = reader.read<VkBool32>();
+	state.rasterizer_discard_enable = reader.read<VkBool32>();
+	state.polygon_mode              = reader.read<VkPolygonMode>();
+	state.cull_mode                 = reader.read<VkCullModeFlags>();
+	state.front_face                = reader.read<VkFrontFace>();
+	state.depth_bias_enable         = reader.read<VkBool32>();
+}
+
+void write_state(BinaryWriter &writer, const ViewportState &state)
+{
+	writer.write(state.viewport_count);
+	writer.write(state.scissor_count);
+}
+
+void read_state(BinaryReader &reader, ViewportState &state)
+{
+	state.viewport_count = reader.read<uint32_t>();
+	state.scissor_count  = reader.read<uint32_t>();
+}
+
+void write_state(BinaryWriter &writer, const MultisampleState &state)
+{
+	writer.write(state.rasterization_samples);
+	writer.write(state.sample_shading_enable);
+	writer.write(state.min_sample_shading);
+	writer.write(state.sample_mask);
+	writer.write(state.alpha_to_coverage_enable);
+	writer.write(state.alpha_to_one_enable);
+}
+
+void read_state(BinaryReader &reader, MultisampleState &state)
+{
+	state.rasterization_samples    = reader.read<VkSampleCountFlagBits>();
+	state.sample_shading_enable    = reader.read<VkBool32>();
+	state.min_sample_shading       = reader.read<float>();
+	state.sample_mask              = reader.read<VkSampleMask>();
+	state.alpha_to_coverage_enable = reader.read<VkBool32>();
+	state.alpha_to_one_enable      = reader.read<VkBool32>();
+}
+
+void write_state(BinaryWriter &writer, const StencilOpState &state)
+{
+	writer.write(state.fail_op);
+	writer.write(state.pass_op);
+	writer.write(state.depth_fail_op);
+	writer.write(state.compare_op);
+}
+
+void read_state(BinaryReader &reader, StencilOpState &state)
+{
+	state.fail_op       = reader.read<VkStencilOp>();
+	state.pass_op       = reader.read<VkStencilOp>();
+	state.depth_fail_op = reader.read<VkStencilOp>();
+	state.compare_op    = reader.read<VkCompareOp>();
+}
+
+void write_state(BinaryWriter &writer, const DepthStencilState &state)
+{
+	writer.write(state.depth_test_enable);
+	writer.write(state.depth_write_enable);
+	writer.write(state.depth_compare_op);
+	writer.write(state.depth_bounds_test_enable);
+	writer.write(state.stencil_test_enable);
+	write_state(writer, state.front);
+	write_state(writer, state.back);
+}
+
+void read_state(BinaryReader &reader, DepthStencilState &state)
+{
+	state.depth_test_enable        = reader.read<VkBool32>();
+	state.depth_write_enable       = reader.read<VkBool32>();
+	state.depth_compare_op         = reader.read<VkCompareOp>();
+	state.depth_bounds_test_enable = reader.read<VkBool32>();
+	state.stencil_test_enable      = reader.read<VkBool32>();
+	read_state(reader, state.front);
+	read_state(reader, state.back);
+}
+
+void write_state(BinaryWriter &writer, const ColorBlendAttachmentState &state)
+{
+	writer.write(state.blend_enable);
+	writer.write(state.src_color_blend_factor);
+	writer.write(state.dst_color_blend_factor);
+	writer.write(state.color_blend_op);
+	writer.write(state.src_alpha_blend_factor);
+	writer.write(state.dst_alpha_blend_factor);
+	writer.write(state.alpha_blend_op);
+	writer.write(state.color_write_mask);
+}
+
+void read_state(BinaryReader &reader, ColorBlendAttachmentState &state)
+{
+	state.blend_enable           = reader.read<VkBool32>();
+	state.src_color_blend_factor = reader.read<VkBlendFactor>();
+	state.dst_color_blend_factor = reader.read<VkBlendFactor>();
+	state.color_blend_op         = reader.read<VkBlendOp>();
+	state.src_alpha_blend_factor = reader.read<VkBlendFactor>();
+	state.dst_alpha_blend_factor = reader.read<VkBlendFactor>();
+	state.alpha_blend_op         = reader.read<VkBlendOp>();
+	state.color_write_mask       = reader.read<VkColorComponentFlags>();
+}
+
+template <typename T>
+void write_states(BinaryWriter &writer, const std::vector<T> &states)
+{
+	writer.write(to_u32(states.size()));
+
+	for (auto &state : states)
+	{
+		write_state(writer, state);
+	}
+}
+
+template <typename T>
+std::vector<T> read_states(BinaryReader &reader)
+{
+	// Every state is made of 32-bit fields
+	std::vector<T> states(reader.read_count(sizeof(uint32_t)));
+
+	for (auto &state : states)
+	{
+		read_state(reader, state);
+	}
+
+	return states;
+}
+}        // namespace
+
+PipelineManifest::PipelineManifest(const std::vector<uint8_t> &data)
+{
+	BinaryReader reader{data};
+
+	if (reader.read<uint32_t>() != PIPELINE_MANIFEST_MAGIC ||
+	    reader.read<uint32_t>() != PIPELINE_MANIFEST_VERSION)
+	{
+		throw std::runtime_error("Pipeline manifest header is invalid");
+	}
+
+	uint32_t shader_count = reader.read_count(sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < shader_count; ++i)
+	{
+		ShaderRecord shader;
+
+		shader.stage = reader.read<VkShaderStageFlagBits>();
+
+		shader.entry_point = reader.read_string();
+
+		shader.spirv = reader.read_vector<uint32_t>();
+
+		uint32_t dynamic_resource_count = reader.read_count(sizeof(uint32_t));
+
+		for (uint32_t k = 0; k < dynamic_resource_count; ++k)
+		{
+			shader.dynamic_resources.push_back(reader.read_string());
+		}
+
+		shaders.push_back(std::move(shader));
+	}
+
+	uint32_t render_pass_count = reader.read_count(sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < render_pass_count; ++i)
+	{
+		RenderPassRecord render_pass;
+
+		uint32_t attachment_count = reader.read_count(3 * sizeof(uint32_t));
+
+		for (uint32_t k = 0; k < attachment_count; ++k)
+		{
+			VkFormat              format  = reader.read<VkFormat>();
+			VkSampleCountFlagBits samples = reader.read<VkSampleCountFlagBits>();
+			VkImageUsageFlags     usage   = reader.read<VkImageUsageFlags>();
+
+			render_pass.attachments.emplace_back(format, samples, usage);
+		}
+
+		render_pass.load_store_infos = read_states<LoadStoreInfo>(reader);
+
+		uint32_t subpass_count = reader.read_count(2 * sizeof(uint32_t));
+
+		for (uint32_t k = 0; k < subpass_count; ++k)
+		{
+			SubpassInfo subpass;
+
+			for (uint32_t input_attachment : reader.read_vector<uint32_t>())
+			{
+				subpass.input_attachments.insert(input_attachment);
+			}
+
+			for (uint32_t output_attachment : reader.read_vector<uint32_t>())
+			{
+				subpass.output_attachments.insert(output_attachment);
+			}
+
+			render_pass.subpasses.push_back(std::move(subpass));
+		}
+
+		render_passes.push_back(std::move(render_pass));
+	}
+
+	uint32_t pipeline_count = reader.read_count(sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < pipeline_count; ++i)
+	{
+		PipelineRecord pipeline;
+
+		pipeline.shaders = reader.read_vector<uint32_t>();
+
+		for (uint32_t shader_index : pipeline.shaders)
+		{
+			if (shader_index >= shaders.size())
+			{
+				throw std::runtime_error("Pipeline manifest references an invalid shader");
+			}
+		}
+
+		pipeline.render_pass = reader.read<uint32_t>();
+
+		if (pipeline.render_pass >= render_passes.size())
+		{
+			throw std::runtime_error("Pipeline manifest references an invalid render pass");
+		}
+
+		pipeline.subpass_index = reader.read<uint32_t>();
+
+		pipeline.vertex_input_state.bindings   = read_states<VkVertexInputBindingDescription>(reader);
+		pipeline.vertex_input_state.attributes = read_states<VkVertexInputAttributeDescription>(reader);
+
+		read_state(reader, pipeline.input_assembly_state);
+		read_state(reader, pipeline.rasterization_state);
+		read_state(reader, pipeline.viewport_state);
+		read_state(reader, pipeline.multisample_state);
+		read_state(reader, pipeline.depth_stencil_state);
+
+		pipeline.color_blend_state.logic_op_enable = reader.read<VkBool32>();
+		pipeline.color_blend_state.logic_op        = reader.read<VkLogicOp>();
+		pipeline.color_blend_state.attachments     = read_states<ColorBlendAttachmentState>(reader);
+
+		uint32_t specialization_count = reader.read_count(2 * sizeof(uint32_t));
+
+		for (uint32_t k = 0; k < specialization_count; ++k)
+		{
+			auto &specialization_info = pipeline.specialization_infos[reader.read<VkShaderStageFlagBits>()];
+
+			uint32_t constant_count = reader.read_count(2 * sizeof(uint32_t));
+
+			for (uint32_t c = 0; c < constant_count; ++c)
+			{
+				uint32_t constant_id = reader.read<uint32_t>();
+
+				std::vector<uint8_t> constant_data(reader.read_count(sizeof(uint8_t)));
+				reader.read(constant_data.data(), constant_data.size());
+
+				specialization_info.set_constant(constant_id, constant_data);
+			}
+		}
+
+		pipelines.push_back(std::move(pipeline));
+	}
+
+	if (!reader.is_end())
+	{
+		throw std::runtime_error("Pipeline manifest has trailing data");
+	}
+}
+
+bool PipelineManifest::add_pipeline(uint64_t pipeline_hash, const GraphicsPipelineState &graphics_state, const ShaderStageMap<SpecializationInfo> &specialization_infos)
+{
+	if (!pipeline_hashes.insert(pipeline_hash).second)
+	{
+		return false;
+	}
+
+	PipelineRecord pipeline;
+
+	for (auto &shader_module : graphics_state.get_pipeline_layout().get_stages())
+	{
+		auto shader_it = shader_indices.find(shader_module.get_id());
+
+		if (shader_it == shader_indices.end())
+		{
+			shader_it = shader_indices.emplace(shader_module.get_id(), to_u32(shaders.size())).first;
+
+			ShaderRecord shader{shader_module.get_stage(), shader_module.get_entry_point(), shader_module.get_binary()};
+
+			for (auto &resource : shader_module.get_resources())
+			{
+				if (resource.dynamic)
+				{
+					shader.dynamic_resources.push_back(resource.name);
+				}
+			}
+
+			shaders.push_back(std::move(shader));
+		}
+
+		pipeline.shaders.push_back(shader_it->second);
+	}
+
+	auto &render_pass = graphics_state.get_render_pass();
+
+	auto render_pass_it = render_pass_indices.find(render_pass.get_handle());
+
+	if (render_pass_it == render_pass_indices.end())
+	{
+		render_pass_it = render_pass_indices.emplace(render_pass.get_handle(), to_u32(render_passes.size())).first;
+
+		render_passes.push_back({render_pass.get_attachments(), render_pass.get_load_store_infos(), render_pass.get_subpasses()});
+	}
+
+	pipeline.render_pass          = render_pass_it->second;
+	pipeline.subpass_index        = graphics_state.get_subpass_index();
+	pipeline.vertex_input_state   = graphics_state.get_vertex_input_state();
+	pipeline.input_assembly_state = graphics_state.get_input_assembly_state();
+	pipeline.rasterization_state  = graphics_state.get_rasterization_state();
+	pipeline.viewport_state       = graphics_state.get_viewport_state();
+	pipeline.multisample_state    = graphics_state.get_multisample_state();
+	pipeline.depth_stencil_state  = graphics_state.get_depth_stencil_state();
+	pipeline.color_blend_state    = graphics_state.get_color_blend_state();
+	pipeline.specialization_infos = specialization_infos;
+
+	pipelines.push_back(std::move(pipeline));
+
+	return true;
+}
+
+std::vector<uint8_t> PipelineManifest::serialize() const
+{
+	BinaryWriter writer;
+
+	writer.write(PIPELINE_MANIFEST_MAGIC);
+	writer.write(PIPELINE_MANIFEST_VERSION);
+
+	writer.write(to_u32(shaders.size()));
+
+	for (auto &shader : shaders)
+	{
+		writer.write(shader.stage);
+
+		writer.write_string(shader.entry_point);
+
+		writer.write_vector(shader.spirv);
+
+		writer.write(to_u32(shader.dynamic_resources.size()));
+
+		for (auto &resource_name : shader.dynamic_resources)
+		{
+			writer.write_string(resource_name);
+		}
+	}
+
+	writer.write(to_u32(render_passes.size()));
+
+	for (auto &render_pass : render_passes)
+	{
+		writer.write(to_u32(render_pass.attachments.size()));
+
+		for (auto &attachment : render_pass.attachments)
+		{
+			writer.write(attachment.format);
+			writer.write(attachment.samples);
+			writer.write(attachment.usage);
+		}
+
+		write_states(writer, render_pass.load_store_infos);
+
+		writer.write(to_u32(render_pass.subpasses.size()));
+
+		for (auto &subpass : render_pass.subpasses)
+		{
+			writer.write_vector(std::vector<uint32_t>{subpass.input_attachments.begin(), subpass.input_attachments.end()});
+			writer.write_vector(std::vector<uint32_t>{subpass.output_attachments.begin(), subpass.output_attachments.end()});
+		}
+	}
+
+	writer.write(to_u32(pipelines.size()));
+
+	for (auto &pipeline : pipelines)
+	{
+		writer.write_vector(pipeline.shaders);
+
+		writer.write(pipeline.render_pass);
+		writer.write(pipeline.subpass_index);
+
+		write_states(writer, pipeline.vertex_input_state.bindings);
+		write_states(writer, pipeline.vertex_input_state.attributes);
+
+		write_state(writer, pipeline.input_assembly_state);
+		write_state(writer, pipeline.rasterization_state);
+		write_state(writer, pipeline.viewport_state);
+		write_state(writer, pipeline.multisample_state);
+		write_state(writer, pipeline.depth_stencil_state);
+
+		writer.write(pipeline.color_blend_state.logic_op_enable);
+		writer.write(pipeline.color_blend_state.logic_op);
+		write_states(writer, pipeline.color_blend_state.attachments);
+
+		writer.write(to_u32(pipeline.specialization_infos.size()));
+
+		for (auto &stage_specialization : pipeline.specialization_infos)
+		{
+			auto &map_entries = stage_specialization.second.get_map_entries();
+			auto &data        = stage_specialization.second.get_data();
+
+			writer.write(stage_specialization.first);
+
+			writer.write(to_u32(map_entries.size()));
+
+			for (auto &map_entry : map_entries)
+			{
+				writer.write(map_entry.constantID);
+
+				writer.write(to_u32(map_entry.size));
+				writer.write(data.data() + map_entry.offset, map_entry.size);
+			}
+		}
+	}
+
+	return std::move(writer.get_data());
+}
+
+const std::vector<PipelineManifest::ShaderRecord> &PipelineManifest::get_shaders() const
+{
+	return shaders;
+}
+
+const std::vector<PipelineManifest::RenderPassRecord> &PipelineManifest::get_render_passes() const
+{
+	return render_passes;
+}
+
+const std::vector<PipelineManifest::PipelineRecord> &PipelineManifest::get_pipelines() const
+{
+	return pipelines;
+}
+}        // namespace vkb
@@ -0,0 +1,127 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include "graphics_pipeline_state.h"
+#include "render_target.h"
+
+namespace vkb
+{
+/**
+ * @brief List of the graphics pipelines built by an application, stored in a compact
+ *        binary format so that they can be built again before the first frame of the next run.
+ *        Pipelines are described by the SPIR-V of their shaders and the parameters
+ *        of their render pass, as Vulkan handles are not valid across runs.
+ */
+class PipelineManifest
+{
+  public:
+	struct ShaderRecord
+	{
+		VkShaderStageFlagBits stage;
+
+		std::string entry_point;
+
+		std::vector<uint32_t> spirv;
+
+		/// Names of the buffers bound with dynamic offsets
+		std::vector<std::string> dynamic_resources;
+	};
+
+	struct RenderPassRecord
+	{
+		std::vector<Attachment> attachments;
+
+		std::vector<LoadStoreInfo> load_store_infos;
+
+		std::vector<SubpassInfo> subpasses;
+	};
+
+	struct PipelineRecord
+	{
+		/// Indices of the shaders of the pipeline layout
+		std::vector<uint32_t> shaders;
+
+		/// Index of the render pass
+		uint32_t render_pass{0};
+
+		uint32_t subpass_index{0};
+
+		VertexInputState vertex_input_state;
+
+		InputAssemblyState input_assembly_state;
+
+		RasterizationState rasterization_state;
+
+		ViewportState viewport_state;
+
+		MultisampleState multisample_state;
+
+		DepthStencilState depth_stencil_state;
+
+		ColorBlendState color_blend_state;
+
+		ShaderStageMap<SpecializationInfo> specialization_infos;
+	};
+
+	PipelineManifest() = default;
+
+	/**
+	 * @brief Parses a manifest previously returned by serialize
+	 * @throws std::runtime_error if the data is not a valid manifest
+	 */
+	PipelineManifest(const std::vector<uint8_t> &data);
+
+	/**
+	 * @brief Records a pipeline, unless a pipeline with the same hash was already recorded
+	 * @param pipeline_hash Hash identifying the pipeline
+	 * @param graphics_state State the pipeline was built with
+	 * @param specialization_infos Specialization constants the pipeline was built with
+	 * @return True if the pipeline was added to the manifest
+	 */
+	bool add_pipeline(uint64_t pipeline_hash, const GraphicsPipelineState &graphics_state, const ShaderStageMap<SpecializationInfo> &specialization_infos);
+
+	std::vector<uint8_t> serialize() const;
+
+	const std::vector<ShaderRecord> &get_shaders() const;
+
+	const std::vector<RenderPassRecord> &get_render_passes() const;
+
+	const std::vector<PipelineRecord> &get_pipelines() const;
+
+  private:
+	std::vector<ShaderRecord> shaders;
+
+	std::vector<RenderPassRecord> render_passes;
+
+	std::vector<PipelineRecord> pipelines;
+
+	/// Index of the recorded shaders, by shader module id
+	std::unordered_map<uint64_t, uint32_t> shader_indices;
+
+	/// Index of the recorded render passes, by handle
+	std::unordered_map<VkRenderPass, uint32_t> render_pass_indices;
+
+	std::unordered_set<uint64_t> pipeline_hashes;
+};
+}        // namespace vkb
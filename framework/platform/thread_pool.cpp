@@ -57,6 +57,20 @@ void ThreadPool::wait()
 	                                });
 }
 
+void ThreadPool::wait_all(const std::vector<std::shared_future<void>> &tasks)
+{
+	// Tasks may reference the caller's stack, which must outlive all of them even if one fails
+	for (auto &task : tasks)
+	{
+		task.wait();
+	}
+
+	for (auto &task : tasks)
+	{
+		task.get();
+	}
+}
+
 void ThreadPool::start(uint32_t thread_count)
 {
 	// Mark queue as valid so worker threads can wait for tasks
@@ -24,6 +24,7 @@
 #include <future>
 #include <list>
 #include <thread>
+#include <vector>
 
 #include "concurrent_queue.h"
 
@@ -53,6 +54,9 @@ class ThreadPool
 	// Wait on all threads to complete
 	void wait();
 
+	// Wait on all tasks to complete, then rethrow the first error raised by one of them
+	static void wait_all(const std::vector<std::shared_future<void>> &tasks);
+
 	// Create worker threads for the pool
 	void start(uint32_t thread_count = std::thread::hardware_concurrency());
 
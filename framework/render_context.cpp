@@ -45,6 +45,8 @@ void RenderContext::prepare(RenderFrame::CreateFunc render_frame_create_func)
 		                                              device, image_handle,
 		                                              VkExtent3D{swapchain_extent.width, swapchain_extent.height, 1},
 		                                              swapchain_format}));
+
+		frames.back()->set_descriptor_management(descriptor_management);
 	}
 }
 
@@ -80,6 +82,23 @@ VkSemaphore RenderContext::begin_frame()
 
 	wait_frame();
 
+	// Frames are indexed by the acquired image, so the frames in flight are not always
+	// the latest ones: every frame before the oldest one in flight has completed
+	uint64_t completed_frame = frame_count;
+
+	for (auto &frame : frames)
+	{
+		if (frame->get_frame_number() != 0)
+		{
+			completed_frame = std::min(completed_frame, frame->get_frame_number() - 1);
+		}
+	}
+
+	get_active_frame().set_frame_number(++frame_count);
+
+	// Resources used by the frames still in flight must be kept alive
+	device.begin_frame(frame_count, completed_frame);
+
 	return aquired_semaphore;
 }
 
@@ -167,12 +186,57 @@ CommandBuffer &RenderContext::request_frame_command_buffer(const Queue &queue)
 	return frame.get_command_pool(queue).request_command_buffer();
 }
 
+void RenderContext::record_secondary_command_buffers(CommandBuffer &primary_command_buffer, const Queue &queue, uint32_t range_count, const RecordRangeFunc &record_range_func)
+{
+	RenderFrame &frame = get_active_frame();
+
+	// Command pools are created on this thread, each range using its own pool
+	std::vector<CommandBuffer *> secondary_command_buffers;
+
+	for (uint32_t range_index = 0; range_index < range_count; ++range_index)
+	{
+		auto &command_pool = frame.get_command_pool(queue, range_index + 1);
+
+		secondary_command_buffers.push_back(&command_pool.request_command_buffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+	}
+
+	std::vector<std::shared_future<void>> recordings;
+
+	for (uint32_t range_index = 0; range_index < range_count; ++range_index)
+	{
+		CommandBuffer *secondary_command_buffer = secondary_command_buffers[range_index];
+
+		recordings.push_back(thread_pool.dispatch([&primary_command_buffer, &record_range_func, secondary_command_buffer, range_index]() {
+			secondary_command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, &primary_command_buffer);
+
+			record_range_func(*secondary_command_buffer, range_index);
+
+			secondary_command_buffer->end();
+		}));
+	}
+
+	// Rethrows the errors of the recording, once no worker uses the ranges anymore
+	ThreadPool::wait_all(recordings);
+
+	primary_command_buffer.execute_commands(secondary_command_buffers, &thread_pool);
+}
+
 VkSemaphore RenderContext::request_semaphore()
 {
 	RenderFrame &frame = get_active_frame();
 	return frame.get_semaphore_pool().request_semaphore();
 }
 
+void RenderContext::set_descriptor_management(DescriptorManagement new_descriptor_management)
+{
+	descriptor_management = new_descriptor_management;
+
+	for (auto &frame : frames)
+	{
+		frame->set_descriptor_management(descriptor_management);
+	}
+}
+
 Device &RenderContext::get_device()
 {
 	return device;
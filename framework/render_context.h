@@ -34,6 +34,7 @@
 
 #include "cache_resource.h"
 #include "graphics_pipeline_state.h"
+#include "platform/thread_pool.h"
 #include "render_frame.h"
 #include "render_target.h"
 
@@ -84,8 +85,32 @@ class RenderContext : public NonCopyable
 	 */
 	CommandBuffer &request_frame_command_buffer(const Queue &queue);
 
+	/**
+	 * @brief Function recording a range of the commands of a subpass
+	 * @param command_buffer The secondary command buffer to record into
+	 * @param range_index The index of the range to record
+	 */
+	using RecordRangeFunc = std::function<void(CommandBuffer &command_buffer, uint32_t range_index)>;
+
+	/**
+	 * @brief Splits the current subpass of a primary command buffer in ranges recorded
+	 *        concurrently, each into a secondary command buffer with its own command pool.
+	 *        The secondary command buffers are executed by the primary command buffer,
+	 *        and the current subpass must not contain any other command.
+	 * @param primary_command_buffer A command buffer of the active frame, inside a render pass
+	 * @param queue The queue the primary command buffer will be submitted to
+	 * @param range_count Number of ranges to record
+	 * @param record_range_func Function recording a range, called from worker threads
+	 */
+	void record_secondary_command_buffers(CommandBuffer &primary_command_buffer, const Queue &queue, uint32_t range_count, const RecordRangeFunc &record_range_func);
+
 	VkSemaphore request_semaphore();
 
+	/**
+	 * @brief Sets the allocation strategy of the descriptor sets of all frames
+	 */
+	void set_descriptor_management(DescriptorManagement descriptor_management);
+
 	Device &get_device();
 
 	void update_swapchain(std::unique_ptr<Swapchain> &&new_swapchain);
@@ -110,10 +135,18 @@ class RenderContext : public NonCopyable
 	/// Whether a frame is active or not
 	bool frame_active{false};
 
+	/// Number of frames begun, used to track when cached resources were last used
+	uint64_t frame_count{0};
+
 	std::vector<std::unique_ptr<RenderFrame>> frames;
 
+	DescriptorManagement descriptor_management{DescriptorManagement::Cached};
+
 	/// Queue to submit commands for rendering our frames
 	const Queue &present_queue;
+
+	/// Threads recording and replaying secondary command buffers
+	ThreadPool thread_pool;
 };
 
 }        // namespace vkb
@@ -30,7 +30,8 @@ const RenderFrame::CreateFunc RenderFrame::DEFAULT_CREATE_FUNC =
 RenderFrame::RenderFrame(Device &device, core::Image &&swapchain_image) :
     device{device},
     fence_pool{device},
-    semaphore_pool{device}
+    semaphore_pool{device},
+    render_target_pool{device}
 {
 	update_render_target(std::move(swapchain_image));
 }
@@ -42,6 +43,7 @@ RenderFrame::~RenderFrame()
 
 void RenderFrame::update_render_target(core::Image &&swapchain_image)
 {
+	// The depth attachment is not stored, so it is backed by lazily allocated memory if the device has some
 	core::Image depth_image{device, swapchain_image.get_extent(),
 	                        VK_FORMAT_D32_SFLOAT,
 	                        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
@@ -60,24 +62,47 @@ void RenderFrame::reset()
 
 	fence_pool.reset();
 
+	frame_number = 0;
+
 	for (auto &command_pool : command_pools)
 	{
 		command_pool.second.reset();
 	}
 
 	semaphore_pool.reset();
+
+	for (auto &buffer_pool : buffer_pools)
+	{
+		buffer_pool.second.reset();
+	}
+
+	render_target_pool.reset();
+
+	for (auto &descriptor_pool : descriptor_pools)
+	{
+		descriptor_pool.second.reset();
+	}
 }
 
-CommandPool &RenderFrame::get_command_pool(const Queue &queue)
+CommandPool &RenderFrame::get_command_pool(const Queue &queue, size_t thread_index)
 {
-	auto command_pool_it = command_pools.find(queue.get_family_index());
+	auto command_pool_key = std::make_pair(queue.get_family_index(), thread_index);
+
+	auto command_pool_it = command_pools.find(command_pool_key);
 
 	if (command_pool_it != command_pools.end())
 	{
 		return command_pool_it->second;
 	}
 
-	auto res_ins_it = command_pools.emplace(queue.get_family_index(), CommandPool{device, queue.get_family_index()});
+	// Command buffers of the thread write their transient descriptor sets to its descriptor pool,
+	// which is created here so that worker threads never modify the pools of the frame
+	if (descriptor_pools.find(thread_index) == descriptor_pools.end())
+	{
+		descriptor_pools.emplace(thread_index, TransientDescriptorPool{device});
+	}
+
+	auto res_ins_it = command_pools.emplace(command_pool_key, CommandPool{device, queue.get_family_index(), this, thread_index});
 
 	if (!res_ins_it.second)
 	{
@@ -99,8 +124,66 @@ SemaphorePool &RenderFrame::get_semaphore_pool()
 	return semaphore_pool;
 }
 
+RenderTargetPool &RenderFrame::get_render_target_pool()
+{
+	return render_target_pool;
+}
+
+TransientDescriptorPool &RenderFrame::get_descriptor_pool(size_t thread_index)
+{
+	auto descriptor_pool_it = descriptor_pools.find(thread_index);
+
+	if (descriptor_pool_it == descriptor_pools.end())
+	{
+		throw std::runtime_error("No command pool was requested for this thread index");
+	}
+
+	return descriptor_pool_it->second;
+}
+
+void RenderFrame::set_descriptor_management(DescriptorManagement new_descriptor_management)
+{
+	descriptor_management = new_descriptor_management;
+}
+
+DescriptorManagement RenderFrame::get_descriptor_management() const
+{
+	return descriptor_management;
+}
+
+BufferAllocation RenderFrame::allocate_buffer(VkBufferUsageFlags usage, VkDeviceSize size, size_t thread_index)
+{
+	auto buffer_pool_key = std::make_pair(usage, thread_index);
+
+	auto buffer_pool_it = buffer_pools.find(buffer_pool_key);
+
+	if (buffer_pool_it == buffer_pools.end())
+	{
+		auto res_ins_it = buffer_pools.emplace(buffer_pool_key, BufferPool{device, BUFFER_POOL_BLOCK_SIZE * 1024, usage});
+
+		if (!res_ins_it.second)
+		{
+			throw std::runtime_error("Failed to insert buffer pool");
+		}
+
+		buffer_pool_it = res_ins_it.first;
+	}
+
+	return buffer_pool_it->second.allocate(size);
+}
+
 const RenderTarget &RenderFrame::get_render_target() const
 {
 	return *swapchain_render_target;
 }
+
+void RenderFrame::set_frame_number(uint64_t number)
+{
+	frame_number = number;
+}
+
+uint64_t RenderFrame::get_frame_number() const
+{
+	return frame_number;
+}
 }        // namespace vkb
@@ -20,6 +20,7 @@
 
 #pragma once
 
+#include "buffer_pool.h"
 #include "core/buffer.h"
 #include "core/command_pool.h"
 #include "core/device.h"
@@ -27,10 +28,29 @@
 #include "core/queue.h"
 #include "fence_pool.h"
 #include "render_target.h"
+#include "render_target_pool.h"
+#include "transient_descriptor_pool.h"
 #include "semaphore_pool.h"
 
 namespace vkb
 {
+/**
+ * @brief Block size of the buffer pools of a frame, in kilobytes
+ */
+const uint32_t BUFFER_POOL_BLOCK_SIZE = 256;
+
+/**
+ * @brief Allocation strategy of the descriptor sets of the command buffers of a frame
+ */
+enum class DescriptorManagement
+{
+	/// Sets are cached by the device, and reused by all frames as long as their resources are the same
+	Cached,
+
+	/// Sets are written for each frame, from descriptor pools of the frame which are reset all at once
+	Transient
+};
+
 class RenderFrame : public NonCopyable
 {
   public:
@@ -51,30 +71,85 @@ class RenderFrame : public NonCopyable
 		return device;
 	}
 
-	CommandPool &get_command_pool(const Queue &queue);
+	/**
+	 * @brief Returns a command pool of the frame for the queue family of the given queue.
+	 *        Command pools are externally synchronized, so each thread recording
+	 *        command buffers concurrently must use a pool with a different index.
+	 *        Must be called from the thread owning the frame.
+	 * @param queue Queue the command buffers will be submitted to
+	 * @param thread_index Index of the recording thread, the main thread using 0
+	 */
+	CommandPool &get_command_pool(const Queue &queue, size_t thread_index = 0);
 
 	FencePool &get_fence_pool();
 
 	SemaphorePool &get_semaphore_pool();
 
+	/**
+	 * @brief Returns the pool of the offscreen render targets of the frame, which are
+	 *        all released when the frame is reset, once the commands submitted for it completed.
+	 *        Must be called from the thread owning the frame.
+	 */
+	RenderTargetPool &get_render_target_pool();
+
+	/**
+	 * @brief Returns the descriptor pool of a recording thread, from which the transient
+	 *        descriptor sets are allocated. It is created with the command pools of the thread.
+	 * @param thread_index Index of the recording thread, the main thread using 0
+	 */
+	TransientDescriptorPool &get_descriptor_pool(size_t thread_index = 0);
+
+	void set_descriptor_management(DescriptorManagement new_descriptor_management);
+
+	DescriptorManagement get_descriptor_management() const;
+
+	/**
+	 * @brief Allocates transient buffer memory, which is persistently mapped and stays valid
+	 *        until the frame is reset, once the commands submitted for it completed.
+	 *        Buffer pools are not synchronized, so each recording thread must use a different index.
+	 * @param usage Usage of the buffer, each usage being allocated from its own pool
+	 * @param size Size of the allocation, in bytes
+	 * @param thread_index Index of the recording thread, the main thread using 0
+	 */
+	BufferAllocation allocate_buffer(VkBufferUsageFlags usage, VkDeviceSize size, size_t thread_index = 0);
+
 	void update_render_target(core::Image &&swapchain_image);
 
-	const RenderTarget &get_render_target() const;
+	/**
+	 * @brief Sets the number of the frame recorded with this render frame,
+	 *        which is cleared once its commands completed, when the render frame is reset
+	 */
+	void set_frame_number(uint64_t number);
 
-	std::unique_ptr<core::Buffer> gui_vertex_buffer;
+	/**
+	 * @return Number of the frame recorded with this render frame, or 0 if its commands completed
+	 */
+	uint64_t get_frame_number() const;
 
-	std::unique_ptr<core::Buffer> gui_index_buffer;
+	const RenderTarget &get_render_target() const;
 
   private:
 	Device &device;
 
-	/// Commands pools associated to the frames
-	std::map<uint32_t, CommandPool> command_pools;
+	/// Commands pools associated to the frames, by queue family index and thread index
+	std::map<std::pair<uint32_t, size_t>, CommandPool> command_pools;
 
 	FencePool fence_pool;
 
 	SemaphorePool semaphore_pool;
 
+	/// Buffer pools associated to the frame, by buffer usage and thread index
+	std::map<std::pair<VkBufferUsageFlags, size_t>, BufferPool> buffer_pools;
+
+	RenderTargetPool render_target_pool;
+
+	/// Descriptor pools of the transient descriptor sets, by thread index
+	std::map<size_t, TransientDescriptorPool> descriptor_pools;
+
+	DescriptorManagement descriptor_management{DescriptorManagement::Cached};
+
 	std::unique_ptr<RenderTarget> swapchain_render_target;
+
+	uint64_t frame_number{0};
 };
 }        // namespace vkb
@@ -0,0 +1,109 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "render_target_pool.h"
+
+#include "core/device.h"
+
+namespace vkb
+{
+namespace
+{
+bool is_matching(const RenderTarget &render_target, const VkExtent2D &extent, const std::vector<Attachment> &attachments)
+{
+	if (render_target.get_extent().width != extent.width ||
+	    render_target.get_extent().height != extent.height ||
+	    render_target.get_attachments().size() != attachments.size())
+	{
+		return false;
+	}
+
+	return std::equal(attachments.begin(), attachments.end(), render_target.get_attachments().begin(),
+	                  [](const Attachment &lhs, const Attachment &rhs) {
+		                  return lhs.format == rhs.format && lhs.samples == rhs.samples && lhs.usage == rhs.usage;
+	                  });
+}
+}        // namespace
+
+RenderTargetPool::RenderTargetPool(Device &device) :
+    device{device}
+{
+}
+
+RenderTarget &RenderTargetPool::request_render_target(const VkExtent2D &extent, const std::vector<Attachment> &attachments)
+{
+	for (auto &pooled_render_target : render_targets)
+	{
+		if (!pooled_render_target.in_use && is_matching(*pooled_render_target.render_target, extent, attachments))
+		{
+			pooled_render_target.in_use    = true;
+			pooled_render_target.requested = true;
+
+			return *pooled_render_target.render_target;
+		}
+	}
+
+	PooledRenderTarget pooled_render_target;
+	pooled_render_target.render_target = std::make_unique<RenderTarget>(device, extent, attachments);
+	pooled_render_target.in_use        = true;
+	pooled_render_target.requested     = true;
+
+	render_targets.push_back(std::move(pooled_render_target));
+
+	return *render_targets.back().render_target;
+}
+
+void RenderTargetPool::release_render_target(const RenderTarget &render_target)
+{
+	auto it = std::find_if(render_targets.begin(), render_targets.end(),
+	                       [&render_target](const PooledRenderTarget &pooled_render_target) {
+		                       return pooled_render_target.render_target.get() == &render_target;
+	                       });
+
+	if (it == render_targets.end())
+	{
+		throw std::runtime_error("Render target was not requested from this pool");
+	}
+
+	it->in_use = false;
+}
+
+void RenderTargetPool::reset()
+{
+	// Render targets left unused for a whole frame, for example after a resize, are destroyed
+	auto unused_it = std::remove_if(render_targets.begin(), render_targets.end(),
+	                                [](const PooledRenderTarget &pooled_render_target) {
+		                                return !pooled_render_target.requested;
+	                                });
+
+	if (unused_it != render_targets.end())
+	{
+		render_targets.erase(unused_it, render_targets.end());
+
+		// Framebuffers and descriptor sets are cached by view handle, which new views may reuse
+		device.evict_image_view_resources();
+	}
+
+	for (auto &pooled_render_target : render_targets)
+	{
+		pooled_render_target.in_use    = false;
+		pooled_render_target.requested = false;
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,82 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "common.h"
+
+#include "render_target.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Offscreen render targets of a frame, matched by extent and attachments.
+ *        A render target released during the frame is reused by the next request with the
+ *        same extent and attachments, so that render passes whose lifetimes do not overlap
+ *        share the same images. Render targets with other extents or formats do not alias
+ *        memory. The barriers derived from the tracked image layouts order the render passes
+ *        sharing them.
+ */
+class RenderTargetPool : public NonCopyable
+{
+  public:
+	RenderTargetPool(Device &device);
+
+	/// @brief Move construct
+	RenderTargetPool(RenderTargetPool &&other) = default;
+
+	/**
+	 * @brief Returns a render target released earlier in the frame, or creates one
+	 * @param extent Extent of the attachments
+	 * @param attachments Format, sample count and usage of each attachment, where attachments
+	 *        with the transient usage are backed by lazily allocated memory if the device has some
+	 * @return A render target which is not used by any other render pass until it is released
+	 */
+	RenderTarget &request_render_target(const VkExtent2D &extent, const std::vector<Attachment> &attachments);
+
+	/**
+	 * @brief Makes a render target available to the next requests, once the render passes using it are recorded
+	 */
+	void release_render_target(const RenderTarget &render_target);
+
+	/**
+	 * @brief Releases all the render targets, once the commands of the frame completed,
+	 *        and destroys the ones which were not requested since the previous reset
+	 */
+	void reset();
+
+  private:
+	struct PooledRenderTarget
+	{
+		std::unique_ptr<RenderTarget> render_target;
+
+		/// Requested and not released yet
+		bool in_use{false};
+
+		/// Requested since the previous reset
+		bool requested{false};
+	};
+
+	Device &device;
+
+	std::vector<PooledRenderTarget> render_targets;
+};
+}        // namespace vkb
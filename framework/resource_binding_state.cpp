@@ -46,16 +46,20 @@ void ResourceBindingState::clear_dirty(uint32_t set)
 
 void ResourceBindingState::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	set_bindings[set].bind_buffer(buffer, offset, range, binding, array_element);
+	auto &bindings = set_bindings[set];
 
-	dirty = true;
+	bindings.bind_buffer(buffer, offset, range, binding, array_element);
+
+	dirty |= bindings.is_dirty();
 }
 
 void ResourceBindingState::bind_image(const ImageView &image_view, VkSampler sampler, uint32_t set, uint32_t binding, uint32_t array_element)
 {
-	set_bindings[set].bind_image(image_view, sampler, binding, array_element);
+	auto &bindings = set_bindings[set];
 
-	dirty = true;
+	bindings.bind_image(image_view, sampler, binding, array_element);
+
+	dirty |= bindings.is_dirty();
 }
 
 const std::unordered_map<uint32_t, SetBindings> &ResourceBindingState::get_set_bindings()
@@ -68,7 +72,7 @@ VkDescriptorImageInfo ResourceInfo::get_image_info() const
 	VkDescriptorImageInfo image_info{};
 
 	image_info.sampler   = sampler;
-	image_info.imageView = image_view->get_handle();
+	image_info.imageView = image_view ? image_view->get_handle() : VK_NULL_HANDLE;
 
 	return image_info;
 }
@@ -125,24 +129,75 @@ bool ResourceInfo::is_image_sampler() const
 
 void ResourceInfo::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range)
 {
+	// Rebinding the same resource does not require a new descriptor set
+	if (this->buffer == &buffer && this->offset == offset && this->range == range)
+	{
+		return;
+	}
+
 	this->buffer = &buffer;
 
 	this->offset = offset;
 
 	this->range = range;
 
+	image_view = nullptr;
+
+	sampler = VK_NULL_HANDLE;
+
 	dirty = true;
 }
 
 void ResourceInfo::bind_image(const ImageView &image_view, VkSampler sampler)
 {
+	// Rebinding the same resource does not require a new descriptor set
+	if (this->buffer == nullptr && this->image_view == &image_view && this->sampler == sampler)
+	{
+		return;
+	}
+
 	this->image_view = &image_view;
 
 	this->sampler = sampler;
 
+	buffer = nullptr;
+
 	dirty = true;
 }
 
+uint64_t ResourceInfo::get_hash(uint32_t binding, uint32_t array_element) const
+{
+	if (!buffer && !image_view && sampler == VK_NULL_HANDLE)
+	{
+		return 0;
+	}
+
+	uint64_t result = hash_mix(hash_mix(0, binding), array_element);
+
+	if (buffer)
+	{
+		result = hash_handle(result, buffer->get_handle());
+		result = hash_mix(result, range);
+	}
+	else
+	{
+		result = hash_handle(result, image_view ? image_view->get_handle() : VK_NULL_HANDLE);
+		result = hash_handle(result, sampler);
+	}
+
+	return result;
+}
+
+uint64_t ResourceInfo::get_offset_hash(uint32_t binding, uint32_t array_element) const
+{
+	if (!buffer)
+	{
+		return 0;
+	}
+
+	return hash_mix(hash_mix(hash_mix(0, binding), array_element), offset);
+}
+
 VkDescriptorBufferInfo ResourceInfo::get_buffer_info() const
 {
 	VkDescriptorBufferInfo buffer_info{};
@@ -159,6 +214,9 @@ void SetBindings::reset()
 	clear_dirty();
 
 	resource_bindings.clear();
+
+	hash        = 0;
+	offset_hash = 0;
 }
 
 bool SetBindings::is_dirty() const
@@ -169,6 +227,14 @@ bool SetBindings::is_dirty() const
 void SetBindings::clear_dirty()
 {
 	dirty = false;
+
+	for (auto &binding_it : resource_bindings)
+	{
+		for (auto &element_it : binding_it.second)
+		{
+			element_it.second.clear_dirty();
+		}
+	}
 }
 
 void SetBindings::clear_dirty(uint32_t binding, uint32_t array_element)
@@ -178,16 +244,37 @@ void SetBindings::clear_dirty(uint32_t binding, uint32_t array_element)
 
 void SetBindings::bind_buffer(const core::Buffer &buffer, VkDeviceSize offset, VkDeviceSize range, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].bind_buffer(buffer, offset, range);
+	auto &resource_info = resource_bindings[binding][array_element];
 
-	dirty = true;
+	uint64_t previous_hash        = resource_info.get_hash(binding, array_element);
+	uint64_t previous_offset_hash = resource_info.get_offset_hash(binding, array_element);
+
+	resource_info.bind_buffer(buffer, offset, range);
+
+	update_hash(resource_info, binding, array_element, previous_hash, previous_offset_hash);
+
+	dirty |= resource_info.is_dirty();
 }
 
 void SetBindings::bind_image(const ImageView &image_view, VkSampler sampler, uint32_t binding, uint32_t array_element)
 {
-	resource_bindings[binding][array_element].bind_image(image_view, sampler);
+	auto &resource_info = resource_bindings[binding][array_element];
 
-	dirty = true;
+	uint64_t previous_hash        = resource_info.get_hash(binding, array_element);
+	uint64_t previous_offset_hash = resource_info.get_offset_hash(binding, array_element);
+
+	resource_info.bind_image(image_view, sampler);
+
+	update_hash(resource_info, binding, array_element, previous_hash, previous_offset_hash);
+
+	dirty |= resource_info.is_dirty();
+}
+
+void SetBindings::update_hash(const ResourceInfo &resource_info, uint32_t binding, uint32_t array_element, uint64_t previous_hash, uint64_t previous_offset_hash)
+{
+	hash ^= previous_hash ^ resource_info.get_hash(binding, array_element);
+
+	offset_hash ^= previous_offset_hash ^ resource_info.get_offset_hash(binding, array_element);
 }
 
 const BindingMap<ResourceInfo> &SetBindings::get_resource_bindings() const
@@ -195,4 +282,14 @@ const BindingMap<ResourceInfo> &SetBindings::get_resource_bindings() const
 	return resource_bindings;
 }
 
+uint64_t SetBindings::get_hash() const
+{
+	return hash;
+}
+
+uint64_t SetBindings::get_offset_hash() const
+{
+	return offset_hash;
+}
+
 }        // namespace vkb
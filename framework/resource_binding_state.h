@@ -54,6 +54,17 @@ class ResourceInfo
 
 	const ImageView &get_image_view() const;
 
+	/**
+	 * @return Hash of the descriptor at a binding and array element, without the offset of
+	 *         its buffer, or 0 if nothing is bound
+	 */
+	uint64_t get_hash(uint32_t binding, uint32_t array_element) const;
+
+	/**
+	 * @return Hash of the offset of the buffer at a binding and array element, or 0 if no buffer is bound
+	 */
+	uint64_t get_offset_hash(uint32_t binding, uint32_t array_element) const;
+
   private:
 	bool dirty{false};
 
@@ -85,10 +96,29 @@ class SetBindings
 
 	const BindingMap<ResourceInfo> &get_resource_bindings() const;
 
+	/**
+	 * @return Hash of the bound descriptors, updated as resources are bound. The hashes of the
+	 *         descriptors are combined with XOR, so that it does not depend on the binding order.
+	 */
+	uint64_t get_hash() const;
+
+	/**
+	 * @return Hash of the offsets of the bound buffers, kept apart from the other hash
+	 *         as the offsets of dynamic buffers are not written to the descriptor set
+	 */
+	uint64_t get_offset_hash() const;
+
   private:
 	bool dirty{false};
 
 	BindingMap<ResourceInfo> resource_bindings;
+
+	uint64_t hash{0};
+
+	uint64_t offset_hash{0};
+
+	/// Replaces the hashes of a descriptor by those of the resource now bound to it
+	void update_hash(const ResourceInfo &resource_info, uint32_t binding, uint32_t array_element, uint64_t previous_hash, uint64_t previous_offset_hash);
 };
 
 class ResourceBindingState
@@ -26,6 +26,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "buffer_pool.h"
 #include "common.h"
 #include "core/buffer.h"
 #include "scene_graph/component.h"
@@ -36,6 +37,21 @@ namespace sg
 {
 class Material;
 
+/**
+ * @brief Arrangement of the vertex attributes of a submesh in vertex buffers
+ */
+enum class VertexLayout
+{
+	/// Each attribute in its own stream
+	Separate,
+
+	/// All the attributes interleaved in a single stream
+	Interleaved,
+
+	/// Positions in their own stream, for depth only passes, and the other attributes interleaved in a second stream
+	SeparatePosition
+};
+
 struct VertexAttribute
 {
 	VkFormat format = VK_FORMAT_UNDEFINED;
@@ -64,9 +80,15 @@ class SubMesh : public Component
 
 	std::uint32_t vertex_indices = 0;
 
-	std::unordered_map<std::string, core::Buffer> vertex_buffers;
+	/// Vertex data of each attribute, allocated from the geometry buffers of the scene.
+	///	Attributes interleaved in the same stream share the same allocation
+	std::unordered_map<std::string, BufferAllocation> vertex_buffers;
+
+	/// Index data, allocated from the geometry buffers of the scene
+	BufferAllocation index_buffer;
 
-	std::unique_ptr<core::Buffer> index_buffer;
+	/// Geometry buffers shared by the submeshes of the scene, kept alive by each of them
+	std::shared_ptr<BufferPool> geometry_buffers;
 
 	std::shared_ptr<Material> material;
 };
@@ -0,0 +1,170 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "common.h"
+
+namespace vkb
+{
+/**
+ * @brief Appends plain values to serialized data, such as a file saved in the temporary directory
+ */
+class BinaryWriter
+{
+  public:
+	template <typename T>
+	void write(const T &value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Serialized values must be trivially copyable");
+
+		write(&value, sizeof(T));
+	}
+
+	template <typename T>
+	void write_vector(const std::vector<T> &values)
+	{
+		write(to_u32(values.size()));
+
+		for (auto &value : values)
+		{
+			write(value);
+		}
+	}
+
+	void write(const void *bytes, size_t size)
+	{
+		auto begin = reinterpret_cast<const uint8_t *>(bytes);
+
+		data.insert(data.end(), begin, begin + size);
+	}
+
+	void write_string(const std::string &value)
+	{
+		write(to_u32(value.size()));
+		write(value.data(), value.size());
+	}
+
+	void clear()
+	{
+		data.clear();
+	}
+
+	std::vector<uint8_t> &get_data()
+	{
+		return data;
+	}
+
+	const std::vector<uint8_t> &get_data() const
+	{
+		return data;
+	}
+
+  private:
+	std::vector<uint8_t> data;
+};
+
+/**
+ * @brief Reads plain values from serialized data, checking its bounds
+ */
+class BinaryReader
+{
+  public:
+	BinaryReader(const std::vector<uint8_t> &data) :
+	    data{data}
+	{}
+
+	template <typename T>
+	T read()
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Serialized values must be trivially copyable");
+
+		T value;
+
+		read(&value, sizeof(T));
+
+		return value;
+	}
+
+	template <typename T>
+	std::vector<T> read_vector()
+	{
+		uint32_t count = read_count(sizeof(T));
+
+		std::vector<T> values;
+		values.reserve(count);
+
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			values.push_back(read<T>());
+		}
+
+		return values;
+	}
+
+	/**
+	 * @brief Reads the size of an array, and checks that the data can hold it
+	 * @param element_size Minimum size in bytes of each element
+	 */
+	uint32_t read_count(size_t element_size)
+	{
+		uint32_t count = read<uint32_t>();
+
+		if (count * static_cast<uint64_t>(element_size) > data.size() - offset)
+		{
+			throw std::runtime_error("Serialized data is truncated");
+		}
+
+		return count;
+	}
+
+	std::string read_string()
+	{
+		std::string value;
+
+		value.resize(read_count(sizeof(char)));
+		read(&value[0], value.size());
+
+		return value;
+	}
+
+	void read(void *bytes, size_t size)
+	{
+		if (size > data.size() - offset)
+		{
+			throw std::runtime_error("Serialized data is truncated");
+		}
+
+		std::memcpy(bytes, data.data() + offset, size);
+
+		offset += size;
+	}
+
+	bool is_end() const
+	{
+		return offset == data.size();
+	}
+
+  private:
+	const std::vector<uint8_t> &data;
+
+	size_t offset{0};
+};
+}        // namespace vkb
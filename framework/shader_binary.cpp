@@ -0,0 +1,151 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "shader_binary.h"
+
+#include "glsl_compiler.h"
+#include "serialization.h"
+
+namespace vkb
+{
+namespace
+{
+const uint32_t SHADER_BINARY_MAGIC = 0x53424b56;        // "VKBS"
+
+/// Incremented whenever the reflection or the layout of the serialized shaders changes
+const uint32_t SHADER_BINARY_VERSION = 1;
+}        // namespace
+
+VkShaderStageFlagBits find_shader_stage(const std::string &ext)
+{
+	if (ext == "vert")
+	{
+		return VK_SHADER_STAGE_VERTEX_BIT;
+	}
+	else if (ext == "frag")
+	{
+		return VK_SHADER_STAGE_FRAGMENT_BIT;
+	}
+	else if (ext == "comp")
+	{
+		return VK_SHADER_STAGE_COMPUTE_BIT;
+	}
+	else if (ext == "geom")
+	{
+		return VK_SHADER_STAGE_GEOMETRY_BIT;
+	}
+	else if (ext == "tesc")
+	{
+		return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+	}
+	else if (ext == "tese")
+	{
+		return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+	}
+
+	throw std::runtime_error("File extension `" + ext + "` does not have a vulkan shader stage.");
+}
+
+uint64_t get_shader_key(VkShaderStageFlagBits stage, const std::vector<uint8_t> &glsl_source, const std::string &entry_point)
+{
+	uint64_t key = hash_bytes(glsl_source.data(), glsl_source.size(), GLSLCompiler::get_options_hash());
+	key          = hash_mix(key, stage);
+	key          = hash_bytes(entry_point.data(), entry_point.size(), key);
+
+	return key;
+}
+
+std::vector<uint8_t> serialize_shader(uint64_t key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources)
+{
+	BinaryWriter writer;
+
+	writer.write(SHADER_BINARY_MAGIC);
+	writer.write(SHADER_BINARY_VERSION);
+	writer.write(key);
+
+	writer.write_vector(spirv);
+
+	writer.write(to_u32(resources.size()));
+
+	for (auto &resource : resources)
+	{
+		writer.write(resource.stages);
+		writer.write(resource.type);
+		writer.write(resource.set);
+		writer.write(resource.binding);
+		writer.write(resource.location);
+		writer.write(resource.input_attachment_index);
+		writer.write(resource.vec_size);
+		writer.write(resource.columns);
+		writer.write(resource.array_size);
+		writer.write(resource.offset);
+		writer.write(resource.size);
+		writer.write_string(resource.name);
+	}
+
+	return std::move(writer.get_data());
+}
+
+uint64_t deserialize_shader(const std::vector<uint8_t> &data, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources)
+{
+	BinaryReader reader{data};
+
+	if (reader.read<uint32_t>() != SHADER_BINARY_MAGIC ||
+	    reader.read<uint32_t>() != SHADER_BINARY_VERSION)
+	{
+		throw std::runtime_error("Shader was serialized by another version");
+	}
+
+	uint64_t key = reader.read<uint64_t>();
+
+	spirv = reader.read_vector<uint32_t>();
+
+	uint32_t resource_count = reader.read_count(sizeof(uint32_t));
+
+	resources.clear();
+
+	for (uint32_t i = 0; i < resource_count; ++i)
+	{
+		ShaderResource resource{};
+
+		resource.stages                 = reader.read<VkShaderStageFlags>();
+		resource.type                   = reader.read<ShaderResourceType>();
+		resource.set                    = reader.read<uint32_t>();
+		resource.binding                = reader.read<uint32_t>();
+		resource.location               = reader.read<uint32_t>();
+		resource.input_attachment_index = reader.read<uint32_t>();
+		resource.vec_size               = reader.read<uint32_t>();
+		resource.columns                = reader.read<uint32_t>();
+		resource.array_size             = reader.read<uint32_t>();
+		resource.offset                 = reader.read<uint32_t>();
+		resource.size                   = reader.read<uint32_t>();
+		resource.name                   = reader.read_string();
+
+		resources.push_back(std::move(resource));
+	}
+
+	if (spirv.empty() || !reader.is_end())
+	{
+		throw std::runtime_error("Serialized shader has unexpected content");
+	}
+
+	return key;
+}
+}        // namespace vkb
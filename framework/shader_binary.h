@@ -0,0 +1,52 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include "core/shader_module.h"
+
+namespace vkb
+{
+/**
+ * @brief Finds the shader stage of a GLSL source from its file extension
+ */
+VkShaderStageFlagBits find_shader_stage(const std::string &ext);
+
+/**
+ * @brief Computes the key of a shader compiled from GLSL, which hashes everything its SPIR-V depends on
+ */
+uint64_t get_shader_key(VkShaderStageFlagBits stage, const std::vector<uint8_t> &glsl_source, const std::string &entry_point);
+
+/**
+ * @brief Serializes the SPIR-V and the reflected resources of a shader, which are not yet
+ *        bound with dynamic offsets. Used by the shader cache and the shaders precompiled at build time.
+ * @param key Key of the shader, see get_shader_key
+ */
+std::vector<uint8_t> serialize_shader(uint64_t key, const std::vector<uint32_t> &spirv, const std::vector<ShaderResource> &resources);
+
+/**
+ * @brief Reads a shader written by serialize_shader
+ * @return Key the shader was written with
+ * @throws std::runtime_error if the data is invalid or was written by another version
+ */
+uint64_t deserialize_shader(const std::vector<uint8_t> &data, std::vector<uint32_t> &spirv, std::vector<ShaderResource> &resources);
+}        // namespace vkb
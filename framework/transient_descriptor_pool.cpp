@@ -0,0 +1,227 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "transient_descriptor_pool.h"
+
+#include "core/descriptor_set_layout.h"
+#include "core/device.h"
+
+namespace vkb
+{
+namespace
+{
+uint32_t next_power_of_two(uint32_t value)
+{
+	uint32_t result = 1;
+
+	while (result < value)
+	{
+		result <<= 1;
+	}
+
+	return result;
+}
+
+/// Number of descriptors of a type in a set of the given layout
+uint32_t get_descriptor_count(const DescriptorSetLayout &descriptor_set_layout, VkDescriptorType descriptor_type)
+{
+	uint32_t count = 0;
+
+	for (auto &binding : descriptor_set_layout.get_bindings())
+	{
+		if (binding.descriptorType == descriptor_type)
+		{
+			count += binding.descriptorCount;
+		}
+	}
+
+	return count;
+}
+}        // namespace
+
+TransientDescriptorPool::TransientDescriptorPool(Device &device) :
+    device{device}
+{
+}
+
+TransientDescriptorPool::~TransientDescriptorPool()
+{
+	// Destroying the pools frees their sets
+	for (auto pool : pools)
+	{
+		vkDestroyDescriptorPool(device.get_handle(), pool, nullptr);
+	}
+}
+
+VkDescriptorSet TransientDescriptorPool::allocate(const DescriptorSetLayout &descriptor_set_layout)
+{
+	// Such sets need pools created for update after bind, and are written once rather than every frame
+	if (descriptor_set_layout.has_variable_descriptor_count())
+	{
+		throw std::runtime_error("Cannot allocate a transient descriptor set with a runtime sized array");
+	}
+
+	if (!has_capacity(descriptor_set_layout))
+	{
+		// Grow geometrically, so that the number of pools of a frame stays small
+		if (!pools.empty())
+		{
+			max_sets *= 2;
+
+			for (auto &it : max_descriptors)
+			{
+				it.second *= 2;
+			}
+		}
+
+		// Types seen for the first time are sized as if every set used them
+		for (auto &binding : descriptor_set_layout.get_bindings())
+		{
+			uint32_t required_count = get_descriptor_count(descriptor_set_layout, binding.descriptorType) * max_sets;
+
+			auto &max_count = max_descriptors[binding.descriptorType];
+
+			max_count = std::max(max_count, required_count);
+		}
+
+		create_pool();
+	}
+
+	--remaining_sets;
+	++set_demand;
+
+	for (auto &binding : descriptor_set_layout.get_bindings())
+	{
+		remaining_descriptors[binding.descriptorType] -= binding.descriptorCount;
+		descriptor_demand[binding.descriptorType] += binding.descriptorCount;
+	}
+
+	VkDescriptorSetLayout set_layout = descriptor_set_layout.get_handle();
+
+	VkDescriptorSetAllocateInfo allocate_info{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+
+	allocate_info.descriptorPool     = pools.back();
+	allocate_info.descriptorSetCount = 1;
+	allocate_info.pSetLayouts        = &set_layout;
+
+	VkDescriptorSet handle = VK_NULL_HANDLE;
+
+	VkResult result = vkAllocateDescriptorSets(device.get_handle(), &allocate_info, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot allocate transient descriptor set"};
+	}
+
+	return handle;
+}
+
+void TransientDescriptorPool::reset()
+{
+	if (pools.size() > 1)
+	{
+		for (auto pool : pools)
+		{
+			vkDestroyDescriptorPool(device.get_handle(), pool, nullptr);
+		}
+
+		pools.clear();
+
+		// The next frame allocates from a single pool, sized for the demand of this frame
+		max_sets = next_power_of_two(set_demand);
+
+		if (max_sets < INITIAL_MAX_SETS)
+		{
+			max_sets = INITIAL_MAX_SETS;
+		}
+
+		max_descriptors.clear();
+
+		for (auto &it : descriptor_demand)
+		{
+			max_descriptors[it.first] = next_power_of_two(it.second);
+		}
+
+		remaining_sets = 0;
+		remaining_descriptors.clear();
+	}
+	else if (!pools.empty())
+	{
+		VK_CHECK(vkResetDescriptorPool(device.get_handle(), pools.back(), 0));
+
+		remaining_sets        = max_sets;
+		remaining_descriptors = max_descriptors;
+	}
+
+	set_demand = 0;
+	descriptor_demand.clear();
+}
+
+bool TransientDescriptorPool::has_capacity(const DescriptorSetLayout &descriptor_set_layout) const
+{
+	if (pools.empty() || remaining_sets == 0)
+	{
+		return false;
+	}
+
+	for (auto &binding : descriptor_set_layout.get_bindings())
+	{
+		auto it = remaining_descriptors.find(binding.descriptorType);
+
+		if (it == remaining_descriptors.end() ||
+		    it->second < get_descriptor_count(descriptor_set_layout, binding.descriptorType))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void TransientDescriptorPool::create_pool()
+{
+	std::vector<VkDescriptorPoolSize> pool_sizes;
+
+	for (auto &it : max_descriptors)
+	{
+		pool_sizes.push_back({it.first, it.second});
+	}
+
+	// Sets are never freed individually, which lets the driver allocate them linearly
+	VkDescriptorPoolCreateInfo create_info{VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+
+	create_info.poolSizeCount = to_u32(pool_sizes.size());
+	create_info.pPoolSizes    = pool_sizes.data();
+	create_info.maxSets       = max_sets;
+
+	VkDescriptorPool handle = VK_NULL_HANDLE;
+
+	VkResult result = vkCreateDescriptorPool(device.get_handle(), &create_info, nullptr, &handle);
+
+	if (result != VK_SUCCESS)
+	{
+		throw VulkanException{result, "Cannot create transient descriptor pool"};
+	}
+
+	pools.push_back(handle);
+
+	remaining_sets        = max_sets;
+	remaining_descriptors = max_descriptors;
+}
+}        // namespace vkb
@@ -0,0 +1,85 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#pragma once
+
+#include "common.h"
+
+namespace vkb
+{
+class Device;
+class DescriptorSetLayout;
+
+/**
+ * @brief Allocates the descriptor sets written for a single frame, from descriptor pools
+ *        of any layout which are reset all at once instead of freeing each set.
+ *        Sets are bump allocated from the last pool, and a pool twice as large is created
+ *        when it is full. Once a frame needed several pools, they are replaced by a single
+ *        pool sized for the demand of that frame. Not synchronized, so each recording
+ *        thread must use its own pool.
+ */
+class TransientDescriptorPool : public NonCopyable
+{
+  public:
+	/// Number of sets of the first pool
+	static const uint32_t INITIAL_MAX_SETS = 64;
+
+	TransientDescriptorPool(Device &device);
+
+	~TransientDescriptorPool();
+
+	/// @brief Move construct
+	TransientDescriptorPool(TransientDescriptorPool &&other) = default;
+
+	/**
+	 * @return A descriptor set of the given layout, valid until the pool is reset
+	 */
+	VkDescriptorSet allocate(const DescriptorSetLayout &descriptor_set_layout);
+
+	/**
+	 * @brief Releases all the descriptor sets, once the commands using them completed
+	 */
+	void reset();
+
+  private:
+	Device &device;
+
+	std::vector<VkDescriptorPool> pools;
+
+	/// Capacity of the next pool created
+	uint32_t max_sets{INITIAL_MAX_SETS};
+
+	std::map<VkDescriptorType, uint32_t> max_descriptors;
+
+	/// Capacity left in the last pool
+	uint32_t remaining_sets{0};
+
+	std::map<VkDescriptorType, uint32_t> remaining_descriptors;
+
+	/// Sets and descriptors allocated since the last reset
+	uint32_t set_demand{0};
+
+	std::map<VkDescriptorType, uint32_t> descriptor_demand;
+
+	/// Checks whether the last pool has room for a set of the given layout
+	bool has_capacity(const DescriptorSetLayout &descriptor_set_layout) const;
+
+	void create_pool();
+};
+}        // namespace vkb
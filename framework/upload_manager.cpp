@@ -0,0 +1,431 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+#include "upload_manager.h"
+
+#include "core/device.h"
+#include "core/image_view.h"
+#include "core/queue.h"
+
+namespace vkb
+{
+namespace
+{
+const Queue &get_upload_queue(Device &device)
+{
+	// A transfer queue which is neither graphics nor compute runs on the copy engine of the device
+	if (auto queue = device.find_dedicated_queue(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0))
+	{
+		return *queue;
+	}
+
+	return device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0);
+}
+}        // namespace
+
+UploadManager::UploadManager(Device &device, VkDeviceSize staging_size) :
+    device{device},
+    queue{get_upload_queue(device)},
+    graphics_queue{device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0)},
+    staging_buffer{device, staging_size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY}
+{
+	ownership_transfer = queue.get_family_index() != graphics_queue.get_family_index();
+
+	staging_alignment = std::max<VkDeviceSize>(staging_alignment, device.get_properties().limits.optimalBufferCopyOffsetAlignment);
+
+	if (ownership_transfer)
+	{
+		LOGI("Uploading on dedicated transfer queue family %u", queue.get_family_index());
+	}
+}
+
+UploadManager::~UploadManager()
+{
+	wait(flush());
+
+	for (auto &batch : acquiring_batches)
+	{
+		vkWaitForFences(device.get_handle(), 1, &batch->fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+	}
+
+	process_completed_batches();
+
+	for (auto &batch : free_batches)
+	{
+		vkDestroyFence(device.get_handle(), batch->fence, nullptr);
+	}
+}
+
+UploadToken UploadManager::upload_image(const ImageView &image_view, const uint8_t *data, VkDeviceSize size, ImageUsage usage)
+{
+	const core::Buffer *buffer{nullptr};
+	VkDeviceSize        offset{0};
+
+	Batch &batch = stage(data, size, buffer, offset);
+
+	const core::Image &image = image_view.get_image();
+
+	VkImageSubresourceRange subresource_range = image_view.get_subresource_range();
+
+	VkBufferImageCopy copy_region{};
+	copy_region.bufferOffset                    = offset;
+	copy_region.imageSubresource.aspectMask     = subresource_range.aspectMask;
+	copy_region.imageSubresource.mipLevel       = subresource_range.baseMipLevel;
+	copy_region.imageSubresource.baseArrayLayer = subresource_range.baseArrayLayer;
+	copy_region.imageSubresource.layerCount     = subresource_range.layerCount;
+	copy_region.imageExtent                     = image.get_extent();
+
+	// Previous contents are discarded, and the transfer queue may not support the stages which last used the image
+	ImageMemoryBarrier memory_barrier{};
+	memory_barrier.old_layout      = VK_IMAGE_LAYOUT_UNDEFINED;
+	memory_barrier.new_layout      = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	memory_barrier.src_access_mask = 0;
+	memory_barrier.dst_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	batch.command_buffer->image_memory_barrier(image_view, memory_barrier);
+
+	batch.command_buffer->copy_buffer_to_image(*buffer, image, {copy_region});
+
+	if (!ownership_transfer)
+	{
+		batch.command_buffer->transition_image(image_view, usage);
+
+		return batch.token;
+	}
+
+	ImageAccess dst_access = get_image_access(usage, image.get_format());
+
+	// Release the image to the graphics queue family, which acquires it once the batch completed
+	memory_barrier.old_layout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	memory_barrier.new_layout       = dst_access.layout;
+	memory_barrier.src_stage_mask   = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	memory_barrier.src_access_mask  = VK_ACCESS_TRANSFER_WRITE_BIT;
+	memory_barrier.dst_access_mask  = 0;
+	memory_barrier.old_queue_family = queue.get_family_index();
+	memory_barrier.new_queue_family = graphics_queue.get_family_index();
+
+	batch.command_buffer->image_memory_barrier(image_view, memory_barrier);
+
+	batch.images.push_back({&image_view, dst_access});
+
+	return batch.token;
+}
+
+UploadToken UploadManager::upload_buffer(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, VkDeviceSize size,
+                                         VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask)
+{
+	const core::Buffer *src_buffer{nullptr};
+	VkDeviceSize        src_offset{0};
+
+	Batch &batch = stage(data, size, src_buffer, src_offset);
+
+	VkBufferCopy copy_region{};
+	copy_region.srcOffset = src_offset;
+	copy_region.dstOffset = offset;
+	copy_region.size      = size;
+
+	batch.command_buffer->copy_buffer(*src_buffer, buffer, {copy_region});
+
+	BufferMemoryBarrier memory_barrier{};
+	memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	memory_barrier.src_access_mask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+	if (!ownership_transfer)
+	{
+		memory_barrier.dst_stage_mask  = dst_stage_mask;
+		memory_barrier.dst_access_mask = dst_access_mask;
+
+		batch.command_buffer->buffer_memory_barrier(buffer, offset, size, memory_barrier);
+
+		return batch.token;
+	}
+
+	// Release the range to the graphics queue family, which acquires it once the batch completed
+	memory_barrier.dst_stage_mask   = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	memory_barrier.dst_access_mask  = 0;
+	memory_barrier.old_queue_family = queue.get_family_index();
+	memory_barrier.new_queue_family = graphics_queue.get_family_index();
+
+	batch.command_buffer->buffer_memory_barrier(buffer, offset, size, memory_barrier);
+
+	BufferMemoryBarrier acquire_barrier{};
+	acquire_barrier.src_stage_mask   = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	acquire_barrier.dst_stage_mask   = dst_stage_mask;
+	acquire_barrier.src_access_mask  = 0;
+	acquire_barrier.dst_access_mask  = dst_access_mask;
+	acquire_barrier.old_queue_family = queue.get_family_index();
+	acquire_barrier.new_queue_family = graphics_queue.get_family_index();
+
+	batch.buffers.push_back({&buffer, offset, size, acquire_barrier});
+
+	return batch.token;
+}
+
+UploadToken UploadManager::flush()
+{
+	if (recording_batch)
+	{
+		recording_batch->command_buffer->end();
+
+		VK_CHECK(queue.submit(*recording_batch->command_buffer, recording_batch->fence));
+
+		submitted_batches.push_back(std::move(recording_batch));
+	}
+
+	return next_token - 1;
+}
+
+bool UploadManager::is_complete(UploadToken token)
+{
+	if (recording_batch && token >= recording_batch->token)
+	{
+		flush();
+	}
+
+	process_completed_batches();
+
+	return token <= completed_token;
+}
+
+void UploadManager::wait(UploadToken token)
+{
+	if (recording_batch && token >= recording_batch->token)
+	{
+		flush();
+	}
+
+	while (token > completed_token && !submitted_batches.empty())
+	{
+		VK_CHECK(vkWaitForFences(device.get_handle(), 1, &submitted_batches.front()->fence, VK_TRUE, std::numeric_limits<uint64_t>::max()));
+
+		process_completed_batches();
+	}
+}
+
+void UploadManager::update()
+{
+	process_completed_batches();
+}
+
+const Queue &UploadManager::get_queue() const
+{
+	return queue;
+}
+
+UploadManager::Batch &UploadManager::get_recording_batch()
+{
+	if (recording_batch)
+	{
+		return *recording_batch;
+	}
+
+	if (!free_batches.empty())
+	{
+		recording_batch = std::move(free_batches.back());
+		free_batches.pop_back();
+	}
+	else
+	{
+		recording_batch = std::make_unique<Batch>();
+
+		recording_batch->command_pool = std::make_unique<CommandPool>(device, queue.get_family_index());
+
+		if (ownership_transfer)
+		{
+			recording_batch->acquire_command_pool = std::make_unique<CommandPool>(device, graphics_queue.get_family_index());
+		}
+
+		VkFenceCreateInfo create_info{VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+
+		VkResult result = vkCreateFence(device.get_handle(), &create_info, nullptr, &recording_batch->fence);
+
+		if (result != VK_SUCCESS)
+		{
+			throw VulkanException{result, "Cannot create upload fence"};
+		}
+	}
+
+	recording_batch->token = next_token++;
+
+	recording_batch->command_buffer = &recording_batch->command_pool->request_command_buffer();
+
+	recording_batch->command_buffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	return *recording_batch;
+}
+
+UploadManager::Batch &UploadManager::stage(const uint8_t *data, VkDeviceSize size, const core::Buffer *&buffer, VkDeviceSize &offset)
+{
+	const VkDeviceSize capacity = staging_buffer.get_size();
+
+	if (size > capacity)
+	{
+		Batch &batch = get_recording_batch();
+
+		batch.staging_buffers.emplace_back(device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
+		batch.staging_buffers.back().update(data, size);
+
+		buffer = &batch.staging_buffers.back();
+		offset = 0;
+
+		return batch;
+	}
+
+	while (true)
+	{
+		// Batches complete in submission order, so the used bytes always follow the head of the ring
+		if (staging_used == 0)
+		{
+			staging_head = 0;
+		}
+
+		VkDeviceSize aligned_head = (staging_head + staging_alignment - 1) / staging_alignment * staging_alignment;
+		VkDeviceSize consumed_size{0};
+
+		if (aligned_head + size > capacity)
+		{
+			// Skip the end of the ring, as staging ranges are contiguous
+			aligned_head  = 0;
+			consumed_size = capacity - staging_head + size;
+		}
+		else
+		{
+			consumed_size = aligned_head - staging_head + size;
+		}
+
+		if (staging_used + consumed_size <= capacity)
+		{
+			Batch &batch = get_recording_batch();
+
+			staging_buffer.update(data, size, aligned_head);
+
+			staging_head = aligned_head + size;
+			staging_used += consumed_size;
+			batch.staging_size += consumed_size;
+
+			buffer = &staging_buffer;
+			offset = aligned_head;
+
+			return batch;
+		}
+
+		// The ring is full, wait for the oldest batch to release its staging range
+		if (recording_batch && recording_batch->staging_size > 0)
+		{
+			flush();
+		}
+
+		assert(!submitted_batches.empty() && "Staging memory is used without any batch in flight");
+
+		wait(submitted_batches.front()->token);
+	}
+}
+
+void UploadManager::process_completed_batches()
+{
+	while (!acquiring_batches.empty() && vkGetFenceStatus(device.get_handle(), acquiring_batches.front()->fence) == VK_SUCCESS)
+	{
+		recycle(std::move(acquiring_batches.front()));
+		acquiring_batches.pop_front();
+	}
+
+	while (!submitted_batches.empty() && vkGetFenceStatus(device.get_handle(), submitted_batches.front()->fence) == VK_SUCCESS)
+	{
+		std::unique_ptr<Batch> batch = std::move(submitted_batches.front());
+		submitted_batches.pop_front();
+
+		staging_used -= batch->staging_size;
+
+		UploadToken token = batch->token;
+
+		if (!batch->images.empty() || !batch->buffers.empty())
+		{
+			acquire_ownership(*batch);
+
+			acquiring_batches.push_back(std::move(batch));
+		}
+		else
+		{
+			recycle(std::move(batch));
+		}
+
+		// The graphics queue can only use the destinations once their acquisitions are submitted to it
+		completed_token = token;
+	}
+}
+
+void UploadManager::acquire_ownership(Batch &batch)
+{
+	CommandBuffer &command_buffer = batch.acquire_command_pool->request_command_buffer();
+
+	command_buffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+
+	for (auto &image : batch.images)
+	{
+		ImageMemoryBarrier memory_barrier{};
+		memory_barrier.old_layout       = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+		memory_barrier.new_layout       = image.access.layout;
+		memory_barrier.src_stage_mask   = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		memory_barrier.dst_stage_mask   = image.access.stage_mask;
+		memory_barrier.src_access_mask  = 0;
+		memory_barrier.dst_access_mask  = image.access.access_mask;
+		memory_barrier.old_queue_family = queue.get_family_index();
+		memory_barrier.new_queue_family = graphics_queue.get_family_index();
+
+		command_buffer.image_memory_barrier(*image.image_view, memory_barrier);
+	}
+
+	for (auto &buffer : batch.buffers)
+	{
+		command_buffer.buffer_memory_barrier(*buffer.buffer, buffer.offset, buffer.size, buffer.memory_barrier);
+	}
+
+	command_buffer.end();
+
+	// The fence signaled by the copies is reused for the acquisitions
+	VK_CHECK(vkResetFences(device.get_handle(), 1, &batch.fence));
+
+	// The queue synchronizes this submission with the frames submitted by the render thread
+	VK_CHECK(graphics_queue.submit(command_buffer, batch.fence));
+}
+
+void UploadManager::recycle(std::unique_ptr<Batch> &&batch)
+{
+	VK_CHECK(vkResetFences(device.get_handle(), 1, &batch->fence));
+
+	VK_CHECK(batch->command_pool->reset());
+
+	if (batch->acquire_command_pool)
+	{
+		VK_CHECK(batch->acquire_command_pool->reset());
+	}
+
+	batch->command_buffer = nullptr;
+	batch->staging_size   = 0;
+
+	batch->staging_buffers.clear();
+	batch->images.clear();
+	batch->buffers.clear();
+
+	free_batches.push_back(std::move(batch));
+}
+}        // namespace vkb
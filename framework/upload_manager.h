@@ -0,0 +1,208 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "common.h"
+
+#include "core/buffer.h"
+#include "core/command_pool.h"
+
+#include <deque>
+
+namespace vkb
+{
+class Device;
+class ImageView;
+class Queue;
+
+/// Identifies the batch an upload was recorded in, batches being numbered from 1
+using UploadToken = uint64_t;
+
+/**
+ * @brief Streams data to device local buffers and images through a staging ring buffer.
+ *        Copies are batched into a command buffer submitted to a dedicated transfer queue
+ *        if the device has one, otherwise to the graphics queue. With a dedicated transfer
+ *        queue, the ownership of the destinations is released by the transfer queue family
+ *        and acquired by the graphics queue family once the batch completed.
+ *        Destinations must stay alive, and must not be used until their upload token completed.
+ *        Uploads are not synchronized, so they must be requested from the thread submitting frames.
+ */
+class UploadManager : public NonCopyable
+{
+  public:
+	/// Default size of the staging ring buffer, in megabytes
+	static const uint32_t DEFAULT_STAGING_SIZE = 32;
+
+	UploadManager(Device &device, VkDeviceSize staging_size = DEFAULT_STAGING_SIZE * 1024 * 1024);
+
+	~UploadManager();
+
+	/**
+	 * @brief Copies data to the first mip level of an image, discarding its previous contents
+	 * @param image_view View of the image, whose subresource range is copied
+	 * @param data Pointer to the texels, tightly packed
+	 * @param size Size of the data, in bytes
+	 * @param usage Usage of the image once the upload completed, defining its final layout
+	 * @return Token of the batch the upload is recorded in
+	 */
+	UploadToken upload_image(const ImageView &image_view, const uint8_t *data, VkDeviceSize size, ImageUsage usage = ImageUsage::FragmentShaderRead);
+
+	/**
+	 * @brief Copies data to a range of a buffer, which must not be in use by the device
+	 * @param buffer Buffer created with the transfer destination usage
+	 * @param offset Offset of the range in the buffer, in bytes
+	 * @param data Pointer to the data to copy
+	 * @param size Size of the data, in bytes
+	 * @param dst_stage_mask Stages reading the buffer once the upload completed
+	 * @param dst_access_mask Access of these stages to the buffer
+	 * @return Token of the batch the upload is recorded in
+	 */
+	UploadToken upload_buffer(const core::Buffer &buffer, VkDeviceSize offset, const uint8_t *data, VkDeviceSize size,
+	                          VkPipelineStageFlags dst_stage_mask, VkAccessFlags dst_access_mask);
+
+	/**
+	 * @brief Submits the batch being recorded, if any
+	 * @return Token of the last batch submitted
+	 */
+	UploadToken flush();
+
+	/**
+	 * @brief Checks without blocking whether the uploads of a batch completed,
+	 *        submitting the batch if it was still being recorded
+	 * @return True if the destinations of the batch can be used by the graphics queue
+	 */
+	bool is_complete(UploadToken token);
+
+	/**
+	 * @brief Blocks until the uploads of a batch completed
+	 */
+	void wait(UploadToken token);
+
+	/**
+	 * @brief Releases the staging memory and recycles the command buffers
+	 *        of the completed batches, called at the beginning of each frame
+	 */
+	void update();
+
+	/**
+	 * @return The queue the uploads are submitted to
+	 */
+	const Queue &get_queue() const;
+
+  private:
+	/// Access of the graphics queue to an image, acquired once its upload completed
+	struct ImageOwnership
+	{
+		const ImageView *image_view;
+
+		ImageAccess access;
+	};
+
+	/// Access of the graphics queue to a buffer range, acquired once its upload completed
+	struct BufferOwnership
+	{
+		const core::Buffer *buffer;
+
+		VkDeviceSize offset;
+
+		VkDeviceSize size;
+
+		BufferMemoryBarrier memory_barrier;
+	};
+
+	struct Batch
+	{
+		UploadToken token{0};
+
+		std::unique_ptr<CommandPool> command_pool;
+
+		/// Command pool of the graphics queue family, recording ownership acquisitions
+		std::unique_ptr<CommandPool> acquire_command_pool;
+
+		CommandBuffer *command_buffer{nullptr};
+
+		/// Signaled when the copies, then the ownership acquisitions if any, completed
+		VkFence fence{VK_NULL_HANDLE};
+
+		/// Bytes of the staging ring buffer used by the batch, including alignment padding
+		VkDeviceSize staging_size{0};
+
+		/// Staging buffers of the uploads larger than the ring buffer
+		std::vector<core::Buffer> staging_buffers;
+
+		std::vector<ImageOwnership> images;
+
+		std::vector<BufferOwnership> buffers;
+	};
+
+	Device &device;
+
+	const Queue &queue;
+
+	const Queue &graphics_queue;
+
+	/// Whether the uploads change of queue family before being used
+	bool ownership_transfer{false};
+
+	core::Buffer staging_buffer;
+
+	/// Alignment of the staging ranges, as required by copies to images
+	VkDeviceSize staging_alignment{16};
+
+	/// Position of the next staging range
+	VkDeviceSize staging_head{0};
+
+	/// Bytes of the ring buffer used by the batches not completed yet
+	VkDeviceSize staging_used{0};
+
+	UploadToken next_token{1};
+
+	UploadToken completed_token{0};
+
+	std::unique_ptr<Batch> recording_batch;
+
+	/// Batches submitted to the upload queue, in submission order
+	std::deque<std::unique_ptr<Batch>> submitted_batches;
+
+	/// Completed batches whose ownership acquisitions are executing on the graphics queue
+	std::deque<std::unique_ptr<Batch>> acquiring_batches;
+
+	std::vector<std::unique_ptr<Batch>> free_batches;
+
+	/// Returns the batch being recorded, beginning a new one if needed
+	Batch &get_recording_batch();
+
+	/**
+	 * @brief Writes data to the staging ring buffer, waiting for batches to complete if it is full,
+	 *        or to a dedicated staging buffer if the data does not fit in the ring buffer
+	 * @return The batch the data belongs to, with the buffer and offset the data is written at
+	 */
+	Batch &stage(const uint8_t *data, VkDeviceSize size, const core::Buffer *&buffer, VkDeviceSize &offset);
+
+	/// Processes the submitted batches which completed, in submission order
+	void process_completed_batches();
+
+	/// Records and submits the ownership acquisitions of a completed batch to the graphics queue
+	void acquire_ownership(Batch &batch);
+
+	void recycle(std::unique_ptr<Batch> &&batch);
+};
+}        // namespace vkb
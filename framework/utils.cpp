@@ -20,8 +20,11 @@
 
 #include "utils.h"
 
+#include "bindless_texture_table.h"
 #include "core/pipeline_layout.h"
 #include "core/shader_module.h"
+#include "precompiled_shaders.h"
+#include "shader_binary.h"
 
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/material.h"
@@ -38,35 +41,32 @@ namespace vkb
 {
 namespace
 {
-VkShaderStageFlagBits find_shader_stage(const std::string &ext)
+/// Offset of the texture index in the push constants of base_bindless.frag
+const uint32_t BINDLESS_TEXTURE_INDEX_OFFSET = sizeof(VertPushConstant) + sizeof(FragPushConstant);
+
+void draw_meshes(CommandBuffer &command_buffer, PipelineLayout &pipeline_layout, const sg::Scene &scene, const BindlessTextureTable *bindless_textures)
 {
-	if (ext == "vert")
-	{
-		return VK_SHADER_STAGE_VERTEX_BIT;
-	}
-	else if (ext == "frag")
-	{
-		return VK_SHADER_STAGE_FRAGMENT_BIT;
-	}
-	else if (ext == "comp")
-	{
-		return VK_SHADER_STAGE_COMPUTE_BIT;
-	}
-	else if (ext == "geom")
-	{
-		return VK_SHADER_STAGE_GEOMETRY_BIT;
-	}
-	else if (ext == "tesc")
-	{
-		return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
-	}
-	else if (ext == "tese")
+	auto meshes = scene.get_components<sg::Mesh>();
+
+	// draw all meshes in the scene
+	for (auto &mesh : meshes)
 	{
-		return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
-	}
+		// draw mesh for each node
+		for (auto &node : mesh->get_nodes())
+		{
+			auto transform = node->get_component<vkb::sg::Transform>();
+
+			// set world matrix of the node
+			command_buffer.push_constants(0, transform->get_world_matrix());
 
-	throw std::runtime_error("File extension `" + ext + "` does not have a vulkan shader stage.");
-};
+			// draw each submesh of the current mesh
+			for (auto &sub_mesh : mesh->get_submeshes())
+			{
+				draw_scene_submesh(command_buffer, pipeline_layout, *sub_mesh, bindless_textures);
+			}
+		}
+	}
+}
 }        // namespace
 
 ShaderModule create_shader_module(Device &device, const char *path)
@@ -77,88 +77,160 @@ ShaderModule create_shader_module(Device &device, const char *path)
 
 	auto shader_stage = find_shader_stage(file_ext);
 
+#ifdef VKB_PRECOMPILED_SHADERS
+	// Shaders compiled at build time skip both compilation and reflection
+	auto precompiled_shader = get_precompiled_shaders().find(path);
+
+	if (precompiled_shader != get_precompiled_shaders().end())
+	{
+		std::vector<uint32_t>       spirv;
+		std::vector<ShaderResource> resources;
+
+		deserialize_shader(precompiled_shader->second, spirv, resources);
+
+		return ShaderModule{device, shader_stage, spirv, resources, "main"};
+	}
+
+	LOGW("Shader %s was not precompiled, compiling it at runtime", path);
+#endif
+
 	auto buffer = read_binary_file(path);
 
 	return ShaderModule{device, shader_stage, buffer, "main"};
 }
 
-PipelineLayout &create_pipeline_layout(Device &    device,
-                                       const char *vertex_shader_file,
-                                       const char *fragment_shader_file)
+PipelineLayout &create_pipeline_layout(Device &                        device,
+                                       const char *                    vertex_shader_file,
+                                       const char *                    fragment_shader_file,
+                                       const std::vector<std::string> &dynamic_resources)
 {
 	std::vector<ShaderModule> shader_modules;
 	shader_modules.push_back(create_shader_module(device, vertex_shader_file));
 	shader_modules.push_back(create_shader_module(device, fragment_shader_file));
 
+	// A buffer may only be declared by some of the stages
+	for (auto &shader_module : shader_modules)
+	{
+		for (auto &resource_name : dynamic_resources)
+		{
+			auto &resources = shader_module.get_resources();
+
+			if (std::any_of(resources.begin(), resources.end(), [&resource_name](const ShaderResource &resource) { return resource.name == resource_name; }))
+			{
+				shader_module.set_resource_dynamic(resource_name);
+			}
+		}
+	}
+
 	return device.request_pipeline_layout(std::move(shader_modules));
 }
 
-void draw_scene_submesh(CommandBuffer &command_buffer, PipelineLayout &pipeline_layout, const sg::SubMesh &sub_mesh)
+void draw_scene_submesh(CommandBuffer &command_buffer, PipelineLayout &pipeline_layout, const sg::SubMesh &sub_mesh, const BindlessTextureTable *bindless_textures)
 {
 	auto &material = sub_mesh.material;
 
 	auto &base_color_texture = material->base_color_texture;
 
+	if (bindless_textures)
+	{
+		uint32_t base_color_index = 0;
+
+		if (base_color_texture)
+		{
+			bindless_textures->get_texture_index(*base_color_texture, base_color_index);
+		}
+
+		// Select the texture in the array bound for all the draws, the push being skipped if it did not change
+		command_buffer.push_constants(BINDLESS_TEXTURE_INDEX_OFFSET, base_color_index);
+	}
 	// Bind color texture of material
-	if (base_color_texture && base_color_texture->get_image() && base_color_texture->get_sampler())
+	else if (base_color_texture && base_color_texture->get_image() && base_color_texture->get_sampler())
 	{
 		command_buffer.bind_image(*base_color_texture->get_image()->image_view,
 		                          base_color_texture->get_sampler()->vk_sampler, 0, 0, 0);
 	}
 
-	auto vertex_input_resources = pipeline_layout.get_vertex_input_attributes();
+	auto &vertex_input_resources = pipeline_layout.get_vertex_input_attributes();
+
+	// Reuse the storage of the previous draws, so that drawing does not allocate
+	thread_local VertexInputState vertex_input_state;
+
+	vertex_input_state.attributes.clear();
+	vertex_input_state.bindings.clear();
 
-	VertexInputState vertex_input_state;
+	// Minimum number of vertex input bindings supported by Vulkan implementations
+	const uint32_t max_vertex_bindings = 16;
+
+	// Vertex buffers of the bindings, which are bound in a single call
+	std::array<const core::Buffer *, max_vertex_bindings> vertex_buffers{};
+	std::array<VkDeviceSize, max_vertex_bindings>         vertex_buffer_offsets{};
+
+	uint32_t binding_count{0};
 
 	for (auto &input_resource : vertex_input_resources)
 	{
 		auto attribute_it = sub_mesh.vertex_attributes.find(input_resource.name);
+		auto buffer_it    = sub_mesh.vertex_buffers.find(input_resource.name);
 
-		if (attribute_it == sub_mesh.vertex_attributes.end())
+		if (attribute_it == sub_mesh.vertex_attributes.end() || buffer_it == sub_mesh.vertex_buffers.end())
 		{
 			continue;
 		}
 
+		const core::Buffer *buffer = &buffer_it->second.get_buffer();
+		VkDeviceSize        offset = buffer_it->second.get_offset();
+
+		// Attributes interleaved in the same stream share its binding
+		uint32_t binding = 0;
+
+		while (binding < binding_count && (vertex_buffers[binding] != buffer || vertex_buffer_offsets[binding] != offset))
+		{
+			binding++;
+		}
+
+		if (binding == binding_count)
+		{
+			assert(binding_count < max_vertex_bindings && "Too many vertex streams");
+
+			vertex_buffers[binding]        = buffer;
+			vertex_buffer_offsets[binding] = offset;
+
+			VkVertexInputBindingDescription vertex_binding{};
+			vertex_binding.binding = binding;
+			vertex_binding.stride  = attribute_it->second.stride;
+
+			vertex_input_state.bindings.push_back(vertex_binding);
+
+			binding_count++;
+		}
+
 		VkVertexInputAttributeDescription vertex_attribute{};
-		vertex_attribute.binding  = input_resource.location;
+		vertex_attribute.binding  = binding;
 		vertex_attribute.format   = attribute_it->second.format;
 		vertex_attribute.location = input_resource.location;
 		vertex_attribute.offset   = attribute_it->second.offset;
 
 		vertex_input_state.attributes.push_back(vertex_attribute);
-
-		VkVertexInputBindingDescription vertex_binding{};
-		vertex_binding.binding = input_resource.location;
-		vertex_binding.stride  = attribute_it->second.stride;
-
-		vertex_input_state.bindings.push_back(vertex_binding);
 	}
 
 	command_buffer.set_vertex_input_state(vertex_input_state);
 
-	// Find submesh vertex buffers matching the shader input attribute names
-	for (auto &input_resource : vertex_input_resources)
+	if (binding_count > 0)
 	{
-		const auto &buffer_iter = sub_mesh.vertex_buffers.find(input_resource.name);
-
-		if (buffer_iter != sub_mesh.vertex_buffers.end())
-		{
-			std::vector<std::reference_wrapper<const core::Buffer>> buffers;
-			buffers.emplace_back(std::ref(buffer_iter->second));
-
-			// Bind vertex buffers only for the attribute locations defined
-			command_buffer.bind_vertex_buffers(input_resource.location, std::move(buffers), {0});
-		}
+		command_buffer.bind_vertex_buffers(0, binding_count, vertex_buffers.data(), vertex_buffer_offsets.data());
 	}
 
 	// Draw submesh indexed if indices exists
 	if (sub_mesh.vertex_indices != 0)
 	{
-		// Bind index buffer of submesh
-		command_buffer.bind_index_buffer(*sub_mesh.index_buffer, sub_mesh.index_offset, sub_mesh.index_type);
+		// Bind the whole geometry buffer, so that it stays bound across submeshes of the same type of index
+		command_buffer.bind_index_buffer(sub_mesh.index_buffer.get_buffer(), 0, sub_mesh.index_type);
+
+		VkDeviceSize index_size  = sub_mesh.index_type == VK_INDEX_TYPE_UINT32 ? sizeof(uint32_t) : sizeof(uint16_t);
+		uint32_t     first_index = to_u32((sub_mesh.index_buffer.get_offset() + sub_mesh.index_offset) / index_size);
 
 		// Draw submesh using indexed data
-		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, 0, 0, 0);
+		command_buffer.draw_indexed(sub_mesh.vertex_indices, 1, first_index, 0, 0);
 	}
 	else
 	{
@@ -169,26 +241,14 @@ void draw_scene_submesh(CommandBuffer &command_buffer, PipelineLayout &pipeline_
 
 void draw_scene_meshes(CommandBuffer &command_buffer, PipelineLayout &pipeline_layout, const sg::Scene &scene)
 {
-	auto meshes = scene.get_components<sg::Mesh>();
-
-	// draw all meshes in the scene
-	for (auto &mesh : meshes)
-	{
-		// draw mesh for each node
-		for (auto &node : mesh->get_nodes())
-		{
-			auto transform = node->get_component<vkb::sg::Transform>();
+	draw_meshes(command_buffer, pipeline_layout, scene, nullptr);
+}
 
-			// set world matrix of the node
-			command_buffer.push_constants(0, transform->get_world_matrix());
+void draw_scene_meshes(CommandBuffer &command_buffer, PipelineLayout &pipeline_layout, const sg::Scene &scene, const BindlessTextureTable &bindless_textures, uint32_t set)
+{
+	command_buffer.bind_descriptor_set(set, bindless_textures.get_descriptor_set());
 
-			// draw each submesh of the current mesh
-			for (auto &sub_mesh : mesh->get_submeshes())
-			{
-				draw_scene_submesh(command_buffer, pipeline_layout, *sub_mesh);
-			}
-		}
-	}
+	draw_meshes(command_buffer, pipeline_layout, scene, &bindless_textures);
 }
 
 glm::mat4 vulkan_style_projection(const glm::mat4 &proj)
@@ -29,6 +29,8 @@
 
 namespace vkb
 {
+class BindlessTextureTable;
+
 /**
  * @brief Push constant structure for base.vert shader
  */
@@ -65,12 +67,15 @@ ShaderModule create_shader_module(Device &device, const char *path);
  * @param device A Vulkan device and an asset manager already set up
  * @param vertex_shader_file The path for the vertex shader (relative to the assets directory)
  * @param fragment_shader_file The path for the fragment shader (relative to the assets directory)
+ * @param dynamic_resources Names of the uniform or storage buffers bound with dynamic offsets,
+ *        such as per-draw uniforms suballocated from a frame buffer pool
  * 
  * @return A pipeline layout object
  */
-PipelineLayout &create_pipeline_layout(Device &    device,
-                                       const char *vertex_shader_file,
-                                       const char *fragment_shader_file);
+PipelineLayout &create_pipeline_layout(Device &                        device,
+                                       const char *                    vertex_shader_file,
+                                       const char *                    fragment_shader_file,
+                                       const std::vector<std::string> &dynamic_resources = {});
 
 /**
  * @brief Draw a given submesh
@@ -78,8 +83,10 @@ PipelineLayout &create_pipeline_layout(Device &    device,
  * @param command_buffer The Vulkan command buffer
  * @param pipeline_layout The Vulkan pipeline layout
  * @param sub_mesh The submesh to render
+ * @param bindless_textures If not null, the base color texture is selected by its index in the table,
+ *        pushed after the constants of base.frag as in base_bindless.frag, instead of being bound
  */
-void draw_scene_submesh(CommandBuffer &command_buffer, PipelineLayout &pipeline_layout, const sg::SubMesh &sub_mesh);
+void draw_scene_submesh(CommandBuffer &command_buffer, PipelineLayout &pipeline_layout, const sg::SubMesh &sub_mesh, const BindlessTextureTable *bindless_textures = nullptr);
 
 /**
  * @brief Draw each mesh from the scene
@@ -90,6 +97,18 @@ void draw_scene_submesh(CommandBuffer &command_buffer, PipelineLayout &pipeline_
  */
 void draw_scene_meshes(CommandBuffer &command_buffer, PipelineLayout &pipeline_layout, const sg::Scene &scene);
 
+/**
+ * @brief Draw each mesh from the scene, binding the textures of a bindless texture table
+ *        once for all the meshes, so that switching materials does not bind any texture
+ *
+ * @param command_buffer The Vulkan command buffer
+ * @param pipeline_layout The Vulkan pipeline layout, for example of base.vert and base_bindless.frag
+ * @param scene The scene to render
+ * @param bindless_textures The table holding the textures of the scene
+ * @param set The set index of the texture array
+ */
+void draw_scene_meshes(CommandBuffer &command_buffer, PipelineLayout &pipeline_layout, const sg::Scene &scene, const BindlessTextureTable &bindless_textures, uint32_t set = 0);
+
 /**
  * @brief Calculates the vulkan style projection matrix
  * 
@@ -132,6 +132,7 @@ bool VulkanSample::prepare(Platform &platform)
 #if defined(VK_USE_PLATFORM_ANDROID_KHR)
 	auto &android_platform  = dynamic_cast<AndroidPlatform &>(platform);
 	tinygltf::asset_manager = android_platform.get_activity()->assetManager;
+	set_temp_directory(android_platform.get_activity()->internalDataPath);
 #endif
 
 	LOGI("Initializing context");
@@ -211,40 +212,13 @@ void VulkanSample::update(float delta_time)
 
 	cmd_buf.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
 
-	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-		memory_barrier.src_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-		memory_barrier.dst_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-
-		cmd_buf.image_memory_barrier(render_target.get_views().at(0), memory_barrier);
-	}
-
-	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
-		memory_barrier.src_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-		memory_barrier.dst_access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
-
-		cmd_buf.image_memory_barrier(render_target.get_views().at(1), memory_barrier);
-	}
+	// The attachments are cleared, so their previous contents are discarded
+	cmd_buf.transition_image(render_target.get_views().at(0), ImageUsage::ColorAttachment, true);
+	cmd_buf.transition_image(render_target.get_views().at(1), ImageUsage::DepthStencilAttachment, true);
 
 	draw_swapchain_renderpass(cmd_buf, render_target);
 
-	{
-		ImageMemoryBarrier memory_barrier{};
-		memory_barrier.old_layout      = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-		memory_barrier.new_layout      = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
-		memory_barrier.src_access_mask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
-		memory_barrier.src_stage_mask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-		memory_barrier.dst_stage_mask  = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
-
-		cmd_buf.image_memory_barrier(render_target.get_views().at(0), memory_barrier);
-	}
+	cmd_buf.transition_image(render_target.get_views().at(0), ImageUsage::Present);
 
 	cmd_buf.end();
 
@@ -348,9 +322,9 @@ std::shared_ptr<sg::Node> VulkanSample::add_free_camera(const std::string &node_
 	return camera_node;
 }
 
-void VulkanSample::load_scene(const std::string &path)
+void VulkanSample::load_scene(const std::string &path, sg::VertexLayout vertex_layout)
 {
-	vkb::GLTFLoader loader{*device};
+	vkb::GLTFLoader loader{*device, vertex_layout};
 
 	bool status = loader.read_scene_from_file(path, scene);
 
@@ -397,6 +371,15 @@ VkInstance VulkanSample::create_instance(const std::vector<const char *> &requir
 		throw std::runtime_error("Required instance extensions are missing.");
 	}
 
+	// Needed by the device to query and enable extended features, such as descriptor indexing
+	auto is_properties2 = [](const char *extension) { return strcmp(extension, VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) == 0; };
+
+	if (validate_extensions({VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME}, instance_extensions) &&
+	    std::none_of(active_instance_extensions.begin(), active_instance_extensions.end(), is_properties2))
+	{
+		active_instance_extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+	}
+
 	uint32_t instance_layer_count;
 	VK_CHECK(vkEnumerateInstanceLayerProperties(&instance_layer_count, nullptr));
 
@@ -490,12 +473,12 @@ void VulkanSample::draw_swapchain_renderpass(vkb::CommandBuffer &command_buffer,
 	viewport.minDepth = 0.0f;
 	viewport.maxDepth = 1.0f;
 
-	command_buffer.set_viewport(0, {viewport});
+	command_buffer.set_viewport(0, 1, &viewport);
 
 	VkRect2D scissor{};
 	scissor.extent = extent;
 
-	command_buffer.set_scissor(0, {scissor});
+	command_buffer.set_scissor(0, 1, &scissor);
 
 	draw_scene(command_buffer);
 
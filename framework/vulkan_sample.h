@@ -23,6 +23,7 @@
 #include "gui.h"
 #include "platform/application.h"
 #include "render_context.h"
+#include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/scene.h"
 #include "stats.h"
 
@@ -58,8 +59,9 @@ class VulkanSample : public Application
 	 * @brief Loads the scene
 	 * 
 	 * @param path The path of the gltf file
+	 * @param vertex_layout Arrangement of the vertex attributes in vertex buffers
 	 */
-	void load_scene(const std::string &path);
+	void load_scene(const std::string &path, sg::VertexLayout vertex_layout = sg::VertexLayout::Separate);
 
 	RenderContext &get_render_context()
 	{
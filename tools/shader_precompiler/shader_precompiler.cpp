@@ -0,0 +1,157 @@
+/* Copyright (c) 2019, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: MIT
+ *
+ * Permission is hereby granted, free of charge,
+ * to any person obtaining a copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software,
+ * and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <iomanip>
+
+#include "common.h"
+#include "glsl_compiler.h"
+#include "shader_binary.h"
+#include "spirv_reflection.h"
+
+/*
+ * Compiles GLSL shaders to SPIR-V and reflects their resources, then generates
+ * the definition of vkb::get_precompiled_shaders which embeds them.
+ *
+ * Usage: shader_precompiler <output.cpp> <assets directory> <shader path>...
+ * where each shader path is relative to the assets directory.
+ */
+
+namespace
+{
+std::vector<uint8_t> read_shader_file(const std::string &path)
+{
+	std::ifstream file{path, std::ios::in | std::ios::binary};
+
+	if (!file.is_open())
+	{
+		throw std::runtime_error("Failed to open file: " + path);
+	}
+
+	return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+}
+
+/**
+ * @brief Compiles and reflects a shader
+ * @return Data written by vkb::serialize_shader
+ */
+std::vector<uint8_t> precompile_shader(const std::string &assets_directory, const std::string &path)
+{
+	std::string file_ext = path.substr(path.find_last_of(".") + 1);
+
+	VkShaderStageFlagBits stage = vkb::find_shader_stage(file_ext);
+
+	std::vector<uint8_t> glsl_source = read_shader_file(assets_directory + "/" + path);
+
+	std::vector<uint32_t> spirv;
+	std::string           info_log;
+
+	vkb::GLSLCompiler glsl_compiler;
+
+	if (!glsl_compiler.compile_to_spirv(stage, glsl_source, "main", spirv, info_log))
+	{
+		throw std::runtime_error("Failed to compile shader " + path + ": " + info_log);
+	}
+
+	std::vector<vkb::ShaderResource> resources;
+
+	vkb::SPIRVReflection spirv_reflection;
+
+	if (!spirv_reflection.reflect_shader_resources(stage, spirv, resources))
+	{
+		throw std::runtime_error("Failed to reflect shader " + path);
+	}
+
+	return vkb::serialize_shader(vkb::get_shader_key(stage, glsl_source, "main"), spirv, resources);
+}
+
+void write_shader_data(std::ostream &output, const std::vector<uint8_t> &data)
+{
+	output << std::hex << std::setfill('0');
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		output << (i % 16 == 0 ? "\n\t            " : " ") << "0x" << std::setw(2) << static_cast<uint32_t>(data[i]) << ",";
+	}
+
+	output << std::dec;
+}
+}        // namespace
+
+int main(int argc, char *argv[])
+{
+	if (argc < 3)
+	{
+		LOGE("Usage: shader_precompiler <output.cpp> <assets directory> <shader path>...");
+		return EXIT_FAILURE;
+	}
+
+	std::string output_path      = argv[1];
+	std::string assets_directory = argv[2];
+
+	std::stringstream output;
+
+	output << "// Generated by shader_precompiler, do not edit\n\n"
+	       << "#include \"precompiled_shaders.h\"\n\n"
+	       << "namespace vkb\n{\n"
+	       << "const std::unordered_map<std::string, std::vector<uint8_t>> &get_precompiled_shaders()\n{\n"
+	       << "\tstatic const std::unordered_map<std::string, std::vector<uint8_t>> shaders{";
+
+	try
+	{
+		for (int i = 3; i < argc; ++i)
+		{
+			std::string path = argv[i];
+
+			output << "\n\t    {\"" << path << "\",\n\t        {";
+			write_shader_data(output, precompile_shader(assets_directory, path));
+			output << "\n\t        }},";
+		}
+	}
+	catch (const std::exception &e)
+	{
+		LOGE("%s", e.what());
+		return EXIT_FAILURE;
+	}
+
+	output << "\n\t};\n\n"
+	       << "\treturn shaders;\n"
+	       << "}\n"
+	       << "}        // namespace vkb\n";
+
+	// Only replace the output if it changed, so that the framework is not rebuilt needlessly
+	std::ifstream previous_file{output_path, std::ios::in | std::ios::binary};
+
+	std::string previous_output{std::istreambuf_iterator<char>{previous_file}, std::istreambuf_iterator<char>{}};
+
+	if (previous_output != output.str())
+	{
+		std::ofstream output_file{output_path, std::ios::out | std::ios::binary | std::ios::trunc};
+
+		output_file << output.str();
+
+		if (!output_file)
+		{
+			LOGE("Failed to write file: %s", output_path.c_str());
+			return EXIT_FAILURE;
+		}
+	}
+
+	return EXIT_SUCCESS;
+}